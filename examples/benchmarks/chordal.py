@@ -0,0 +1,50 @@
+# Solution times of sdp with and without chordal conversion
+# (options['chordal']), for SDPs with a band sparsity pattern.
+#
+#     python chordal.py [n [w [m]]]
+#
+# The problems have m variables and one block of order n, and the
+# matrices in the constraint have bandwidth w.  The defaults are n = 300,
+# w = 3 and m = 10.  For each problem the table gives the iterations,
+# the solution time, the objective and the orders of the blocks of the
+# converted problem.
+
+import sys, time
+from cvxopt import matrix, spmatrix, normal, setseed, blas, solvers
+
+def band(n, w):
+    I, J, V = [], [], []
+    B = normal(n, w+1)
+    for j in range(n):
+        for i in range(j, min(n, j+w+1)):
+            I.append(i)
+            J.append(j)
+            V.append(B[j, i-j])
+    M = matrix(spmatrix(V, I, J, (n, n)))
+    return M + M.T
+
+def main(args):
+    n, w, m = 300, 3, 10
+    if len(args) > 0: n = int(args[0])
+    if len(args) > 1: w = int(args[1])
+    if len(args) > 2: m = int(args[2])
+    setseed(1)
+    F = [ band(n, w) for k in range(m) ]
+    G = matrix([ [ Fk[:] ] for Fk in F ])
+    h = matrix(0.0, (n, n))
+    h[::n+1] = 10.0
+    Z = band(n, w)
+    Z[::n+1] = 2.0 * n
+    c = matrix([ -blas.dot(Fk[:], Z[:]) for Fk in F ])
+    print("%-8s %8s %8s %14s  %s" %("chordal", "iters", "time (s)",
+        "objective", "blocks"))
+    for conv in [False, True]:
+        t0 = time.time()
+        sol = solvers.sdp(c, Gs = [G], hs = [h], options = {'show_progress':
+            False, 'chordal': conv})
+        blocks = sol.get('chordal', [None])[0] or [n]
+        print("%-8s %8d %8.2f %14.6e  %d blocks, max order %d" %(conv,
+            sol['iterations'], time.time() - t0, sol['primal objective'],
+            len(blocks), max(blocks)))
+
+main(sys.argv[1:])
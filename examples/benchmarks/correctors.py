@@ -0,0 +1,58 @@
+# Number of factorizations and solution times of lp and qp for different
+# values of options['centrality_correctors'].
+#
+# The problems are random dense LPs and QPs with many more inequalities
+# than variables, so that most of the time is spent forming and
+# factoring the KKT matrix.  The KKT solver is wrapped to count the
+# number of factorizations.  The times are the best of three runs.
+
+import sys, time
+from cvxopt import matrix, normal, uniform, setseed, solvers, misc
+
+solvers.options['show_progress'] = False
+m, n = 2000, 500
+if len(sys.argv) > 1: m, n = int(sys.argv[1]), int(sys.argv[2])
+
+def counted(factor, P = None):
+    count = [0]
+    def kktsolver(W):
+        count[0] += 1
+        if P is None: return factor(W)
+        else: return factor(W, P)
+    return kktsolver, count
+
+def run(name, solve, reps = 3):
+    print(name)
+    for k in [0, 1, 2, 3, 4]:
+        times = []
+        for r in range(reps):
+            t0 = time.time()
+            sol, count = solve(k)
+            times.append(time.time() - t0)
+        print("%4d %12s %10d %10d %10.3f %16.8e" %(k, sol['status'],
+            sol['iterations'], count[0], min(times),
+            sol['primal objective']))
+
+setseed(1)
+G = normal(m, n)
+h = G*uniform(n,1) + uniform(m,1)
+c = -G.T*uniform(m,1)
+A = matrix(0.0, (0,n))
+dims = {'l': m, 'q': [], 's': []}
+P = normal(n, n)
+P = P*P.T / n
+
+def lp(k):
+    kktsolver, count = counted(misc.kkt_chol(G, dims, A))
+    return solvers.lp(c, G, h, kktsolver = kktsolver, options =
+        dict(solvers.options, centrality_correctors = k)), count
+
+def qp(k):
+    kktsolver, count = counted(misc.kkt_chol(G, dims, A), P)
+    return solvers.qp(P, c, G, h, kktsolver = kktsolver, options =
+        dict(solvers.options, centrality_correctors = k)), count
+
+print("%4s %12s %10s %10s %10s %16s" %("corr", "status", "iters",
+    "factors", "time", "objective"))
+run("lp, m = %d, n = %d" %(m, n), lp)
+run("qp, m = %d, n = %d" %(m, n), qp)
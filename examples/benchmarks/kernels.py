@@ -0,0 +1,96 @@
+# Time per call of the cone kernels in cvxopt.misc (scale, scale2, sprod,
+# sinv, trisc, max_step, compute_scaling and update_scaling) for a vector
+# with many 's' blocks.  The rows 'work' are for calls with a workspace
+# created by misc.workspace().
+#
+#     python kernels.py [nblocks [minsize [maxsize]]] [--threads 1,2,4]
+#
+# The default is 2000 's' blocks with orders between 10 and 40.  The
+# block loops of the kernels run in parallel if misc_solvers is
+# compiled with OpenMP.  With --threads, the benchmark is repeated in a
+# subprocess for each number of threads (via OMP_NUM_THREADS).  The
+# column 'small' gives the times for the same number of blocks of
+# order 3, which are processed serially by inline loops.
+
+import sys, os, time, subprocess
+from cvxopt import matrix, normal, uniform, setseed, lapack, misc
+
+def point(dims, factor = False):
+    # A random vector in the interior of the cone.
+    x = [ uniform(dims['l'], 1, 0.5, 2.0) ]
+    for m in dims['s']:
+        A = normal(m, m)
+        X = A * A.T
+        X[::m+1] += m
+        if factor:
+            lapack.potrf(X)
+            for j in range(m): X[:j, j] = 0.0
+        x.append(X[:])
+    return matrix(x)
+
+def timeit(f, reps):
+    t0 = time.time()
+    for k in range(reps): f()
+    return (time.time() - t0) / reps
+
+def kernels(dims):
+    setseed(1)
+    s, z = point(dims), point(dims)
+    n = dims['l'] + sum(dims['s'])
+    lmbda = matrix(0.0, (n, 1))
+    W = misc.compute_scaling(s, z, lmbda, dims)
+    x = point(dims)
+    x3 = matrix([x, x, x], (len(x), 3))
+    # With equal factors of s and z, update_scaling() multiplies r and
+    # rti by orthogonal matrices, so W does not change much with
+    # repeated calls.
+    L = point(dims, True)
+    work = misc.workspace(dims)
+    def update():
+        misc.update_scaling(W, lmbda, matrix(L), matrix(L))
+    return [
+        ("scale", lambda: misc.scale(x, W)),
+        ("scale T I", lambda: misc.scale(x, W, trans = 'T', inverse =
+            'I')),
+        ("scale 3 cols", lambda: misc.scale(x3, W)),
+        ("scale work", lambda: misc.scale(x, W, work = work)),
+        ("scale2", lambda: misc.scale2(lmbda, x, dims)),
+        ("sprod", lambda: misc.sprod(x, s, dims)),
+        ("sprod diag", lambda: misc.sprod(x, lmbda, dims, diag = 'D')),
+        ("sinv", lambda: misc.sinv(x, lmbda, dims)),
+        ("trisc", lambda: misc.trisc(x, dims)),
+        ("max_step", lambda: misc.max_step(x, dims)),
+        ("max_step work", lambda: misc.max_step(x, dims, work = work)),
+        ("compute_scaling", lambda: misc.compute_scaling(s, z, lmbda, dims,
+            W = W)),
+        ("update_scaling", update) ]
+
+def main(args):
+    threads = None
+    if '--threads' in args:
+        i = args.index('--threads')
+        threads = args[i+1]
+        args = args[:i] + args[i+2:]
+    if threads:
+        for t in threads.split(','):
+            print("OMP_NUM_THREADS = %s" %t)
+            sys.stdout.flush()
+            subprocess.call([sys.executable, __file__] + args, env =
+                dict(os.environ, OMP_NUM_THREADS = t))
+        return
+    nblocks, minsize, maxsize = 2000, 10, 40
+    if len(args) > 0: nblocks = int(args[0])
+    if len(args) > 1: minsize = int(args[1])
+    if len(args) > 2: maxsize = int(args[2])
+    sizes = [ minsize + (k * 7919) % (maxsize - minsize + 1) for k in
+        range(nblocks) ]
+    dims = {'l': 10, 'q': [], 's': sizes}
+    small = {'l': 10, 'q': [], 's': nblocks * [3]}
+    print("%-16s %12s %12s" %("kernel", "time (ms)", "small (ms)"))
+    for (name, f), (name2, g) in zip(kernels(dims), kernels(small)):
+        t = timeit(f, 3)
+        reps = max(1, min(100, int(0.2 / max(t, 1e-6))))
+        print("%-16s %12.3f %12.3f" %(name, 1e3 * timeit(f, reps), 1e3 *
+            timeit(g, 10)))
+
+main(sys.argv[1:])
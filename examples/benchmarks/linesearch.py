@@ -0,0 +1,45 @@
+# Solution times of cpl with the trial steps of the line search 
+# evaluated one at a time and in batches, for an expensive F.
+#
+#     python linesearch.py [n [delay]]
+#
+# The problem is
+#
+#     minimize    c'*x
+#     subject to  -sum(log(x)) <= 1
+#
+# with n variables (default 100).  Each call to F waits delay seconds
+# (default 0.005) without holding the global interpreter lock, as a 
+# function in a compiled extension would, so the trial steps can be
+# evaluated in parallel by options['linesearch_threads'] threads.
+
+import sys, time
+from cvxopt import matrix, spdiag, log, uniform, setseed, solvers
+
+def main(args):
+    n, delay = 100, 0.005
+    if len(args) > 0: n = int(args[0])
+    if len(args) > 1: delay = float(args[1])
+    setseed(1)
+    c = uniform(n, 1)
+    calls = [0]
+    def F(x = None, z = None):
+        if x is None: return 1, matrix(1.0, (n, 1))
+        calls[0] += 1
+        time.sleep(delay)
+        if min(x) <= 0.0: return None
+        f = matrix(-sum(log(x)) - 1.0)
+        Df = -(x**-1).T
+        if z is None: return f, Df
+        return f, Df, spdiag(z[0] * x**-2)
+    print("%6s %8s %8s %8s %14s" %("batch", "threads", "calls", "time (s)",
+        "objective"))
+    for batch, threads in [(1, 1), (2, 2), (4, 4), (8, 8)]:
+        calls[0] = 0
+        t0 = time.time()
+        sol = solvers.cpl(c, F, options = {'show_progress': False,
+            'linesearch_batch': batch, 'linesearch_threads': threads})
+        print("%6d %8d %8d %8.2f %14.6e" %(batch, threads, calls[0],
+            time.time() - t0, sol['primal objective']))
+
+main(sys.argv[1:])
@@ -0,0 +1,36 @@
+# Solution times of sdp with rank-one constraint matrices given in
+# factored form and as dense columns of Gs.
+#
+#     python lowrank.py [k [m]]
+#
+# The problem is
+#
+#     maximize    sum(x)
+#     subject to  sum_i x_i * a_i * a_i' <= I
+#
+# with m random vectors a_i of length k.  The defaults are k = 200 and
+# m = 400.  With Gs = [[a_0, ..., a_{m-1}]] the products with Gs and the
+# Schur complement are computed from the vectors a_i (misc.LowRank).
+
+import sys, time
+from cvxopt import matrix, normal, setseed, solvers
+
+def main(args):
+    k, m = 200, 400
+    if len(args) > 0: k = int(args[0])
+    if len(args) > 1: m = int(args[1])
+    setseed(1)
+    a = [ normal(k, 1) for i in range(m) ]
+    c = matrix(-1.0, (m, 1))
+    h = matrix(0.0, (k, k))
+    h[::k+1] = 1.0
+    print("%-10s %8s %8s %14s" %("Gs", "iters", "time (s)", "objective"))
+    for name, Gs in [("factored", [a]), ("dense", [ matrix([ [ (ai *
+        ai.T)[:] ] for ai in a ]) ])]:
+        t0 = time.time()
+        sol = solvers.sdp(c, Gs = Gs, hs = [h], options = {'show_progress':
+            False})
+        print("%-10s %8d %8.2f %14.6e" %(name, sol['iterations'],
+            time.time() - t0, sol['primal objective']))
+
+main(sys.argv[1:])
@@ -0,0 +1,76 @@
+# Step length computations with dense eigenvalue decompositions and with
+# the Lanczos method (options['lanczos']), for SDPs with large blocks.
+#
+#     python maxstep.py [n [m [nblocks]]]
+#
+# First the time per call of misc.max_step() for a slowly changing
+# sequence of symmetric matrices of order n, for which the starting
+# vectors of the Lanczos method are the eigenvectors of the previous
+# call.  Then the iterations and solution times (the best of reps runs)
+# of sdp() with and without options['lanczos'] = n for a random feasible
+# SDP with m variables and nblocks blocks of order n.  The defaults are
+# n = 400, m = 20 and nblocks = 1.  Only the step length of the affine
+# direction uses the Lanczos method, so the differences in the solution
+# times are much smaller than in the time per call of max_step().
+
+import sys, time
+from cvxopt import matrix, normal, setseed, blas, solvers, misc
+
+def symmetric(n):
+    A = normal(n, n)
+    return (A + A.T) / (2.0 * n)**0.5
+
+def max_step(n, reps = 10):
+    dims = {'l': 0, 'q': [], 's': [n]}
+    X = symmetric(n)
+    v = matrix(0.0, (n, 1))
+    times = [0.0, 0.0]
+    for k in range(reps):
+        t0 = time.time()
+        ref = misc.max_step(X, dims)
+        t1 = time.time()
+        t = misc.max_step(X, dims, lanczos = n, v = v)
+        t2 = time.time()
+        times[0] += t1 - t0
+        times[1] += t2 - t1
+        if abs(t - ref) > 1e-6 * max(1.0, abs(ref)):
+            print("max_step: error %.2e" %abs(t - ref))
+        X += 0.01 * symmetric(n)
+    return [ 1e3 * tk / reps for tk in times ]
+
+def sdp(n, m, nblocks, reps = 3):
+    Gs, hs = [], []
+    x0 = normal(m, 1)
+    c = matrix(0.0, (m, 1))
+    for k in range(nblocks):
+        F = [ symmetric(n) for i in range(m) ]
+        S, Z = normal(n, n), normal(n, n)
+        Gs.append(matrix([ [ Fi[:] ] for Fi in F ]))
+        hs.append(S * S.T / n - sum([ Fi * xi for Fi, xi in zip(F, x0) ],
+            matrix(0.0, (n, n))))
+        Z = Z * Z.T / n
+        c -= matrix([ blas.dot(Fi[:], Z[:]) for Fi in F ])
+    print("%-10s %8s %8s %12s" %("lanczos", "iters", "time (s)",
+        "objective"))
+    for lanczos in [0, n]:
+        times = []
+        for k in range(reps):
+            t0 = time.time()
+            sol = solvers.sdp(c, Gs = Gs, hs = hs, options =
+                {'show_progress': False, 'lanczos': lanczos})
+            times.append(time.time() - t0)
+        print("%-10d %8d %8.2f %12.6e" %(lanczos, sol['iterations'],
+            min(times), sol['primal objective']))
+
+def main(args):
+    n, m, nblocks = 400, 20, 1
+    if len(args) > 0: n = int(args[0])
+    if len(args) > 1: m = int(args[1])
+    if len(args) > 2: nblocks = int(args[2])
+    setseed(1)
+    dense, lanczos = max_step(n)
+    print("max_step, order %d: dense %.3f ms, Lanczos %.3f ms" %(n, dense,
+        lanczos))
+    sdp(n, m, nblocks)
+
+main(sys.argv[1:])
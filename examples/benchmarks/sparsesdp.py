@@ -0,0 +1,50 @@
+# Solution times of sdp for an SDP with very sparse constraint matrices,
+# with G stored as a sparse and as a dense matrix.
+#
+#     python sparsesdp.py [n [m [nnz]]]
+#
+# The problem has m variables and one block of order n, and each
+# constraint matrix has nnz random nonzeros in its lower triangular
+# part.  The defaults are n = 300, m = 200 and nnz = 5.  With a sparse G
+# the default KKT solver ('chol') computes the Schur complement from the
+# nonzeros of G (misc.schur()); with a dense G the rows of W^{-T} * G
+# are formed explicitly.  The table gives the KKT solver, the
+# iterations, the solution time and the objective.
+
+import sys, time, random
+from cvxopt import matrix, spmatrix, solvers
+
+def main(args):
+    n, m, nnz = 300, 200, 5
+    if len(args) > 0: n = int(args[0])
+    if len(args) > 1: m = int(args[1])
+    if len(args) > 2: nnz = int(args[2])
+    random.seed(0)
+    I, J, V = [], [], []
+    for j in range(m):
+        for k in range(nnz):
+            a, b = random.randrange(n), random.randrange(n)
+            I.append(max(a, b) + min(a, b) * n)
+            J.append(j)
+            V.append(random.gauss(0.0, 1.0))
+    G = spmatrix(V, I, J, (n*n, m))
+
+    # h = I and c = -G' * I, so that the problem is strictly primal and
+    # dual feasible.
+    h = matrix(0.0, (n, n))
+    h[::n+1] = 1.0
+    c = matrix(0.0, (m, 1))
+    for v, i, j in zip(G.V, G.I, G.J):
+        c[j] -= v * h[i]
+
+    print("%-10s %-8s %8s %8s %14s" %("G", "kkt", "iters", "time (s)",
+        "objective"))
+    for Gk, kkt in [(G, None), (matrix(G), 'chol'), (matrix(G), None)]:
+        t0 = time.time()
+        sol = solvers.sdp(c, Gs = [Gk], hs = [h], kktsolver = kkt,
+            options = {'show_progress': False})
+        print("%-10s %-8s %8d %8.2f %14.6e" %(type(Gk).__name__, kkt or
+            'default', sol['iterations'], time.time() - t0,
+            sol['primal objective']))
+
+main(sys.argv[1:])
@@ -0,0 +1,528 @@
+# Benchmark suite for lp, qp and sdp.
+#
+#     python suite.py [-o results.json] [-k kktsolvers] [--dense] [files]
+#     python suite.py --generate directory
+#     python suite.py --compare old.json new.json [--tolerance 0.25]
+#
+# The first form solves the LPs in the MPS files (*.mps, read with
+# op.fromfile), the QPs in the QPS files (*.qps or *.sif: MPS files with
+# a QUADOBJ or QMATRIX section, as in the Maros-Meszaros test set) and
+# the SDPs in the sparse SDPA files (*.dat-s, as in SDPLIB) given on the
+# command line, with each of the KKT solvers in the comma-separated list
+# kktsolvers, and writes the status, number of iterations, solution time
+# and peak memory of each run, and a checksum of the instance file, to a
+# JSON file.  Directories are searched
+# for files with these extensions.  Without file arguments, the suite
+# solves a set of randomly generated instances (the same instances in
+# every run), together with the LP in tests/boeing2.mps.  The test sets themselves are not included in the
+# CVXOPT distribution.
+#
+# Each run is executed in a separate process and the memory is the peak
+# resident set size of that process (in kilobytes on Linux, in bytes on
+# macOS).  With the --inline option the runs are executed in the
+# calling process, and the memory is the peak for the process so far.
+#
+# The second form writes the generated instances to a directory.
+#
+# The third form compares two results files, for example from two
+# builds of CVXOPT, and lists the runs for which the status is no longer
+# 'optimal', the number of iterations has increased, or the solution
+# time or the memory has increased by more than a fraction tolerance.
+# The exit status is 1 if regressions are found, and 2 if the two files
+# contain different instances with the same name (different checksums),
+# in which case the results are not compared.
+
+import sys, os, re, json, time, tempfile, subprocess, argparse, hashlib
+import cvxopt
+from cvxopt import matrix, spmatrix, sparse, normal, uniform, setseed
+from cvxopt import solvers
+from cvxopt.modeling import op, variable, dot
+
+try:
+    import resource
+except ImportError:
+    resource = None
+
+KKTSOLVERS = {
+    'lp': ['chol2', 'chol', 'ldl', 'ldl2', 'qr', 'native'],
+    'qp': ['chol2', 'chol', 'ldl', 'ldl2', 'native'],
+    'sdp': ['chol', 'ldl', 'ldl2', 'qr'] }
+
+EXTENSIONS = {'.mps': 'lp', '.qps': 'qp', '.sif': 'qp', '.dat-s': 'sdp'}
+
+
+def instance_type(filename):
+    for ext, kind in EXTENSIONS.items():
+        if filename.lower().endswith(ext): return kind
+    return None
+
+
+def checksum(filename):
+    """
+    Returns the SHA-256 checksum of the instance file.
+    """
+
+    with open(filename, 'rb') as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+
+def matrixform(lp):
+    """
+    Returns (c, G, h, A, b, x, vmap) for an LP read with op.fromfile.
+    """
+
+    t = lp._inmatrixform('sparse')
+    if t is None: lp1, vmap = lp, None
+    else: lp1, vmap = t[0], t[1]
+    x = lp1.variables()[0]
+    n = len(x)
+    c = matrix(lp1.objective._linear._coeff[x], tc = 'd')[:]
+    if lp1._inequalities:
+        G = sparse(lp1._inequalities[0]._f._linear._coeff[x])
+        h = matrix(-lp1._inequalities[0]._f._constant)
+    else:
+        G, h = spmatrix([], [], [], (0,n)), matrix(0.0, (0,1))
+    if lp1._equalities:
+        A = sparse(lp1._equalities[0]._f._linear._coeff[x])
+        b = matrix(-lp1._equalities[0]._f._constant)
+    else:
+        A, b = spmatrix([], [], [], (0,n)), matrix(0.0, (0,1))
+    return c, G, h, A, b, x, vmap
+
+
+def read_mps(filename):
+    """
+    Reads an LP from a fixed format MPS file.
+    """
+
+    lp = op()
+    lp.fromfile(filename)
+    c, G, h, A, b = matrixform(lp)[:5]
+    return {'c': c, 'G': G, 'h': h, 'A': A, 'b': b}
+
+
+def read_qps(filename):
+    """
+    Reads a QP from a fixed format QPS file.  The quadratic term is
+    given in a QUADOBJ section (lower triangle) or a QMATRIX section
+    (both triangles), which is placed before ENDATA.
+    """
+
+    lines, quad, section = [], [], None
+    for s in open(filename):
+        if s[:1] not in (' ', '*', '\n', '\r', '\t', ''):
+            section = s.split()[0] if s.strip() else None
+            if section in ('QUADOBJ', 'QMATRIX', 'QSECTION'):
+                lower = section != 'QMATRIX'
+                continue
+        if section in ('QUADOBJ', 'QMATRIX', 'QSECTION'):
+            if s.strip() and s[0] != '*': quad.append(s.split())
+        else:
+            lines.append(s)
+
+    # The linear part is read with op.fromfile.
+    fd, tmp = tempfile.mkstemp(suffix = '.mps')
+    with os.fdopen(fd, 'w') as f: f.writelines(lines)
+    try:
+        lp = op()
+        lp.fromfile(tmp)
+    finally:
+        os.remove(tmp)
+    c, G, h, A, b, x, vmap = matrixform(lp)
+
+    # Index of each column of the MPS file in x.
+    index = {}
+    for v in lp.variables():
+        if vmap is None: f = v
+        else: f = vmap[v]
+        index[v.name] = sparse(f._linear._coeff[x]).J[0]
+    I, J, V = [], [], []
+    for col1, col2, val in quad:
+        i, j, val = index[col1], index[col2], float(val)
+        I.append(i);  J.append(j);  V.append(val)
+        if lower and i != j:
+            I.append(j);  J.append(i);  V.append(val)
+    n = len(x)
+    P = spmatrix(V, I, J, (n,n))
+    return {'P': P, 'q': c, 'G': G, 'h': h, 'A': A, 'b': b}
+
+
+def read_sdpa(filename):
+    """
+    Reads an SDP from a sparse SDPA file, i.e., the problem
+
+        minimize    c'*x
+        subject to  sum_i x_i * F_i - F_0 >= 0
+
+    with block diagonal matrices F_i.  Blocks with a negative size are
+    diagonal and are converted to linear inequalities.  The problem is
+    returned in the format of solvers.sdp, with Gs = -F_i and hs = -F_0.
+    """
+
+    tokens = []
+    for s in open(filename):
+        if s[:1] in ('"', '*'): continue
+        tokens.extend(re.sub('[,{}()]', ' ', s).split())
+    m, nblocks = int(tokens[0]), int(tokens[1])
+    sizes = [ int(float(t)) for t in tokens[2 : 2+nblocks] ]
+    pos = 2 + nblocks
+    c = matrix([ float(t) for t in tokens[pos : pos+m] ])
+    pos += m
+
+    # Offsets of the diagonal blocks in the 'l' component.
+    offsets, ml = {}, 0
+    for k, size in enumerate(sizes):
+        if size < 0:
+            offsets[k] = ml
+            ml -= size
+    Gl, hl = ([], [], []), matrix(0.0, (ml,1))
+    Gs = [ ([], [], []) for size in sizes ]
+    hs = [ matrix(0.0, (abs(size), abs(size))) for size in sizes ]
+    for t in range(pos, len(tokens) - 4, 5):
+        i = int(tokens[t])
+        k, r, s = [ int(tok) - 1 for tok in tokens[t+1 : t+4] ]
+        v = -float(tokens[t+4])
+        if sizes[k] < 0:
+            if i == 0: hl[offsets[k] + r] = v
+            else:
+                Gl[0].append(v);  Gl[1].append(offsets[k] + r)
+                Gl[2].append(i-1)
+        elif i == 0:
+            hs[k][r,s] = hs[k][s,r] = v
+        else:
+            n = sizes[k]
+            Gs[k][0].append(v);  Gs[k][1].append(r + s*n)
+            Gs[k][2].append(i-1)
+            if r != s:
+                Gs[k][0].append(v);  Gs[k][1].append(s + r*n)
+                Gs[k][2].append(i-1)
+    blocks = [ k for k in range(nblocks) if sizes[k] > 0 ]
+    return {'c': c, 'Gl': spmatrix(Gl[0], Gl[1], Gl[2], (ml, m)),
+        'hl': hl, 'Gs': [ spmatrix(Gs[k][0], Gs[k][1], Gs[k][2],
+        (sizes[k]**2, m)) for k in blocks ], 'hs': [ hs[k] for k in
+        blocks ]}
+
+
+READERS = {'lp': read_mps, 'qp': read_qps, 'sdp': read_sdpa}
+
+
+def write_sdpa(filename, c, Gs, hs):
+    """
+    Writes the SDP
+
+        minimize    c'*x
+        subject to  sum_i x_i * Gs[k][:,i] + Ss[k] = hs[k]
+
+    with dense Gs[k] and hs[k] to a sparse SDPA file.
+    """
+
+    m = len(c)
+    f = open(filename, 'w')
+    f.write('"generated by suite.py"\n%d\n%d\n' %(m, len(hs)))
+    f.write(' '.join([ str(h.size[0]) for h in hs ]) + '\n')
+    f.write(' '.join([ repr(ci) for ci in c ]) + '\n')
+    for i in range(m + 1):
+        for k, h in enumerate(hs):
+            n = h.size[0]
+            for s in range(n):
+                for r in range(s+1):
+                    if i == 0: v = h[r,s]
+                    else: v = Gs[k][r + s*n, i-1]
+                    if v: f.write('%d %d %d %d %r\n' %(i, k+1, r+1, s+1, -v))
+    f.close()
+
+
+def generate(directory):
+    """
+    Writes random, strictly feasible and bounded LPs, QPs and SDPs to
+    directory.  Returns the list of file names.
+    """
+
+    if not os.path.isdir(directory): os.makedirs(directory)
+    setseed(1)
+    files = []
+
+    for m, n in [(100, 50), (400, 200)]:
+        G = normal(m, n)
+        x0 = uniform(n,1)
+        h = G*x0 + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        A = normal(n//10, n)
+        b = A*x0
+
+        x = variable(n, 'x')
+        lp = op(dot(c, x), [G*x <= h, A*x == b], 'lp%d' %n)
+        name = os.path.join(directory, 'lp%d.mps' %n)
+        lp.tofile(name)
+        files.append(name)
+
+        # The QP has the same constraints and objective (1/2) x'*P*x +
+        # c'*x with P = M*M' of rank n/2.  The QUADOBJ section is added
+        # to the MPS file of the LP.
+        M = normal(n, n//2)
+        P = M*M.T
+        lp.name = 'qp%d' %n
+        name = os.path.join(directory, 'qp%d.qps' %n)
+        lp.tofile(name)
+        lines = open(name).readlines()
+        assert lines[-1].startswith('ENDATA')
+        f = open(name, 'w')
+        f.writelines(lines[:-1])
+        f.write('QUADOBJ\n')
+        for j in range(n):
+            for i in range(j, n):
+                col1 = ('x_%d' %i).rjust(8)
+                col2 = ('x_%d' %j).rjust(8)
+                f.write(4*' ' + col1 + 2*' ' + col2 + 2*' ' +
+                    '% 12.5E\n' %P[i,j])
+        f.write('ENDATA\n')
+        f.close()
+        files.append(name)
+
+    # The SDPs are strictly feasible (x = 0, S = I) and dual strictly
+    # feasible (Z = I).
+    for m, sizes in [(10, [20, 10]), (40, [60])]:
+        Gs = [ normal(n**2, m) for n in sizes ]
+        for G, n in zip(Gs, sizes):
+            for i in range(m):
+                Gi = matrix(G[:,i], (n,n))
+                G[:,i] = (Gi + Gi.T)[:]
+        hs = [ spmatrix(1.0, range(n), range(n)) for n in sizes ]
+        hs = [ matrix(h) for h in hs ]
+        c = matrix(0.0, (m,1))
+        for G, n in zip(Gs, sizes):
+            c -= G[::n+1,:].T * matrix(1.0, (n,1))
+        name = os.path.join(directory, 'sdp%d.dat-s' %m)
+        write_sdpa(name, c, Gs, hs)
+        files.append(name)
+
+    return files
+
+
+def solve(kind, data, kktsolver, dense = False):
+    """
+    Solves the instance and returns the solution dictionary.
+    """
+
+    # The QR and native solvers require dense matrices.
+    if dense or kktsolver in ('qr', 'native'):
+        data = dict([ (key, [ matrix(v) for v in val ] if
+            isinstance(val, list) else matrix(val)) for key, val in
+            data.items() ])
+    options = {'show_progress': False}
+    if kktsolver == 'native':
+        kw = {'solver': 'native', 'options': options}
+    else:
+        kw = {'kktsolver': kktsolver, 'options': options}
+    if kind == 'lp':
+        return solvers.lp(data['c'], data['G'], data['h'], data['A'],
+            data['b'], **kw)
+    elif kind == 'qp':
+        return solvers.qp(data['P'], data['q'], data['G'], data['h'],
+            data['A'], data['b'], **kw)
+    else:
+        return solvers.sdp(data['c'], data['Gl'], data['hl'], data['Gs'],
+            data['hs'], **kw)
+
+
+def maxrss():
+    if resource is None: return None
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+
+
+def run(filename, kktsolver, dense = False):
+    """
+    Reads and solves an instance and returns a dictionary with the
+    results.
+    """
+
+    kind = instance_type(filename)
+    data = READERS[kind](filename)
+    if kind == 'sdp':
+        size = (data['c'].size[0], data['Gl'].size[0] + sum([ G.size[0]
+            for G in data['Gs'] ]))
+    else:
+        size = (data['G'].size[1], data['G'].size[0] + data['A'].size[0])
+    res = {'instance': os.path.basename(filename), 'type': kind,
+        'checksum': checksum(filename), 'kktsolver': kktsolver, 'variables': size[0], 'constraints':
+        size[1], 'status': None, 'iterations': None, 'objective': None,
+        'time': None, 'memory': None}
+    t0 = time.time()
+    try:
+        sol = solve(kind, data, kktsolver, dense)
+    except (ValueError, ArithmeticError, TypeError) as e:
+        res['status'] = 'error: %s' %e
+    else:
+        res['status'] = sol['status']
+        res['iterations'] = sol['iterations']
+        res['objective'] = sol['primal objective']
+    res['time'] = time.time() - t0
+    res['memory'] = maxrss()
+    return res
+
+
+def run_worker(filename, kktsolver, dense = False):
+    """
+    Runs an instance in a separate process.
+    """
+
+    args = [sys.executable, os.path.abspath(__file__), '--worker',
+        filename, kktsolver]
+    if dense: args.append('--dense')
+    proc = subprocess.Popen(args, stdout = subprocess.PIPE,
+        stderr = subprocess.PIPE)
+    out, err = proc.communicate()
+    if proc.returncode:
+        return {'instance': os.path.basename(filename), 'type':
+            instance_type(filename), 'checksum': checksum(filename),
+            'kktsolver': kktsolver, 'status':
+            'error: exit status %d' %proc.returncode, 'iterations': None,
+            'objective': None, 'time': None, 'memory': None}
+    return json.loads(out.decode().strip().split('\n')[-1])
+
+
+def instances(args):
+    files = []
+    for arg in args:
+        if os.path.isdir(arg):
+            for name in sorted(os.listdir(arg)):
+                if instance_type(name): files.append(os.path.join(arg, name))
+        elif instance_type(arg):
+            files.append(arg)
+        else:
+            raise ValueError("unknown file type: '%s'" %arg)
+    return files
+
+
+def mismatches(old, new):
+    """
+    Returns the sorted list of instance names in the results old and new
+    with different or missing checksums.
+    """
+
+    ref = dict([ (r['instance'], r.get('checksum')) for r in
+        old['results'] ])
+    return sorted(set([ r['instance'] for r in new['results'] if
+        r['instance'] in ref and (r.get('checksum') is None or
+        r.get('checksum') != ref[r['instance']]) ]))
+
+
+def compare(old, new, tolerance = 0.25, mintime = 0.05):
+    """
+    Returns a list of (instance, kktsolver, field, old value, new value)
+    for the runs in the results new that are worse than in old.  Raises
+    ValueError if the results are for different instances with the same
+    name.
+    """
+
+    names = mismatches(old, new)
+    if names:
+        raise ValueError("different instances with the same name: %s"
+            %', '.join(names))
+    ref = dict([ ((r['instance'], r['kktsolver']), r) for r in
+        old['results'] ])
+    regressions = []
+    for r in new['results']:
+        key = (r['instance'], r['kktsolver'])
+        if key not in ref: continue
+        r0 = ref[key]
+        if r0['status'] == 'optimal' and r['status'] != 'optimal':
+            regressions.append(key + ('status', r0['status'],
+                r['status']))
+            continue
+        if None not in (r0['iterations'], r['iterations']) and \
+            r['iterations'] > r0['iterations']:
+            regressions.append(key + ('iterations', r0['iterations'],
+                r['iterations']))
+        if None not in (r0['time'], r['time']) and r['time'] > (1.0 +
+            tolerance) * r0['time'] and r['time'] - r0['time'] > mintime:
+            regressions.append(key + ('time', r0['time'], r['time']))
+        if None not in (r0['memory'], r['memory']) and r['memory'] > \
+            (1.0 + tolerance) * r0['memory']:
+            regressions.append(key + ('memory', r0['memory'],
+                r['memory']))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description = 'Benchmark suite for '
+        'lp, qp and sdp.')
+    parser.add_argument('files', nargs = '*', help = 'MPS, QPS or SDPA '
+        'files, or directories')
+    parser.add_argument('-o', '--output', default = 'results.json',
+        help = 'results file (default: results.json)')
+    parser.add_argument('-k', '--kktsolvers', help = 'comma-separated '
+        'list of KKT solvers (default: all)')
+    parser.add_argument('--dense', action = 'store_true', help =
+        'convert the problem data to dense matrices')
+    parser.add_argument('--inline', action = 'store_true', help =
+        'run the instances in the calling process')
+    parser.add_argument('--generate', metavar = 'DIR', help = 'write the '
+        'generated instances to DIR and exit')
+    parser.add_argument('--compare', nargs = 2, metavar = ('OLD', 'NEW'),
+        help = 'compare two results files')
+    parser.add_argument('--tolerance', type = float, default = 0.25,
+        help = 'relative increase in time or memory that is reported as '
+        'a regression (default: 0.25)')
+    parser.add_argument('--worker', nargs = 2, help = argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        print(json.dumps(run(args.worker[0], args.worker[1], args.dense)))
+        return 0
+
+    if args.generate:
+        for name in generate(args.generate): print(name)
+        return 0
+
+    if args.compare:
+        old, new = [ json.load(open(name)) for name in args.compare ]
+        try:
+            regressions = compare(old, new, args.tolerance)
+        except ValueError as e:
+            sys.stderr.write("suite.py: %s\n" %e)
+            return 2
+        for reg in regressions:
+            print("%-20s %-8s %-10s %12s %12s" %tuple([ str(v) if type(v)
+                is not float else '%.4g' %v for v in reg ]))
+        return int(len(regressions) > 0)
+
+    tmpdir = None
+    if args.files:
+        files = instances(args.files)
+    else:
+        tmpdir = tempfile.mkdtemp()
+        files = generate(tmpdir)
+        boeing = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+            '..', '..', 'tests', 'boeing2.mps')
+        if os.path.exists(boeing): files.append(os.path.normpath(boeing))
+
+    results = []
+    print("%-20s %-8s %-20s %6s %10s %10s" %("instance", "kkt", "status",
+        "iters", "time", "memory"))
+    for name in files:
+        kktsolvers = KKTSOLVERS[instance_type(name)]
+        if args.kktsolvers:
+            kktsolvers = [ k for k in args.kktsolvers.split(',') if k in
+                kktsolvers ]
+        for kktsolver in kktsolvers:
+            if args.inline: res = run(name, kktsolver, args.dense)
+            else: res = run_worker(name, kktsolver, args.dense)
+            results.append(res)
+            print("%-20s %-8s %-20s %6s %10s %10s" %(res['instance'],
+                kktsolver, res['status'][:20], res['iterations'], '%.3f'
+                %res['time'] if res['time'] is not None else None,
+                res['memory']))
+
+    if tmpdir is not None:
+        for name in os.listdir(tmpdir): os.remove(os.path.join(tmpdir, name))
+        os.rmdir(tmpdir)
+
+    with open(args.output, 'w') as f:
+        json.dump({'version': cvxopt.__version__, 'python':
+            sys.version.split()[0], 'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+            'results': results}, f, indent = 1)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,102 @@
+# Compares cold starts and warm starts (the warmstart argument of conelp,
+# lp and qp) on sequences of problems with perturbed data.
+#
+# For each test, the problem is solved once, and then re-solved a number
+# of times after a small perturbation of the data, once from the default
+# starting point and once warm-started from the solution of the
+# unperturbed problem.  The script prints the total number of iterations
+# and the total solution time of the re-solves.
+
+import time
+from cvxopt import matrix, normal, uniform, setseed, solvers
+
+solvers.options['show_progress'] = False
+NRESOLVE = 20
+
+def run(name, solve, perturb):
+    sol0 = solve(None)
+    res = {}
+    for mode in ['cold', 'warm']:
+        setseed(1)
+        iters, t0 = 0, time.time()
+        for k in range(NRESOLVE):
+            perturb()
+            sol = solve(sol0 if mode == 'warm' else None)
+            iters += sol['iterations']
+        res[mode] = (iters, time.time() - t0)
+    print("%-24s %8d %8d %10.3f %10.3f" %(name, res['cold'][0],
+        res['warm'][0], res['cold'][1], res['warm'][1]))
+
+
+# The small linear cone program of examples/doc/chap8/conelp.py, with
+# perturbed c and h.
+
+c0 = matrix([-6., -4., -5.])
+G = matrix([[ 16., 7.,  24.,  -8.,   8.,  -1.,  0., -1.,  0.,  0.,   7.,
+    -5.,   1.,  -5.,   1.,  -7.,   1.,   -7.,  -4.],
+            [-14., 2.,   7., -13., -18.,   3.,  0.,  0., -1.,  0.,   3.,
+    13.,  -6.,  13.,  12., -10.,  -6.,  -10., -28.],
+            [  5., 0., -15.,  12.,  -6.,  17.,  0.,  0.,  0., -1.,   9.,
+     6.,  -6.,   6.,  -7.,  -7.,  -6.,   -7., -11.]])
+h0 = matrix( [ -3., 5.,  12.,  -2., -14., -13., 10.,  0.,  0.,  0.,  68.,
+    -30., -19., -30.,  99.,  23., -19.,   23.,  10.] )
+dims = {'l': 2, 'q': [4, 4], 's': [3]}
+data = {'c': +c0, 'h': +h0}
+
+def perturb():
+    data['c'] = c0 + 1e-2 * normal(3,1)
+    dh = 1e-2 * normal(19,1)
+    # Keep the 's' block symmetric.
+    dh[13], dh[16], dh[17] = dh[11], dh[12], dh[15]
+    data['h'] = h0 + dh
+
+def solve(ws):
+    return solvers.conelp(data['c'], G, data['h'], dims, warmstart = ws)
+
+print("%-24s %8s %8s %10s %10s" %("problem", "cold it", "warm it",
+    "cold time", "warm time"))
+run("conelp (chap8/conelp.py)", solve, perturb)
+
+
+# A random LP with 500 inequalities and 100 variables, with perturbed
+# b and c.
+
+setseed(2)
+m, n = 500, 100
+A = normal(m,n)
+b0 = A*uniform(n,1) + uniform(m,1)
+c0 = -A.T*uniform(m,1)
+data = {'b': +b0, 'c': +c0}
+
+def perturb():
+    data['b'] = b0 + 1e-3 * normal(m,1)
+    data['c'] = c0 + 1e-3 * normal(n,1)
+
+def solve(ws):
+    return solvers.lp(data['c'], A, data['b'], warmstart = ws)
+
+run("lp (500 x 100)", solve, perturb)
+
+
+# The portfolio QP of examples/doc/chap8/portfolio.py, with perturbed
+# expected returns.
+
+S = matrix( [[ 4e-2,  6e-3, -4e-3,   0.0 ],
+             [ 6e-3,  1e-2,  0.0,    0.0 ],
+             [-4e-3,  0.0,   2.5e-3, 0.0 ],
+             [ 0.0,   0.0,   0.0,    0.0 ]] )
+pbar0 = matrix([.12, .10, .07, .03])
+G = matrix(0.0, (4,4))
+G[::5] = -1.0
+h = matrix(0.0, (4,1))
+A = matrix(1.0, (1,4))
+b = matrix(1.0)
+data = {'pbar': +pbar0}
+
+def perturb():
+    data['pbar'] = pbar0 + 1e-3 * normal(4,1)
+
+def solve(ws):
+    return solvers.qp(10.0*S, -data['pbar'], G, h, A, b, warmstart = ws)
+
+run("qp (chap8/portfolio.py)", solve, perturb)
@@ -81,6 +81,9 @@ else:
 # Directory containing SuiteSparse source
 SUITESPARSE_SRC_DIR = ''
 
+# Set to 1 to compile with OpenMP (used for multithreaded solves).
+BUILD_OPENMP = 0
+
 # Set to 1 if compiling with MSVC 14 or later
 MSVC=0
 
@@ -110,12 +113,19 @@ SUITESPARSE_LIB_DIR = os.environ.get("CVXOPT_SUITESPARSE_LIB_DIR",SUITESPARSE_LI
 SUITESPARSE_INC_DIR = os.environ.get("CVXOPT_SUITESPARSE_INC_DIR",SUITESPARSE_INC_DIR)
 SUITESPARSE_SRC_DIR = os.environ.get("CVXOPT_SUITESPARSE_SRC_DIR",SUITESPARSE_SRC_DIR)
 MSVC = int(os.environ.get("CVXOPT_MSVC",MSVC)) == True
+BUILD_OPENMP = int(os.environ.get("CVXOPT_BUILD_OPENMP",BUILD_OPENMP))
 INSTALL_REQUIRES = os.environ.get("CVXOPT_INSTALL_REQUIRES",[])
 if type(INSTALL_REQUIRES) is str: INSTALL_REQUIRES = INSTALL_REQUIRES.strip().split(';')
 
 RT_LIB = ["rt"] if sys.platform.startswith("linux") else []
 M_LIB = ["m"] if not MSVC else []
 UMFPACK_EXTRA_COMPILE_ARGS = ["-Wno-unknown-pragmas"] if not MSVC else []
+if BUILD_OPENMP:
+    OPENMP_COMPILE_ARGS = ["-fopenmp"] if not MSVC else ["/openmp"]
+    OPENMP_LINK_ARGS = ["-fopenmp"] if not MSVC else []
+else:
+    OPENMP_COMPILE_ARGS = []
+    OPENMP_LINK_ARGS = []
 
 extmods = []
 
@@ -183,6 +193,8 @@ if not SUITESPARSE_SRC_DIR:
         libraries = ['umfpack','cholmod','amd','colamd','suitesparseconfig'] + LAPACK_LIB + BLAS_LIB + RT_LIB,
         include_dirs = [SUITESPARSE_INC_DIR],
         library_dirs = [SUITESPARSE_LIB_DIR, BLAS_LIB_DIR],
+        extra_compile_args = OPENMP_COMPILE_ARGS,
+        extra_link_args = OPENMP_LINK_ARGS,
         sources = ['src/C/umfpack.c'])
 else:
     umfpack = Extension('umfpack',
@@ -194,8 +206,8 @@ else:
         library_dirs = [ BLAS_LIB_DIR ],
         define_macros = MACROS + [('NTIMER', '1'), ('NCHOLMOD', '1')],
         libraries = LAPACK_LIB + BLAS_LIB,
-        extra_compile_args = UMFPACK_EXTRA_COMPILE_ARGS,
-        extra_link_args = BLAS_EXTRA_LINK_ARGS,
+        extra_compile_args = UMFPACK_EXTRA_COMPILE_ARGS + OPENMP_COMPILE_ARGS,
+        extra_link_args = BLAS_EXTRA_LINK_ARGS + OPENMP_LINK_ARGS,
         sources = [ 'src/C/umfpack.c',
             SUITESPARSE_SRC_DIR + '/UMFPACK/Source/umfpack_tictoc.c',
             SUITESPARSE_SRC_DIR + '/SuiteSparse_config/SuiteSparse_config.c'] +
@@ -248,7 +260,8 @@ misc_solvers = Extension('misc_solvers',
     libraries = LAPACK_LIB + BLAS_LIB,
     library_dirs = [ BLAS_LIB_DIR ],
     define_macros = MACROS,
-    extra_link_args = BLAS_EXTRA_LINK_ARGS,
+    extra_compile_args = OPENMP_COMPILE_ARGS,
+    extra_link_args = BLAS_EXTRA_LINK_ARGS + OPENMP_LINK_ARGS,
     sources = ['src/C/misc_solvers.c'] )
 
 extmods += [base, blas, lapack, umfpack, cholmod, amd, misc_solvers]
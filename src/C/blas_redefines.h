@@ -152,5 +152,9 @@
 #define zgges_ zgges
 #define dgeqp3_ dgeqp3
 #define zgeqp3_ zgeqp3
+#define spotrf_ spotrf
+#define spotrs_ spotrs
+#define ssytrf_ ssytrf
+#define ssytrs_ ssytrs
 
 #endif
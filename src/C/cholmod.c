@@ -78,6 +78,9 @@ PyDoc_STRVAR(cholmod__doc__, "Interface to the CHOLMOD library.\n\n"
 static PyObject *cholmod_module;
 static cholmod_common Common;
 
+/* Solution and workspaces of cholmod_solve2, reused by solve_dense(). */
+static cholmod_dense *Xws = NULL, *Yws = NULL, *Ews = NULL;
+
 static int set_options(void)
 {
     int_t pos=0;
@@ -443,6 +446,43 @@ static PyObject* numeric(PyObject *self, PyObject *args)
 }
 
 
+/*
+ * Solves with the numeric factor L and the nrhs columns of B that
+ * start at offset oB, as one block.  The columns of B are passed to
+ * cholmod_solve2 without copying.  The solution and the workspaces are
+ * kept in Xws, Yws and Ews and reused by later calls (cholmod_solve2
+ * reallocates them only if they have the wrong size or type).  The
+ * solution is copied back into B.  Returns 0 and sets an exception if
+ * CHOLMOD fails.
+ */
+static int solve_dense(int sys, cholmod_factor *L, matrix *B, int nrhs,
+    int ldB, int oB)
+{
+    cholmod_dense b;
+    int k, n = L->n, esize = E_SIZE[MAT_ID(B)];
+
+    b.nrow = n;
+    b.ncol = nrhs;
+    b.d = ldB;
+    b.nzmax = (size_t) ldB * nrhs;
+    b.x = (unsigned char *) MAT_BUF(B) + oB*esize;
+    b.z = NULL;
+    b.xtype = (MAT_ID(B) == DOUBLE ? CHOLMOD_REAL : CHOLMOD_COMPLEX);
+    b.dtype = CHOLMOD_DOUBLE;
+
+    if (!CHOL(solve2) (sys, L, &b, NULL, &Xws, NULL, &Yws, &Ews, &Common)
+        || Common.status != CHOLMOD_OK){
+        if (Common.status == CHOLMOD_OUT_OF_MEMORY) PyErr_NoMemory();
+        else PyErr_SetString(PyExc_ValueError, "solve step failed");
+        return 0;
+    }
+    for (k=0; k<nrhs; k++)
+        memcpy((unsigned char *) b.x + (size_t) k*ldB*esize,
+            (unsigned char *) Xws->x + (size_t) k*Xws->d*esize, n*esize);
+    return 1;
+}
+
+
 static char doc_solve[] =
     "Solves a sparse set of linear equations with a factored\n"
     "coefficient matrix and an dense matrix as right-hand side.\n\n"
@@ -475,7 +515,7 @@ static PyObject* solve(PyObject *self, PyObject *args, PyObject *kwrds)
 {
     matrix *B;
     PyObject *F;
-    int i, n, oB=0, ldB=0, nrhs=-1, sys=0;
+    int n, oB=0, ldB=0, nrhs=-1, sys=0;
 #if PY_MAJOR_VERSION >= 3
     const char *descr;
 #else
@@ -526,28 +566,7 @@ static PyObject* solve(PyObject *self, PyObject *args, PyObject *kwrds)
     if (oB < 0) err_nn_int("offsetB");
     if (oB + (nrhs-1)*ldB + n > MAT_LGT(B)) err_buf_len("B");
 
-    cholmod_dense *x;
-    cholmod_dense *b = CHOL(allocate_dense)(n, 1, n,
-        (MAT_ID(B) == DOUBLE ? CHOLMOD_REAL : CHOLMOD_COMPLEX),
-        &Common);
-    if (Common.status == CHOLMOD_OUT_OF_MEMORY) return PyErr_NoMemory();
-
-    void *b_old = b->x;
-    for (i=0; i<nrhs; i++){
-        b->x = (unsigned char*)MAT_BUF(B) + (i*ldB + oB)*E_SIZE[MAT_ID(B)];
-        x = CHOL(solve) (sysvalues[sys], L, b, &Common);
-        if (Common.status != CHOLMOD_OK){
-            PyErr_SetString(PyExc_ValueError, "solve step failed");
-            CHOL(free_dense)(&x, &Common);
-            CHOL(free_dense)(&b, &Common);
-	    return NULL;
-	}
-	memcpy(b->x, x->x, n*E_SIZE[MAT_ID(B)]);
-        CHOL(free_dense)(&x, &Common);
-    }
-    b->x = b_old;
-    CHOL(free_dense)(&b, &Common);
-
+    if (!solve_dense(sysvalues[sys], L, B, nrhs, ldB, oB)) return NULL;
     return Py_BuildValue("");
 }
 
@@ -681,11 +700,9 @@ static PyObject* linsolve(PyObject *self, PyObject *args,
 {
     spmatrix *A;
     matrix *B, *P=NULL;
-    int i, n, oB=0, ldB=0, nrhs=-1;
+    int n, oB=0, ldB=0, nrhs=-1;
     cholmod_sparse *Ac=NULL;
     cholmod_factor *L=NULL;
-    cholmod_dense *x=NULL, *b=NULL;
-    void *b_old;
 #if PY_MAJOR_VERSION >= 3
     int uplo_ = 'L';
 #endif
@@ -781,30 +798,10 @@ static PyObject* linsolve(PyObject *self, PyObject *args,
         CHOL(free_factor)(&L, &Common);
         PY_ERR(PyExc_ArithmeticError, "singular matrix");
     }
-    b = CHOL(allocate_dense)(n, 1, n, (MAT_ID(B) == DOUBLE ?
-        CHOLMOD_REAL : CHOLMOD_COMPLEX) , &Common);
-    if (Common.status == CHOLMOD_OUT_OF_MEMORY) {
+    if (!solve_dense(CHOLMOD_A, L, B, nrhs, ldB, oB)) {
         CHOL(free_factor)(&L, &Common);
-        CHOL(free_dense)(&b, &Common);
-        return PyErr_NoMemory();
-    }
-    b_old = b->x;
-    for (i=0; i<nrhs; i++) {
-        b->x = (unsigned char*)MAT_BUF(B) + (i*ldB + oB)*E_SIZE[MAT_ID(B)];
-        x = CHOL(solve) (CHOLMOD_A, L, b, &Common);
-        if (Common.status != CHOLMOD_OK){
-            PyErr_SetString(PyExc_ValueError, "solve step failed");
-            CHOL(free_factor)(&L, &Common);
-            b->x = b_old;
-            CHOL(free_dense)(&b, &Common);
-            CHOL(free_dense)(&x, &Common);
-            return NULL;
-        }
-        memcpy(b->x, x->x, SP_NROWS(A)*E_SIZE[MAT_ID(B)]);
-        CHOL(free_dense)(&x, &Common);
+        return NULL;
     }
-    b->x = b_old;
-    CHOL(free_dense)(&b, &Common);
     CHOL(free_factor)(&L, &Common);
     return Py_BuildValue("");
 }
@@ -1019,6 +1016,466 @@ static PyObject* diag(PyObject *self, PyObject *args)
 }
 
 
+/* Descriptors of factors, indexed by the 'kind' used in save/load. */
+static const char *factor_names[] = {"CHOLMOD FACTOR D L",
+    "CHOLMOD FACTOR D U", "CHOLMOD FACTOR Z L", "CHOLMOD FACTOR Z U"};
+
+/*
+ * Returns the CHOLMOD factor in F and sets kind to the index of its
+ * descriptor in factor_names.  Returns NULL and raises a TypeError if
+ * F is not a CHOLMOD factor.
+ */
+static cholmod_factor* get_factor(PyObject *F, int *kind)
+{
+#if PY_MAJOR_VERSION >= 3
+    const char *descr;
+#else
+    char *descr;
+#endif
+
+#if PY_MAJOR_VERSION >= 3
+    if (!PyCapsule_CheckExact(F) || !(descr = PyCapsule_GetName(F)))
+        err_CO("F");
+#else
+    if (!PyCObject_Check(F)) err_CO("F");
+    descr = PyCObject_GetDesc(F);
+    if (!descr) PY_ERR_TYPE("F is not a CHOLMOD factor");
+#endif
+    for (*kind = 0; *kind < 4; (*kind)++)
+        if (!strcmp(descr, factor_names[*kind])) break;
+    if (*kind == 4) PY_ERR_TYPE("F is not a CHOLMOD factor");
+
+#if PY_MAJOR_VERSION >= 3
+    return (cholmod_factor *) PyCapsule_GetPointer(F, descr);
+#else
+    return (cholmod_factor *) PyCObject_AsVoidPtr(F);
+#endif
+}
+
+static PyObject* new_factor(cholmod_factor *L, int kind)
+{
+#if PY_MAJOR_VERSION >= 3
+    return (PyObject *) PyCapsule_New((void *) L, factor_names[kind],
+        (PyCapsule_Destructor) &cvxopt_free_cholmod_factor);
+#else
+    return (PyObject *) PyCObject_FromVoidPtrAndDesc((void *) L,
+        (void *) factor_names[kind], cvxopt_free_cholmod_factor);
+#endif
+}
+
+
+static char doc_copy[] =
+    "Returns a copy of a CHOLMOD factorization.\n\n"
+    "Fc = copy(F)\n\n"
+    "PURPOSE\n"
+    "Returns a new factorization object with a copy of the symbolic\n"
+    "or numeric factorization F.  The copy can be passed to\n"
+    "cholmod.numeric without modifying F.\n\n"
+    "ARGUMENTS\n"
+    "F         symbolic or numeric factorization computed by\n"
+    "          cholmod.symbolic or cholmod.numeric\n\n"
+    "Fc        copy of F";
+
+static PyObject* copy(PyObject *self, PyObject *args)
+{
+    PyObject *F;
+    cholmod_factor *L, *Lc;
+    int kind;
+
+    if (!set_options()) return NULL;
+    if (!PyArg_ParseTuple(args, "O", &F)) return NULL;
+    if (!(L = get_factor(F, &kind))) return NULL;
+
+    Lc = CHOL(copy_factor)(L, &Common);
+    if (Common.status != CHOLMOD_OK || !Lc){
+        CHOL(free_factor)(&Lc, &Common);
+        if (Common.status == CHOLMOD_OUT_OF_MEMORY)
+            return PyErr_NoMemory();
+        else
+            PY_ERR(PyExc_ValueError, "copying factorization failed");
+    }
+    return new_factor(Lc, kind);
+}
+
+
+/*
+ * File format used by save() and load():  the string FACTOR_MAGIC,
+ * the size of the integers, the kind of the factor and the scalar
+ * fields of the cholmod_factor struct, stored as int_t, followed by
+ * the arrays that are present in the factor.
+ */
+#define FACTOR_MAGIC "CVXOPT CHOLMOD 1"
+#define FACTOR_NFIELDS 15
+
+static int write_array(FILE *f, void *x, size_t size, size_t n)
+{
+    return (!n || fwrite(x, size, n, f) == n);
+}
+
+static int read_array(FILE *f, void **x, size_t size, size_t n)
+{
+    if (!(*x = CHOL(malloc)(n, size, &Common))) return 0;
+    return (!n || fread(*x, size, n, f) == n);
+}
+
+/*
+ * Checks the header h read by load() and returns 1 if the arrays it
+ * describes take exactly rem bytes, 0 otherwise.  Every count is
+ * compared with rem before it is used, so the sizes cannot overflow and
+ * nothing is allocated for a truncated or corrupted file.
+ */
+static int check_header(int_t *h, int iperm, size_t rem)
+{
+    int_t n = h[2], k;
+    size_t ex, cnt, isz = sizeof(int_t), dsz = sizeof(double), tot;
+
+    if (h[0] != sizeof(int_t) || h[1] < 0 || h[1] > 3 || n < 0 ||
+        h[3] < 0 || h[3] > n || (iperm != 0 && iperm != 1))
+        return 0;
+    for (k = 4; k < 10; k++) if (h[k] < 0 || (size_t) h[k] > rem)
+        return 0;
+    for (k = 11; k < 14; k++) if (h[k] != 0 && h[k] != 1) return 0;
+    if (h[14] != CHOLMOD_PATTERN && h[14] != CHOLMOD_REAL &&
+        h[14] != CHOLMOD_COMPLEX) return 0;
+
+    /* The xtype must match the kind (real 'D' or complex 'Z'). */
+    if (h[14] != CHOLMOD_PATTERN && (h[14] == CHOLMOD_COMPLEX) !=
+        (h[1] >= 2)) return 0;
+    if ((size_t) n > rem) return 0;
+    ex = (h[14] == CHOLMOD_COMPLEX) ? 2 : 1;
+
+    tot = (2 + iperm) * n * isz;
+    if (h[12]) {
+        if (h[5] > n) return 0;
+        tot += (3 * (size_t) (h[5] + 1) + h[6]) * isz;
+        if (h[14] != CHOLMOD_PATTERN) tot += ex * h[7] * dsz;
+    }
+    else if (h[14] != CHOLMOD_PATTERN) {
+        cnt = (n + 1) + h[4] + n + 2 * (n + 2);
+        tot += cnt * isz + ex * h[4] * dsz;
+    }
+    return tot == rem;
+}
+
+static char doc_save[] =
+    "Writes a CHOLMOD factorization to a file.\n\n"
+    "save(F, filename)\n\n"
+    "ARGUMENTS\n"
+    "F         symbolic or numeric factorization computed by\n"
+    "          cholmod.symbolic or cholmod.numeric\n\n"
+    "filename  string";
+
+static PyObject* save(PyObject *self, PyObject *args)
+{
+    PyObject *F;
+    cholmod_factor *L;
+    const char *filename;
+    FILE *f;
+    int kind, ok, ex;
+    size_t s;
+    int_t h[FACTOR_NFIELDS];
+
+    if (!PyArg_ParseTuple(args, "Os", &F, &filename)) return NULL;
+    if (!(L = get_factor(F, &kind))) return NULL;
+
+    h[0] = sizeof(int_t);   h[1] = kind;             h[2] = L->n;
+    h[3] = L->minor;        h[4] = L->nzmax;         h[5] = L->nsuper;
+    h[6] = L->ssize;        h[7] = L->xsize;         h[8] = L->maxcsize;
+    h[9] = L->maxesize;     h[10] = L->ordering;     h[11] = L->is_ll;
+    h[12] = L->is_super;    h[13] = L->is_monotonic; h[14] = L->xtype;
+    ex = (L->xtype == CHOLMOD_COMPLEX) ? 2 : 1;
+    s = L->nsuper + 1;
+
+    if (!(f = fopen(filename, "wb")))
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, filename);
+    ok = write_array(f, FACTOR_MAGIC, 1, strlen(FACTOR_MAGIC)) &&
+        write_array(f, h, sizeof(int_t), FACTOR_NFIELDS) &&
+        fputc(L->IPerm != NULL, f) != EOF &&
+        write_array(f, L->Perm, sizeof(int_t), L->n) &&
+        write_array(f, L->ColCount, sizeof(int_t), L->n) &&
+        (!L->IPerm || write_array(f, L->IPerm, sizeof(int_t), L->n));
+    if (ok && L->is_super) {
+        ok = write_array(f, L->super, sizeof(int_t), s) &&
+            write_array(f, L->pi, sizeof(int_t), s) &&
+            write_array(f, L->px, sizeof(int_t), s) &&
+            write_array(f, L->s, sizeof(int_t), L->ssize) &&
+            (L->xtype == CHOLMOD_PATTERN ||
+            write_array(f, L->x, ex*sizeof(double), L->xsize));
+    }
+    else if (ok && L->xtype != CHOLMOD_PATTERN) {
+        ok = write_array(f, L->p, sizeof(int_t), L->n+1) &&
+            write_array(f, L->i, sizeof(int_t), L->nzmax) &&
+            write_array(f, L->x, ex*sizeof(double), L->nzmax) &&
+            write_array(f, L->nz, sizeof(int_t), L->n) &&
+            write_array(f, L->next, sizeof(int_t), L->n+2) &&
+            write_array(f, L->prev, sizeof(int_t), L->n+2);
+    }
+    if (fclose(f) || !ok)
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, filename);
+
+    return Py_BuildValue("");
+}
+
+
+static char doc_load[] =
+    "Reads a CHOLMOD factorization from a file written by\n"
+    "cholmod.save.\n\n"
+    "F = load(filename)\n\n"
+    "ARGUMENTS\n"
+    "filename  string\n\n"
+    "F         the symbolic or numeric factorization, as an opaque C\n"
+    "          object";
+
+static PyObject* load(PyObject *self, PyObject *args)
+{
+    cholmod_factor *L;
+    const char *filename;
+    char magic[sizeof(FACTOR_MAGIC)];
+    FILE *f;
+    int ok, ex, iperm;
+    size_t s;
+    long pos, end;
+    int_t h[FACTOR_NFIELDS];
+
+    if (!set_options()) return NULL;
+    if (!PyArg_ParseTuple(args, "s", &filename)) return NULL;
+
+    if (!(f = fopen(filename, "rb")))
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, filename);
+    magic[strlen(FACTOR_MAGIC)] = 0;
+    if (fread(magic, 1, strlen(FACTOR_MAGIC), f) != strlen(FACTOR_MAGIC)
+        || strcmp(magic, FACTOR_MAGIC) ||
+        fread(h, sizeof(int_t), 1, f) != 1 || h[0] != sizeof(int_t) ||
+        fread(h+1, sizeof(int_t), FACTOR_NFIELDS-1, f) !=
+        FACTOR_NFIELDS-1 || (iperm = fgetc(f)) == EOF ||
+        (pos = ftell(f)) < 0 || fseek(f, 0, SEEK_END) ||
+        (end = ftell(f)) < pos || fseek(f, pos, SEEK_SET) ||
+        !check_header(h, iperm, (size_t) (end - pos))){
+        fclose(f);
+        PY_ERR(PyExc_ValueError, "not a valid CHOLMOD factor file");
+    }
+
+    if (!(L = CHOL(allocate_factor)(h[2], &Common))){
+        fclose(f);
+        return PyErr_NoMemory();
+    }
+    L->minor = h[3];     L->nzmax = h[4];     L->nsuper = h[5];
+    L->ssize = h[6];     L->xsize = h[7];     L->maxcsize = h[8];
+    L->maxesize = h[9];  L->ordering = h[10]; L->is_ll = h[11];
+    L->is_super = h[12]; L->is_monotonic = h[13];
+    ex = (h[14] == CHOLMOD_COMPLEX) ? 2 : 1;
+    s = L->nsuper + 1;
+
+    ok = fread(L->Perm, sizeof(int_t), L->n, f) == L->n &&
+        fread(L->ColCount, sizeof(int_t), L->n, f) == L->n &&
+        (!iperm || read_array(f, &L->IPerm, sizeof(int_t), L->n));
+    if (ok && L->is_super) {
+        ok = read_array(f, &L->super, sizeof(int_t), s) &&
+            read_array(f, &L->pi, sizeof(int_t), s) &&
+            read_array(f, &L->px, sizeof(int_t), s) &&
+            read_array(f, &L->s, sizeof(int_t), L->ssize);
+        if (ok && h[14] != CHOLMOD_PATTERN){
+            L->xtype = h[14];
+            ok = read_array(f, &L->x, ex*sizeof(double), L->xsize);
+        }
+    }
+    else if (ok && h[14] != CHOLMOD_PATTERN) {
+        L->xtype = h[14];
+        ok = read_array(f, &L->p, sizeof(int_t), L->n+1) &&
+            read_array(f, &L->i, sizeof(int_t), L->nzmax) &&
+            read_array(f, &L->x, ex*sizeof(double), L->nzmax) &&
+            read_array(f, &L->nz, sizeof(int_t), L->n) &&
+            read_array(f, &L->next, sizeof(int_t), L->n+2) &&
+            read_array(f, &L->prev, sizeof(int_t), L->n+2);
+    }
+    fclose(f);
+
+    /* The arrays must also be consistent with each other. */
+    if (ok && !CHOL(check_factor)(L, &Common)) ok = 0;
+
+    if (!ok) {
+        CHOL(free_factor)(&L, &Common);
+        if (Common.status == CHOLMOD_OUT_OF_MEMORY)
+            return PyErr_NoMemory();
+        PY_ERR(PyExc_ValueError, "not a valid CHOLMOD factor file");
+    }
+    return new_factor(L, (int) h[1]);
+}
+
+
+/*
+ * Returns P*A, where P is the fill-reducing permutation of L, as a
+ * packed cholmod_sparse matrix with sorted row indices.
+ */
+static cholmod_sparse* permute_rows(spmatrix *A, cholmod_factor *L)
+{
+    cholmod_sparse *Ac, *PAc;
+
+    if (!(Ac = create_matrix(A))) return NULL;
+    PAc = CHOL(submatrix)(Ac, L->Perm, L->n, NULL, -1, 1, 1, &Common);
+    free_matrix(Ac);
+    return PAc;
+}
+
+/*
+ * Returns the real numeric factor in F and checks that A is a real
+ * sparse matrix with n rows.  Returns NULL and raises an exception if
+ * not.
+ */
+static cholmod_factor* get_real_numeric(PyObject *F, spmatrix *A,
+    int ncols)
+{
+    cholmod_factor *L;
+    int kind;
+
+    if (!(L = get_factor(F, &kind))) return NULL;
+    if (kind > 1) PY_ERR_TYPE("F must be the factor of a 'd' matrix");
+    if (L->xtype == CHOLMOD_PATTERN)
+        PY_ERR(PyExc_ValueError, "F must be a numeric factor");
+    if (A && (!SpMatrix_Check(A) || SP_ID(A) != DOUBLE ||
+        SP_NROWS(A) != L->n || (ncols >= 0 && SP_NCOLS(A) != ncols))){
+        if (ncols < 0)
+            PY_ERR_TYPE("C must be a sparse 'd' matrix with F.n rows");
+        PY_ERR_TYPE("R must be a sparse 'd' matrix of size (F.n,1)");
+    }
+    return L;
+}
+
+static PyObject* updown_status(cholmod_factor *L)
+{
+    if (Common.status == CHOLMOD_OUT_OF_MEMORY)
+        return PyErr_NoMemory();
+    if (Common.status < 0)
+        PY_ERR(PyExc_ValueError, "modification of factor failed");
+    if (Common.status == CHOLMOD_NOT_POSDEF || L->minor < L->n){
+        PyErr_SetObject(PyExc_ArithmeticError, Py_BuildValue("i",
+            L->minor));
+        return NULL;
+    }
+    return Py_BuildValue("");
+}
+
+
+static char doc_updown[] =
+    "Rank-k update or downdate of a Cholesky factorization.\n\n"
+    "updown(F, C, update=True)\n\n"
+    "PURPOSE\n"
+    "If F is the numeric factorization of a real matrix A, computes\n"
+    "the factorization of A + C*C^T (update is True) or A - C*C^T\n"
+    "(update is False), without refactoring A.  On exit F contains\n"
+    "the new factorization, in simplicial L*D*L^T form.  An\n"
+    "ArithmeticError is raised if CHOLMOD reports that the new\n"
+    "matrix is not positive definite.\n\n"
+    "ARGUMENTS\n"
+    "F         numeric factorization of a 'd' matrix of order n,\n"
+    "          computed by cholmod.numeric\n\n"
+    "C         sparse 'd' matrix with n rows\n\n"
+    "update    True or False";
+
+static PyObject* updown(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    PyObject *F;
+    spmatrix *C;
+    cholmod_factor *L;
+    cholmod_sparse *Cp;
+    int update = 1;
+    char *kwlist[] = {"F", "C", "update", NULL};
+
+    if (!set_options()) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|i", kwlist, &F,
+        &C, &update)) return NULL;
+    if (!(L = get_real_numeric(F, C, -1))) return NULL;
+    if (!SP_NCOLS(C)) return Py_BuildValue("");
+
+    if (!(Cp = permute_rows(C, L))) return PyErr_NoMemory();
+    CHOL(updown)(update != 0, Cp, L, &Common);
+    CHOL(free_sparse)(&Cp, &Common);
+    return updown_status(L);
+}
+
+
+/* Returns the position of k in the permutation of L. */
+static size_t permuted_index(cholmod_factor *L, int k)
+{
+    size_t i;
+    for (i=0; i<L->n && ((int_t *) L->Perm)[i] != k; i++);
+    return i;
+}
+
+static char doc_rowadd[] =
+    "Adds a row and column to a Cholesky factorization.\n\n"
+    "rowadd(F, k, R)\n\n"
+    "PURPOSE\n"
+    "If F is the numeric factorization of a real matrix A in which\n"
+    "row and column k are zero, except for a unit diagonal element\n"
+    "(for example, after a call to cholmod.rowdel), computes the\n"
+    "factorization of the matrix obtained by replacing row and\n"
+    "column k of A with R^T and R.  On exit F contains the new\n"
+    "factorization, in simplicial L*D*L^T form.\n\n"
+    "ARGUMENTS\n"
+    "F         numeric factorization of a 'd' matrix of order n,\n"
+    "          computed by cholmod.numeric\n\n"
+    "k         integer between 0 and n-1, in the original ordering of\n"
+    "          the rows and columns of A\n\n"
+    "R         sparse 'd' matrix of size (n,1)";
+
+static PyObject* rowadd(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    PyObject *F;
+    spmatrix *R;
+    cholmod_factor *L;
+    cholmod_sparse *Rp;
+    int k;
+    char *kwlist[] = {"F", "k", "R", NULL};
+
+    if (!set_options()) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OiO", kwlist, &F,
+        &k, &R)) return NULL;
+    if (!(L = get_real_numeric(F, R, 1))) return NULL;
+    if (k < 0 || (size_t) k >= L->n)
+        PY_ERR(PyExc_IndexError, "index out of range");
+
+    if (!(Rp = permute_rows(R, L))) return PyErr_NoMemory();
+    CHOL(rowadd)(permuted_index(L, k), Rp, L, &Common);
+    CHOL(free_sparse)(&Rp, &Common);
+    return updown_status(L);
+}
+
+
+static char doc_rowdel[] =
+    "Deletes a row and column from a Cholesky factorization.\n\n"
+    "rowdel(F, k)\n\n"
+    "PURPOSE\n"
+    "If F is the numeric factorization of a real matrix A, computes\n"
+    "the factorization of the matrix obtained by replacing row and\n"
+    "column k of A with the kth row and column of the identity.\n"
+    "On exit F contains the new factorization, in simplicial\n"
+    "L*D*L^T form.\n\n"
+    "ARGUMENTS\n"
+    "F         numeric factorization of a 'd' matrix of order n,\n"
+    "          computed by cholmod.numeric\n\n"
+    "k         integer between 0 and n-1, in the original ordering of\n"
+    "          the rows and columns of A";
+
+static PyObject* rowdel(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    PyObject *F;
+    cholmod_factor *L;
+    int k;
+    char *kwlist[] = {"F", "k", NULL};
+
+    if (!set_options()) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "Oi", kwlist, &F, &k))
+        return NULL;
+    if (!(L = get_real_numeric(F, NULL, 0))) return NULL;
+    if (k < 0 || (size_t) k >= L->n)
+        PY_ERR(PyExc_IndexError, "index out of range");
+
+    CHOL(rowdel)(permuted_index(L, k), NULL, L, &Common);
+    return updown_status(L);
+}
+
+
 static PyObject* getfactor(PyObject *self, PyObject *args)
 {
     PyObject *F;
@@ -1084,6 +1541,15 @@ static PyMethodDef cholmod_functions[] = {
   {"splinsolve", (PyCFunction) splinsolve, METH_VARARGS|METH_KEYWORDS,
    doc_splinsolve},
   {"diag", (PyCFunction) diag, METH_VARARGS|METH_KEYWORDS, doc_diag},
+  {"copy", (PyCFunction) copy, METH_VARARGS, doc_copy},
+  {"save", (PyCFunction) save, METH_VARARGS, doc_save},
+  {"load", (PyCFunction) load, METH_VARARGS, doc_load},
+  {"updown", (PyCFunction) updown, METH_VARARGS|METH_KEYWORDS,
+   doc_updown},
+  {"rowadd", (PyCFunction) rowadd, METH_VARARGS|METH_KEYWORDS,
+   doc_rowadd},
+  {"rowdel", (PyCFunction) rowdel, METH_VARARGS|METH_KEYWORDS,
+   doc_rowdel},
   {"getfactor", (PyCFunction) getfactor, METH_VARARGS|METH_KEYWORDS,
    ""},
   {NULL}  /* Sentinel */
@@ -1091,13 +1557,20 @@ static PyMethodDef cholmod_functions[] = {
 
 #if PY_MAJOR_VERSION >= 3
 
+static void cholmod_module_free(void *m)
+{
+    CHOL(free_dense)(&Xws, &Common);
+    CHOL(free_dense)(&Yws, &Common);
+    CHOL(free_dense)(&Ews, &Common);
+}
+
 static PyModuleDef cholmod_module_def = {
     PyModuleDef_HEAD_INIT,
     "cholmod",
     cholmod__doc__,
     -1,
     cholmod_functions,
-    NULL, NULL, NULL, NULL
+    NULL, NULL, NULL, cholmod_module_free
 };
 
 PyMODINIT_FUNC PyInit_cholmod(void)
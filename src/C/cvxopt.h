@@ -114,6 +114,46 @@ import_cvxopt(void)
 
 #endif
 
+/*
+ * Nonlinear functions of solvers.cp() and solvers.cpl() implemented in C.
+ *
+ * The argument F of cp() and cpl() can be a PyCapsule with the name
+ * CVXOPT_NLFUNCTION and a pointer to a cvxopt_nlfunction, instead of a
+ * Python function.  The function
+ *
+ *     int eval(const double *x, const double *z, double *f, double *Df,
+ *         double *H, void *params)
+ *
+ * evaluates the m functions at the point x of length n.  It stores the
+ * function values in f (length m) and their derivatives in Df (an m by n
+ * matrix in column major order).  If z is not NULL, it also stores the
+ * lower triangle of sum_k z[k] * f_k''(x) in H (an n by n matrix in
+ * column major order; the strictly upper triangular entries are
+ * ignored).  H is NULL if z is NULL.  m and n are the number of
+ * functions and variables of cp() or cpl(), i.e., for cp() f_0 is the
+ * objective and z has length m.  The return value is 0 on success, 1 if
+ * x is not in the domain of the functions, and any other value on
+ * failure.
+ *
+ * eval() is called without the global interpreter lock and must not
+ * use the Python C API.  With options['linesearch_threads'] greater
+ * than one, it is called from several OpenMP threads at the same time
+ * and must be thread-safe.  f, Df, H are buffers owned by the solver,
+ * and are overwritten by the next call.  x0 is the starting point
+ * (length n) or NULL for the zero vector.  The capsule must remain valid
+ * while the solver runs.
+ */
+
+#define CVXOPT_NLFUNCTION "cvxopt.nlfunction"
+
+typedef struct {
+  int m, n;              /* number of functions and variables */
+  const double *x0;      /* starting point, or NULL */
+  int (*eval)(const double *x, const double *z, double *f, double *Df,
+      double *H, void *params);
+  void *params;          /* passed to eval() */
+} cvxopt_nlfunction;
+
 /*
  * Below this line are non-essential convenience macros
  */
@@ -32,7 +32,11 @@ PyDoc_STRVAR(dsdp__doc__,"Interface to DSDP version 5.8.\n\n"
     "        progress after every kth iteration (default: 0). \n"
     "    options['DSDP_MaxIts']:  maximum number of iterations\n"
     "    options['DSDP_GapTolerance']: the relative tolerance used\n"
-    "        in the exit condition (default: 1e-5).\n\n"
+    "        in the exit condition (default: 1e-5).\n"
+    "The entry options['cancel'] can be set to an object with a method\n"
+    "cancelled(), e.g., a cvxopt.solvers.CancelToken.  The solver\n"
+    "checks it after each iteration and terminates with status\n"
+    "'DSDP_CANCELLED' when cancelled() returns True.\n\n"
     "DSDSP is available from www-unix.mcs.anl.gov/DSDP.");
 
 static  PyObject *dsdp_module;
@@ -77,8 +81,8 @@ static char doc_dsdp[] =
     "beta      positive double\n\n"
     "gamma     positive double\n\n"
     "status    the DSDP solution status: 'DSDP_PDFEASIBLE', \n"
-    "          'DSDP_UNBOUNDED', 'DSDP_INFEASIBLE', or\n"
-    "          'DSDP_UNKNOWN'.\n\n"
+    "          'DSDP_UNBOUNDED', 'DSDP_INFEASIBLE', 'DSDP_CANCELLED',\n"
+    "          or 'DSDP_UNKNOWN'.\n\n"
     "x         the primal solution, as a dense 'd' matrix of size\n"
     "          n by 1\n\n"
     "r         the optimal value of the variable r\n\n"
@@ -104,6 +108,30 @@ typedef struct {     /* symmetric matrix X in DSDP packed storage */
 
 extern void dcopy_(int *n, double *x, int *incx, double *y, int *incy);
 
+typedef struct {
+    PyObject *cancel;
+    int stop;         /* 1 if cancel.cancelled() returned True, -1 if it
+                       * raised an exception */
+} cancel_info;
+
+/* DSDP monitor that terminates the solver when options['cancel'] is
+ * cancelled. */
+static int cancel_monitor(DSDP sdp, void *info)
+{
+    cancel_info *ci = (cancel_info *) info;
+    PyObject *r;
+
+    if (ci->stop) return 0;
+    if (!(r = PyObject_CallMethod(ci->cancel, "cancelled", NULL)))
+        ci->stop = -1;
+    else {
+        ci->stop = PyObject_IsTrue(r);
+        Py_DECREF(r);
+    }
+    if (ci->stop) DSDPSetConvergenceFlag(sdp, DSDP_USER_TERMINATION);
+    return 0;
+}
+
 static PyObject* solvesdp(PyObject *self, PyObject *args,
     PyObject *kwrds)
 {
@@ -122,6 +150,7 @@ static PyObject* solvesdp(PyObject *self, PyObject *args,
     SDPCone sdpcone;
     DSDPTerminationReason info;
     DSDPSolutionType status;
+    cancel_info ci = {NULL, 0};
     char err_str[100];
 #if PY_MAJOR_VERSION >= 3
     const char *keystr;
@@ -203,7 +232,7 @@ static PyObject* solvesdp(PyObject *self, PyObject *args,
                         "DSDP parameter: DSDP_Monitor");
                     PyErr_SetString(PyExc_ValueError, err_str);
                     t = NULL;
-                    Py_DECREF(param);
+                    if (param != opts) Py_DECREF(param);
                     goto done;
                 }
 #if PY_MAJOR_VERSION >= 3
@@ -222,7 +251,7 @@ static PyObject* solvesdp(PyObject *self, PyObject *args,
                         "integer DSDP parameter: DSDP_MaxIts");
                     PyErr_SetString(PyExc_ValueError, err_str);
                     t = NULL;
-                    Py_DECREF(param);
+                    if (param != opts) Py_DECREF(param);
                     goto done;
                 }
 		else DSDPSetMaxIts(sdp, k);
@@ -238,13 +267,18 @@ static PyObject* solvesdp(PyObject *self, PyObject *args,
                         "DSDP parameter: DSDP_GapTolerance");
                     PyErr_SetString(PyExc_ValueError, err_str);
                     t = NULL;
-                    Py_DECREF(param);
+                    if (param != opts) Py_DECREF(param);
                     goto done;
                 }
                 else DSDPSetGapTolerance(sdp, tol);
             }
+            if (!strcmp(keystr, "cancel") && value != Py_None){
+                Py_INCREF(value);
+                ci.cancel = value;
+            }
         }
-    Py_DECREF(param);
+    if (param != opts) Py_DECREF(param);
+    if (ci.cancel) DSDPSetMonitor(sdp, cancel_monitor, (void *) &ci);
 
     if (gamma > 0) DSDPSetPenaltyParameter(sdp, gamma);
     if (beta > 0) DSDPSetYBounds(sdp, -beta, beta);
@@ -383,14 +417,20 @@ static PyObject* solvesdp(PyObject *self, PyObject *args,
 
     DSDPSetup(sdp);
     if (DSDPSolve(sdp)){
-        PyErr_SetString(PyExc_ArithmeticError, "DSDP error");
+        if (ci.stop >= 0)
+            PyErr_SetString(PyExc_ArithmeticError, "DSDP error");
+        t = NULL;
+        goto done;
+    }
+    if (ci.stop < 0){
         t = NULL;
         goto done;
     }
     DSDPStopReason(sdp, &info);
     if (info != DSDP_CONVERGED && info != DSDP_SMALL_STEPS &&
         info != DSDP_INDEFINITE_SCHUR_MATRIX && info != DSDP_MAX_IT
-        && info != DSDP_NUMERICAL_ERROR && info != DSDP_UPPERBOUND ){
+        && info != DSDP_NUMERICAL_ERROR && info != DSDP_UPPERBOUND &&
+        info != DSDP_USER_TERMINATION){
         PyErr_SetObject(PyExc_ArithmeticError, Py_BuildValue("i",info));
         t = NULL;
         goto done;
@@ -437,6 +477,12 @@ static PyObject* solvesdp(PyObject *self, PyObject *args,
 #endif
                 break;
         }
+    } else if (info == DSDP_USER_TERMINATION) {
+#if PY_MAJOR_VERSION >= 3
+        PyTuple_SET_ITEM(t, 0, (PyObject *)PyUnicode_FromString("DSDP_CANCELLED"));
+#else
+        PyTuple_SET_ITEM(t, 0, (PyObject *)PyString_FromString("DSDP_CANCELLED"));
+#endif
     } else {
 #if PY_MAJOR_VERSION >= 3
         PyTuple_SET_ITEM(t, 0, (PyObject *)PyUnicode_FromString("DSDP_UNKNOWN"));
@@ -476,6 +522,7 @@ static PyObject* solvesdp(PyObject *self, PyObject *args,
 
     done:
         free(lp_colptr);  free(lp_rowind);  free(lp_values);  free(zk);
+        Py_XDECREF(ci.cancel);
         DSDPDestroy(sdp);
         if (lmis) for (k=0; k<l; k++){
             if (lmis[k]) for (i=0; i<n+1; i++){
@@ -24,6 +24,7 @@
 #include <glpk.h>
 #include <float.h>
 #include <limits.h>
+#include <time.h>
 
 PyDoc_STRVAR(glpk__doc__,
     "Interface to the simplex and mixed integer LP algorithms in GLPK.\n\n"
@@ -34,7 +35,11 @@ PyDoc_STRVAR(glpk__doc__,
     "For example, glpk.options['msg_lev'] = 'GLP_MSG_OFF' turns off the \n"
     "printed output will be turned off during execution of glpk.lp().\n"
     "Setting glpk.options['it_lim'] = 10 sets the simplex iteration \n"
-    "limit to 10.  Unrecognized entries in glpk.options are ignored.");
+    "limit to 10.  Unrecognized entries in glpk.options are ignored.\n\n"
+    "The entry glpk.options['cancel'] is not a GLPK parameter.  If it \n"
+    "is set to an object with a method cancelled(), e.g., a \n"
+    "cvxopt.solvers.CancelToken, the solvers terminate with status \n"
+    "'cancelled' when cancelled() returns True.");
 
 static PyObject *glpk_module;
 
@@ -52,6 +57,38 @@ static PyObject *glpk_module;
 #define PYSTRING_COMPARE(a,b) strcmp(PyString_AsString(a), b)
 #endif
 
+/* Number of simplex iterations between two checks of the cancellation
+ * token. */
+#define CANCEL_ITERS 100
+
+/* Returns 1 if cancel is not NULL and cancel.cancelled() is true, 0 if
+ * it is false, and -1 if the call raises an exception. */
+static int cancelled(PyObject *cancel)
+{
+    PyObject *r;
+    int val;
+
+    if (!cancel) return 0;
+    if (!(r = PyObject_CallMethod(cancel, "cancelled", NULL))) return -1;
+    val = PyObject_IsTrue(r);
+    Py_DECREF(r);
+    return val;
+}
+
+typedef struct {
+    PyObject *cancel;
+    int stop;         /* return value of cancelled() */
+} cancel_info;
+
+/* Callback for glp_intopt(). */
+static void cancel_callback(glp_tree *tree, void *info)
+{
+    cancel_info *ci = (cancel_info *) info;
+
+    if (ci->stop) return;
+    if ((ci->stop = cancelled(ci->cancel))) glp_ios_terminate(tree);
+}
+
 
 static char doc_simplex[] =
     "Solves a linear program using GLPK.\n\n"
@@ -74,8 +111,10 @@ static char doc_simplex[] =
     "h            mx1 dense 'd' matrix\n\n"
     "A            pxn dense or sparse 'd' matrix with p>=0\n\n"
     "b            px1 dense 'd' matrix\n\n"
-    "status       'optimal', 'primal infeasible', 'dual infeasible' \n"
-    "             or 'unknown'\n\n"
+    "status       'optimal', 'primal infeasible', 'dual infeasible', \n"
+    "             'time limit' (glpk.options['tm_lim'] was reached), \n"
+    "             'cancelled' (see glpk.options['cancel']), or \n"
+    "             'unknown'\n\n"
     "x            if status is 'optimal', a primal optimal solution;\n"
     "             None otherwise\n\n"
     "z,y          if status is 'optimal', the dual optimal solution;\n"
@@ -85,10 +124,13 @@ static char doc_simplex[] =
 static PyObject *simplex(PyObject *self, PyObject *args, PyObject *kwrds)
 {
     matrix *c, *h, *b=NULL, *x=NULL, *z=NULL, *y=NULL;
-    PyObject *G, *A=NULL, *t=NULL, *param, *key, *value, *opts=NULL;
+    PyObject *G, *A=NULL, *t=NULL, *param, *key, *value, *opts=NULL,
+        *cancel=NULL;
     glp_prob *lp;
     glp_smcp smcp;
-    int m, n, p, i, j, k, nnz, nnzmax, *rn=NULL, *cn=NULL;
+    int m, n, p, i, j, k, nnz, nnzmax, *rn=NULL, *cn=NULL, info, stop,
+        it_lim, tm_lim;
+    time_t t0;
     int_t pos=0;
     double *a=NULL, val;
     char *kwlist[] = {"c", "G", "h", "A", "b", "options", NULL};
@@ -353,12 +395,53 @@ static PyObject *simplex(PyObject *self, PyObject *args, PyObject *kwrds)
                     PyErr_WarnEx(NULL, "replacing "
                         "glpk.options['presolve'] with default value", 1);
             }
+            else if (!PYSTRING_COMPARE(key, "cancel"))
+                cancel = (value == Py_None) ? NULL : value;
         }
 
+    if (cancel) Py_INCREF(cancel);
     if (param != opts)
         Py_DECREF(param);
 
-    switch (glp_simplex(lp, &smcp)){
+    /* With a cancellation token and without the presolver, the simplex
+     * method is run in blocks of at most CANCEL_ITERS iterations, each
+     * starting from the final basis of the previous block, and the token
+     * is checked between the blocks.  The iteration and time limits
+     * apply to the total. */
+    info = 0;
+    if (!(stop = cancelled(cancel))) {
+        if (cancel && smcp.presolve == GLP_OFF){
+            it_lim = smcp.it_lim;
+            tm_lim = smcp.tm_lim;
+            t0 = time(NULL);
+            while (1) {
+                smcp.it_lim = MIN(it_lim, CANCEL_ITERS);
+                info = glp_simplex(lp, &smcp);
+                if (info != GLP_EITLIM || it_lim <= CANCEL_ITERS) break;
+                if (it_lim < INT_MAX) it_lim -= CANCEL_ITERS;
+                if ((stop = cancelled(cancel))) break;
+                if (tm_lim < INT_MAX){
+                    smcp.tm_lim = tm_lim - (int) (1000.0 *
+                        difftime(time(NULL), t0));
+                    if (smcp.tm_lim <= 0) {
+                        info = GLP_ETMLIM;
+                        break;
+                    }
+                }
+            }
+        }
+        else
+            info = glp_simplex(lp, &smcp);
+    }
+    Py_XDECREF(cancel);
+    if (stop < 0){
+        Py_DECREF(t);
+        glp_delete_prob(lp);
+        return NULL;
+    }
+    if (stop) info = GLP_ESTOP;
+
+    switch (info){
 
         case 0:
             switch(glp_get_status(lp)){
@@ -421,6 +504,16 @@ static PyObject *simplex(PyObject *self, PyObject *args, PyObject *kwrds)
                 PYSTRING_FROMSTRING("dual infeasible"));
             break;
 
+        case GLP_ETMLIM:
+            PyTuple_SET_ITEM(t, 0, (PyObject *)
+                PYSTRING_FROMSTRING("time limit"));
+            break;
+
+        case GLP_ESTOP:
+            PyTuple_SET_ITEM(t, 0, (PyObject *)
+                PYSTRING_FROMSTRING("cancelled"));
+            break;
+
         default:
             PyTuple_SET_ITEM(t, 0, (PyObject *)
                 PYSTRING_FROMSTRING("unknown"));
@@ -456,7 +549,12 @@ static char doc_integer[] =
     "B            set of indices of binary variables\n\n"
     "status       if status is 'optimal', 'feasible', or 'undefined',\n"
     "             a value of x is returned and the status string \n"
-    "             gives the status of x.  Other possible values of "
+    "             gives the status of x.  If the solver terminates \n"
+    "             because glpk.options['tm_lim'] was reached or \n"
+    "             glpk.options['cancel'] was cancelled, the status is \n"
+    "             'time limit' or 'cancelled', and x is the best \n"
+    "             integer feasible point found, or None if there is \n"
+    "             none.  Other possible values of "
     "             status are:  'invalid formulation', \n"
     "             'infeasible problem', 'LP relaxation is primal \n"
     "             infeasible', 'LP relaxation is dual infeasible', \n"
@@ -472,6 +570,7 @@ static PyObject *integer(PyObject *self, PyObject *args,
     PyObject *t=NULL, *param, *key, *value, *opts=NULL;
     glp_prob *lp;
     glp_iocp iocp;
+    cancel_info ci = {NULL, 0};
     int m, n, p, i, j, k, nnz, nnzmax, *rn=NULL, *cn=NULL, info, status;
     int_t pos=0;
     double *a=NULL, val;
@@ -839,6 +938,9 @@ static PyObject *integer(PyObject *self, PyObject *args,
                 else
                     PyErr_WarnEx(NULL, "replacing "
                         "glpk.options['presolve'] with GLP_ON", 1);
+            else if (!PYSTRING_COMPARE(key, "cancel")) {
+                if (value != Py_None) ci.cancel = value;
+            }
             else if (!PYSTRING_COMPARE(key, "binarize")) {
                 if (PYSTRING_CHECK(value)) {
                     if (!PYSTRING_COMPARE(value, "GLP_ON"))
@@ -904,7 +1006,23 @@ static PyObject *integer(PyObject *self, PyObject *args,
         Py_DECREF(iter);
     }
 
-    info = glp_intopt(lp, &iocp);
+    /* The cancellation token is checked by the callback function of the
+     * branch-and-cut algorithm. */
+    if (ci.cancel){
+        Py_INCREF(ci.cancel);
+        iocp.cb_func = cancel_callback;
+        iocp.cb_info = &ci;
+    }
+    if (!(ci.stop = cancelled(ci.cancel)))
+        info = glp_intopt(lp, &iocp);
+    else
+        info = GLP_ESTOP;
+    Py_XDECREF(ci.cancel);
+    if (ci.stop < 0){
+        Py_DECREF(t);
+        glp_delete_prob(lp);
+        return NULL;
+    }
     status = glp_mip_status(lp);
 
     switch (info){
@@ -912,6 +1030,24 @@ static PyObject *integer(PyObject *self, PyObject *args,
         case 0:
         case GLP_EMIPGAP:
         case GLP_ETMLIM:
+        case GLP_ESTOP:
+            /* Time limit or cancellation before optimality: x is the best
+             * integer feasible point, if one was found. */
+            if (info != 0 && info != GLP_EMIPGAP && status != GLP_OPT){
+                PyTuple_SET_ITEM(t, 0, (PyObject *) PYSTRING_FROMSTRING(
+                    info == GLP_ETMLIM ? "time limit" : "cancelled"));
+                if (status != GLP_FEAS) break;
+                if (!(x = (matrix *) Matrix_New(n,1,DOUBLE))) {
+                    Py_XDECREF(t);
+                    glp_delete_prob(lp);
+                    return NULL;
+                }
+                for (i=0; i<n; i++)
+                    MAT_BUFD(x)[i] = glp_mip_col_val(lp, i+1);
+                PyTuple_SET_ITEM(t, 1, (PyObject *) x);
+                glp_delete_prob(lp);
+                return (PyObject *) t;
+            }
             switch(status){
                 case GLP_OPT:     /* x is optimal */
                 case GLP_FEAS:    /* x is integer feasible */
@@ -978,7 +1114,6 @@ static PyObject *integer(PyObject *self, PyObject *args,
             break;
 
         case GLP_EROOT: /* only occurs if presolver is off */
-        case GLP_ESTOP: /* only occurs when advanced interface is used */
         default:
             PyTuple_SET_ITEM(t, 0, (PyObject *)
                 PYSTRING_FROMSTRING("unknown"));
@@ -22,6 +22,7 @@
 #include "Python.h"
 #include "cvxopt.h"
 #include "misc.h"
+#include <float.h>
 
 #ifndef _MSC_VER
 typedef complex double complex_t;
@@ -170,6 +171,14 @@ extern void zsytrs_(char *uplo, int *n, int *nrhs, complex_t *A,
     int *lda, int *ipiv, complex_t *B, int *ldb, int *info);
 extern void zhetrs_(char *uplo, int *n, int *nrhs, complex_t *A, 
     int *lda, int *ipiv, complex_t *B, int *ldb, int *info);
+
+extern void spotrf_(char *uplo, int *n, float *A, int *lda, int *info);
+extern void spotrs_(char *uplo, int *n, int *nrhs, float *A, int *lda,
+    float *B, int *ldB, int *info);
+extern void ssytrf_(char *uplo, int *n, float *A, int *lda, int *ipiv,
+    float *work, int *lwork, int *info);
+extern void ssytrs_(char *uplo, int *n, int *nrhs, float *A, int *lda,
+    int *ipiv, float *B, int *ldb, int *info);
 extern void dsytri_(char *uplo, int *n, double *A, int *lda, int *ipiv,
     double *work, int *info);
 extern void zsytri_(char *uplo, int *n, complex_t *A, int *lda, 
@@ -7335,6 +7344,326 @@ static PyObject* larfx(PyObject *self, PyObject *args, PyObject *kwrds)
     return Py_BuildValue("");
 }
 
+/*
+ * Single precision factorizations of double precision matrices.
+ *
+ * The factors are stored in an sfactor struct, returned to Python as an
+ * opaque C object with descriptor "LAPACK SYTRF S FACTOR" or
+ * "LAPACK POTRF S FACTOR".
+ */
+
+typedef struct {
+    int n;
+    char uplo;
+    int *ipiv;
+    float *A;
+} sfactor;
+
+static void free_sfactor_ptr(sfactor *F)
+{
+    free(F->A);
+    free(F->ipiv);
+    free(F);
+}
+
+#if PY_MAJOR_VERSION >= 3
+static void free_sfactor(void *F)
+{
+    free_sfactor_ptr((sfactor *) PyCapsule_GetPointer(F,
+        PyCapsule_GetName(F)));
+}
+#else
+static void free_sfactor(void *F, void *descr)
+{
+    free_sfactor_ptr((sfactor *) F);
+}
+#endif
+
+
+/*
+ * Parses the arguments of ssytrf() and spotrf() and returns a new
+ * sfactor with the triangle uplo of A rounded to single precision.
+ */
+static sfactor* sfactor_from_args(PyObject *args, PyObject *kwrds,
+    int pivots)
+{
+    matrix *A;
+    sfactor *F;
+    double a;
+    int n=-1, ldA=0, oA=0, i, j;
+#if PY_MAJOR_VERSION >= 3
+    int uplo_ = 'L';
+#endif
+    char uplo = 'L';
+    char *kwlist[] = {"A", "uplo", "n", "ldA", "offsetA", NULL};
+
+#if PY_MAJOR_VERSION >= 3
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|Ciii", kwlist, &A,
+        &uplo_, &n, &ldA, &oA)) return NULL;
+    uplo = (char) uplo_;
+#else
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|ciii", kwlist, &A,
+        &uplo, &n, &ldA, &oA)) return NULL;
+#endif
+
+    if (!Matrix_Check(A) || MAT_ID(A) != DOUBLE) err_dbl_mtrx("A");
+    if (n < 0){
+        n = A->nrows;
+        if (n != A->ncols){
+            PyErr_SetString(PyExc_TypeError, "A must be square");
+            return NULL;
+        }
+    }
+    if (uplo != 'L' && uplo != 'U') err_char("uplo", "'L', 'U'");
+    if (ldA == 0) ldA = MAX(1,A->nrows);
+    if (ldA < MAX(1,n)) err_ld("ldA");
+    if (oA < 0) err_nn_int("offsetA");
+    if (n && oA + (n-1)*ldA + n > len(A)) err_buf_len("A");
+
+    if (!(F = (sfactor *) calloc(1, sizeof(sfactor))))
+        return (sfactor *) PyErr_NoMemory();
+    F->n = n;
+    F->uplo = uplo;
+    F->A = (float *) malloc(MAX(1,(size_t) n*n) * sizeof(float));
+    if (pivots) F->ipiv = (int *) malloc(MAX(1,n) * sizeof(int));
+    if (!F->A || (pivots && !F->ipiv)){
+        free_sfactor_ptr(F);
+        return (sfactor *) PyErr_NoMemory();
+    }
+
+    for (j=0; j<n; j++){
+        for (i = (uplo == 'L') ? j : 0; i < ((uplo == 'L') ? n : j+1); i++){
+            a = MAT_BUFD(A)[oA + j*ldA + i];
+            if (a > FLT_MAX || a < -FLT_MAX){
+                free_sfactor_ptr(F);
+                PY_ERR(PyExc_OverflowError, "A cannot be represented in "
+                    "single precision");
+            }
+            F->A[(size_t) j*n + i] = (float) a;
+        }
+    }
+    return F;
+}
+
+
+/*
+ * Solves A*X = B in single precision with the factor F of A.  B is a
+ * 'd' matrix and is overwritten with the solution.  Raises an
+ * OverflowError, and leaves B unchanged, if B cannot be rounded to
+ * single precision.
+ */
+static PyObject* sfactor_solve(PyObject *args, PyObject *kwrds,
+    const char *name, int pivots)
+{
+    PyObject *F;
+    matrix *B;
+    sfactor *Fs;
+    float *X;
+    double b;
+    int nrhs=-1, ldB=0, oB=0, n, i, j, info;
+    char *kwlist[] = {"F", "B", "nrhs", "ldB", "offsetB", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|iii", kwlist,
+        &F, &B, &nrhs, &ldB, &oB)) return NULL;
+
+#if PY_MAJOR_VERSION >= 3
+    TypeCheck_Capsule(F, name, pivots ? "F is not a factor computed by "
+        "ssytrf()" : "F is not a factor computed by spotrf()");
+    Fs = (sfactor *) PyCapsule_GetPointer(F, name);
+#else
+    if (!PyCObject_Check(F)) err_CO("F");
+    TypeCheck_CObject(F, name, pivots ? "F is not a factor computed by "
+        "ssytrf()" : "F is not a factor computed by spotrf()");
+    Fs = (sfactor *) PyCObject_AsVoidPtr(F);
+#endif
+
+    if (!Matrix_Check(B) || MAT_ID(B) != DOUBLE) err_dbl_mtrx("B");
+    n = Fs->n;
+    if (nrhs < 0) nrhs = B->ncols;
+    if (n == 0 || nrhs == 0) return Py_BuildValue("");
+    if (ldB == 0) ldB = MAX(1,B->nrows);
+    if (ldB < MAX(1,n)) err_ld("ldB");
+    if (oB < 0) err_nn_int("offsetB");
+    if (oB + (nrhs-1)*ldB + n > len(B)) err_buf_len("B");
+
+    if (!(X = (float *) malloc((size_t) n*nrhs*sizeof(float))))
+        return PyErr_NoMemory();
+    for (j=0; j<nrhs; j++){
+        for (i=0; i<n; i++){
+            b = MAT_BUFD(B)[oB + j*ldB + i];
+            if (b > FLT_MAX || b < -FLT_MAX){
+                free(X);
+                PY_ERR(PyExc_OverflowError, "B cannot be represented in "
+                    "single precision");
+            }
+            X[(size_t) j*n + i] = (float) b;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    if (pivots)
+        ssytrs_(&Fs->uplo, &n, &nrhs, Fs->A, &n, Fs->ipiv, X, &n, &info);
+    else
+        spotrs_(&Fs->uplo, &n, &nrhs, Fs->A, &n, X, &n, &info);
+    Py_END_ALLOW_THREADS
+
+    for (j=0; j<nrhs; j++)
+        for (i=0; i<n; i++)
+            MAT_BUFD(B)[oB + j*ldB + i] = (double) X[(size_t) j*n + i];
+    free(X);
+
+    if (info) err_lapack
+    else return Py_BuildValue("");
+}
+
+
+static PyObject* sfactor_new(sfactor *F, const char *descr)
+{
+#if PY_MAJOR_VERSION >= 3
+    return (PyObject *) PyCapsule_New((void *) F, descr,
+        (PyCapsule_Destructor) &free_sfactor);
+#else
+    return (PyObject *) PyCObject_FromVoidPtrAndDesc((void *) F,
+        (void *) descr, free_sfactor);
+#endif
+}
+
+
+static char doc_spotrf[] =
+    "Cholesky factorization of a real symmetric positive definite\n"
+    "matrix in single precision.\n\n"
+    "F = spotrf(A, uplo='L', n=A.size[0], ldA=max(1,A.size[0]),\n"
+    "           offsetA=0)\n\n"
+    "PURPOSE\n"
+    "Rounds the n by n matrix A to single precision and factors it as\n"
+    "A = L*L^T.  A is not modified.\n\n"
+    "ARGUMENTS\n"
+    "A         'd' matrix\n\n"
+    "uplo      'L' or 'U'\n\n"
+    "n         nonnegative integer.  If negative, the default value is\n"
+    "          used.\n\n"
+    "ldA       positive integer.  ldA >= max(1,n).  If zero, the default\n"
+    "          value is used.\n\n"
+    "offsetA   nonnegative integer\n\n"
+    "F         the factorization as an opaque C object that can be\n"
+    "          passed to spotrs()";
+
+static PyObject* spotrf(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    sfactor *F;
+    int info = 0;
+
+    if (!(F = sfactor_from_args(args, kwrds, 0))) return NULL;
+    if (F->n){
+        Py_BEGIN_ALLOW_THREADS
+        spotrf_(&F->uplo, &F->n, F->A, &F->n, &info);
+        Py_END_ALLOW_THREADS
+    }
+    if (info){
+        free_sfactor_ptr(F);
+        err_lapack
+    }
+    return sfactor_new(F, "LAPACK POTRF S FACTOR");
+}
+
+
+static char doc_spotrs[] =
+    "Solves a real symmetric positive definite set of linear equations\n"
+    "in single precision, given the factorization computed by\n"
+    "spotrf().\n\n"
+    "spotrs(F, B, nrhs=B.size[1], ldB=max(1,B.size[0]), offsetB=0)\n\n"
+    "PURPOSE\n"
+    "Solves A*X = B where A is n by n and B is n by nrhs.  B is rounded\n"
+    "to single precision, and on exit it is replaced by the solution.\n"
+    "Raises an OverflowError if an entry of B is larger than the\n"
+    "largest single precision number.\n\n"
+    "ARGUMENTS\n"
+    "F         the factorization of A computed by spotrf()\n\n"
+    "B         'd' matrix\n\n"
+    "nrhs      nonnegative integer.  If negative, the default value is\n"
+    "          used.\n\n"
+    "ldB       positive integer.  ldB >= max(1,n).  If zero, the default\n"
+    "          value is used.\n\n"
+    "offsetB   nonnegative integer";
+
+static PyObject* spotrs(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    return sfactor_solve(args, kwrds, "LAPACK POTRF S FACTOR", 0);
+}
+
+
+static char doc_ssytrf[] =
+    "LDL^T factorization of a real symmetric matrix in single\n"
+    "precision.\n\n"
+    "F = ssytrf(A, uplo='L', n=A.size[0], ldA=max(1,A.size[0]),\n"
+    "           offsetA=0)\n\n"
+    "PURPOSE\n"
+    "Rounds the n by n matrix A to single precision and computes its\n"
+    "LDL^T factorization.  A is not modified.\n\n"
+    "ARGUMENTS\n"
+    "A         'd' matrix\n\n"
+    "uplo      'L' or 'U'\n\n"
+    "n         nonnegative integer.  If negative, the default value is\n"
+    "          used.\n\n"
+    "ldA       positive integer.  ldA >= max(1,n).  If zero, the default\n"
+    "          value is used.\n\n"
+    "offsetA   nonnegative integer\n\n"
+    "F         the factorization as an opaque C object that can be\n"
+    "          passed to ssytrs()";
+
+static PyObject* ssytrf(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    sfactor *F;
+    float *work, wl;
+    int lwork = -1, info = 0;
+
+    if (!(F = sfactor_from_args(args, kwrds, 1))) return NULL;
+    if (F->n){
+        Py_BEGIN_ALLOW_THREADS
+        ssytrf_(&F->uplo, &F->n, NULL, &F->n, NULL, &wl, &lwork, &info);
+        Py_END_ALLOW_THREADS
+        lwork = MAX(1, (int) wl);
+        if (!(work = (float *) calloc(lwork, sizeof(float)))){
+            free_sfactor_ptr(F);
+            return PyErr_NoMemory();
+        }
+        Py_BEGIN_ALLOW_THREADS
+        ssytrf_(&F->uplo, &F->n, F->A, &F->n, F->ipiv, work, &lwork,
+            &info);
+        Py_END_ALLOW_THREADS
+        free(work);
+    }
+    if (info){
+        free_sfactor_ptr(F);
+        err_lapack
+    }
+    return sfactor_new(F, "LAPACK SYTRF S FACTOR");
+}
+
+
+static char doc_ssytrs[] =
+    "Solves a real symmetric set of linear equations in single\n"
+    "precision, given the LDL^T factorization computed by ssytrf().\n\n"
+    "ssytrs(F, B, nrhs=B.size[1], ldB=max(1,B.size[0]), offsetB=0)\n\n"
+    "PURPOSE\n"
+    "Solves A*X = B where A is n by n and B is n by nrhs.  B is rounded\n"
+    "to single precision, and on exit it is replaced by the solution.\n"
+    "Raises an OverflowError if an entry of B is larger than the\n"
+    "largest single precision number.\n\n"
+    "ARGUMENTS\n"
+    "F         the factorization of A computed by ssytrf()\n\n"
+    "B         'd' matrix\n\n"
+    "nrhs      nonnegative integer.  If negative, the default value is\n"
+    "          used.\n\n"
+    "ldB       positive integer.  ldB >= max(1,n).  If zero, the default\n"
+    "          value is used.\n\n"
+    "offsetB   nonnegative integer";
+
+static PyObject* ssytrs(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    return sfactor_solve(args, kwrds, "LAPACK SYTRF S FACTOR", 1);
+}
+
 
 
 static PyMethodDef lapack_functions[] = {
@@ -7398,6 +7727,10 @@ static PyMethodDef lapack_functions[] = {
 {"geqp3", (PyCFunction) geqp3, METH_VARARGS|METH_KEYWORDS, doc_geqp3},
 {"larfg", (PyCFunction) larfg, METH_VARARGS|METH_KEYWORDS, doc_larfg},
 {"larfx", (PyCFunction) larfx, METH_VARARGS|METH_KEYWORDS, doc_larfx},
+{"spotrf", (PyCFunction) spotrf, METH_VARARGS|METH_KEYWORDS, doc_spotrf},
+{"spotrs", (PyCFunction) spotrs, METH_VARARGS|METH_KEYWORDS, doc_spotrs},
+{"ssytrf", (PyCFunction) ssytrf, METH_VARARGS|METH_KEYWORDS, doc_ssytrf},
+{"ssytrs", (PyCFunction) ssytrs, METH_VARARGS|METH_KEYWORDS, doc_ssytrs},
 {NULL}  /* Sentinel */
 };
 
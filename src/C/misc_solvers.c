@@ -24,6 +24,9 @@
 #include "misc.h"
 #include "math.h"
 #include "float.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 PyDoc_STRVAR(misc_solvers__doc__, "Miscellaneous functions used by the "
     "CVXOPT solvers.");
@@ -57,11 +60,545 @@ extern void dsyevr_(char *jobz, char *range, char *uplo, int *n, double *A,
 extern void dsyevd_(char *jobz, char *uplo, int *n, double *A, int *ldA,
     double *W, double *work, int *lwork, int *iwork, int *liwork,
     int *info);
+extern void dstev_(char *jobz, int *n, double *d, double *e, double *Z,
+    int *ldZ, double *work, int *info);
+extern void dsymv_(char *uplo, int *n, double *alpha, double *A, int *lda,
+    double *x, int *incx, double *beta, double *y, int *incy);
+extern void dsyrk_(char *uplo, char *trans, int *n, int *k, double *alpha,
+    double *A, int *lda, double *beta, double *C, int *ldc);
+extern void dsytrf_(char *uplo, int *n, double *A, int *lda, int *ipiv,
+    double *work, int *lwork, int *info);
+extern void dsytrs_(char *uplo, int *n, int *nrhs, double *A, int *lda,
+    int *ipiv, double *B, int *ldb, int *info);
+extern void dgemm_(char *transa, char *transb, int *m, int *n, int *k,
+    double *alpha, double *A, int *lda, double *B, int *ldb, double *beta,
+    double *C, int *ldc);
+extern void dtrsm_(char *side, char *uplo, char *transa, char *diag,
+    int *m, int *n, double *alpha, double *A, int *lda, double *B,
+    int *ldb);
+extern void dpotrf_(char *uplo, int *n, double *A, int *lda, int *info);
+extern void dgesvd_(char *jobu, char *jobvt, int *m, int *n, double *A,
+    int *ldA, double *S, double *U, int *ldU, double *Vt, int *ldVt,
+    double *work, int *lwork, int *info);
+
+
+#ifdef _OPENMP
+#define MAX_THREADS omp_get_max_threads()
+#define THREAD_NUM omp_get_thread_num()
+#else
+#define MAX_THREADS 1
+#define THREAD_NUM 0
+#endif
+
+/*
+ * Blocks of order at most SMALL_BLOCK are processed with inline loops
+ * instead of BLAS calls.  The loop over the 'q' or 's' blocks of a
+ * vector is executed in parallel only if there is more than one block
+ * and some block is larger than SMALL_BLOCK.
+ */
+#define SMALL_BLOCK 4
+#define PARALLEL_BLOCKS(n, maxn) ((n) > 1 && (maxn) > SMALL_BLOCK)
+
+/*
+ * A 'q' or 's' block of a vector in S.  m is the order of the cone.
+ * ind is the offset of the block in vectors that store the 's' blocks
+ * by their diagonals (like lmbda), and ind2 the offset in vectors in
+ * unpacked storage (like s and z).  For the scaling W, v and beta, or r
+ * and rti, are the entries of W for the block, lwork is the workspace
+ * size for dgesvd and info the LAPACK error code.
+ */
+typedef struct {
+    int m, ind, ind2, lwork, info;
+    double beta, *v, *r, *rti;
+} ntblock;
+
+/*
+ * Returns the blocks of dims[key] ('q' or 's') as an array of n ntblocks,
+ * with offsets starting at *ind and *ind2.  On exit, *ind and *ind2 are
+ * the offsets of the end of the last block and maxn is the largest
+ * block size.  Returns NULL if there is not enough memory.
+ */
+static ntblock* dims_blocks(PyObject *dims, char *key, int *ind,
+    int *ind2, int *n, int *maxn)
+{
+    PyObject *O = PyDict_GetItemString(dims, key);
+    ntblock *b;
+    int k, m;
+
+    *n = (int) PyList_Size(O);
+    *maxn = 0;
+    if (!(b = (ntblock *) calloc(MAX(1, *n), sizeof(ntblock)))) return NULL;
+    for (k = 0; k < *n; k++){
+#if PY_MAJOR_VERSION >= 3
+        m = (int) PyLong_AsLong(PyList_GetItem(O, (Py_ssize_t) k));
+#else
+        m = (int) PyInt_AsLong(PyList_GetItem(O, (Py_ssize_t) k));
+#endif
+        b[k].m = m;
+        b[k].ind = *ind;
+        b[k].ind2 = *ind2;
+        *ind += m;
+        *ind2 += (key[0] == 's') ? m*m : m;
+        *maxn = MAX(*maxn, m);
+    }
+    return b;
+}
+
+/*
+ * Maximum number of Lanczos steps, and relative tolerance on the
+ * residual of the Ritz pair, in max_step().
+ */
+#define LANCZOS_MAXIT 100
+#define LANCZOS_TOL 1e-8
+
+/*
+ * Length of the workspace of lanczos_min() for a matrix of order n.
+ */
+#define LANCZOS_LWORK(n, maxit) ((n)*((maxit)+1) + (maxit)*((maxit)+7) + 1)
+
+/*
+ * Workspace of scale() and max_step(), created by workspace() and
+ * reused in every iteration of the solvers.  The buffers for 's' blocks
+ * of order at most n are allocated for the computations selected by
+ * flags:
+ *
+ * - WS_EIG: the smallest eigenvalue by dsyevr (Q, w, lwork, liwork).
+ * - WS_SIGMA: all eigenvalues and eigenvectors by dsyevd (lworkd,
+ *   liworkd).
+ * - WS_LANCZOS: the Lanczos method (lwrk, v0), with the dsyevr
+ *   workspace sized for an eigenvector.  Implies WS_EIG.
+ *
+ * scale holds lscale doubles and is enlarged when needed.
+ */
+#define WS_EIG 1
+#define WS_SIGMA 2
+#define WS_LANCZOS 4
+#define WS_ALL (WS_EIG | WS_SIGMA | WS_LANCZOS)
+
+typedef struct {
+    int n, flags, lwork, liwork, lworkd, liworkd, lscale;
+    double *Q, *w, *work, *workd, *lwrk, *v0, *scale;
+    int *iwork, *iworkd;
+} wspace;
+
+#define WSPACE_NAME "MISC_SOLVERS WORKSPACE"
+
+/*
+ * Frees the buffers of ws for 's' blocks and sets ws->n and ws->flags
+ * to zero.
+ */
+static void ws_clear(wspace *ws)
+{
+    free(ws->Q);  free(ws->w);  free(ws->work);  free(ws->iwork);
+    free(ws->workd);  free(ws->iworkd);  free(ws->lwrk);  free(ws->v0);
+    ws->Q = ws->w = ws->work = ws->workd = ws->lwrk = ws->v0 = NULL;
+    ws->iwork = ws->iworkd = NULL;
+    ws->n = ws->flags = 0;
+}
+
+/*
+ * Sizes the buffers of ws selected by flags for 's' blocks of order at
+ * most n.  Only the LAPACK workspace queries for the selected routines
+ * are made.  Returns -1 if there is not enough memory.
+ */
+static int ws_init(wspace *ws, int n, int flags)
+{
+    int int1 = 1, lwork = -1, liwork = -1, iwl, m, info, ld = MAX(1, n),
+        isuppz[2], llwrk = LANCZOS_LWORK(n, MIN(n, LANCZOS_MAXIT));
+    double dbl0 = 0.0, wl;
+
+    ws_clear(ws);
+    if (flags & WS_LANCZOS) flags |= WS_EIG;
+    if (flags & WS_EIG){
+        dsyevr_((flags & WS_LANCZOS) ? "V" : "N", "I", "L", &n, NULL, &ld,
+            &dbl0, &dbl0, &int1, &int1, &dbl0, &m, NULL, NULL, &ld, isuppz,
+            &wl, &lwork, &iwl, &liwork, &info);
+        ws->lwork = (int) wl;
+        ws->liwork = iwl;
+        if (!(ws->Q = (double *) malloc(ld * ld * sizeof(double))) ||
+            !(ws->w = (double *) malloc(ld * sizeof(double))) ||
+            !(ws->work = (double *) malloc(ws->lwork * sizeof(double))) ||
+            !(ws->iwork = (int *) malloc(ws->liwork * sizeof(int)))){
+            ws_clear(ws);
+            return -1;
+        }
+    }
+    if (flags & WS_SIGMA){
+        lwork = liwork = -1;
+        dsyevd_("V", "L", &n, NULL, &ld, NULL, &wl, &lwork, &iwl, &liwork,
+            &info);
+        ws->lworkd = (int) wl;
+        ws->liworkd = iwl;
+        if (!(ws->workd = (double *) malloc(ws->lworkd * sizeof(double))) ||
+            !(ws->iworkd = (int *) malloc(ws->liworkd * sizeof(int)))){
+            ws_clear(ws);
+            return -1;
+        }
+    }
+    if ((flags & WS_LANCZOS) &&
+        (!(ws->lwrk = (double *) malloc(llwrk * sizeof(double))) ||
+        !(ws->v0 = (double *) malloc(ld * sizeof(double))))){
+        ws_clear(ws);
+        return -1;
+    }
+    ws->n = n;
+    ws->flags = flags;
+    return 0;
+}
+
+/*
+ * Returns ws->scale, enlarged to at least n doubles, or NULL if there is
+ * not enough memory.
+ */
+static double* ws_scale(wspace *ws, int n)
+{
+    if (ws->lscale < n){
+        free(ws->scale);
+        ws->lscale = 0;
+        if (!(ws->scale = (double *) malloc(n * sizeof(double))))
+            return NULL;
+        ws->lscale = n;
+    }
+    return ws->scale;
+}
+
+static void ws_free_ptr(wspace *ws)
+{
+    ws_clear(ws);
+    free(ws->scale);
+    free(ws);
+}
+
+#if PY_MAJOR_VERSION >= 3
+static void ws_free(PyObject *O)
+{
+    ws_free_ptr((wspace *) PyCapsule_GetPointer(O, WSPACE_NAME));
+}
+#else
+static void ws_free(void *ws, void *descr)
+{
+    ws_free_ptr((wspace *) ws);
+}
+#endif
+
+/*
+ * Returns the workspace in the object O created by workspace(), or NULL
+ * if O is None.  Sets a TypeError and returns NULL if O is not a
+ * workspace.
+ */
+static wspace* ws_get(PyObject *O)
+{
+    if (!O || O == Py_None) return NULL;
+#if PY_MAJOR_VERSION >= 3
+    if (PyCapsule_CheckExact(O) && PyCapsule_GetName(O) &&
+        !strcmp(PyCapsule_GetName(O), WSPACE_NAME))
+        return (wspace *) PyCapsule_GetPointer(O, WSPACE_NAME);
+#else
+    if (PyCObject_Check(O) && PyCObject_GetDesc(O) &&
+        !strcmp((char *) PyCObject_GetDesc(O), WSPACE_NAME))
+        return (wspace *) PyCObject_AsVoidPtr(O);
+#endif
+    PyErr_SetString(PyExc_TypeError, "'work' must be None or a "
+        "workspace created by workspace()");
+    return NULL;
+}
+
+/*
+ * Scaling of the xc columns of a 'q' block x of order m with leading
+ * dimension xr.  See scale().  wrk is a workspace of length xc.
+ */
+static void scale_socp(double *x, int xr, int xc, double *v, double b,
+    int m, int inverse, double *wrk)
+{
+    int i, j, ld = MAX(xr, 1), int1 = 1;
+    double a, dbl0 = 0.0, dbl1 = 1.0, dblm1 = -1.0, dbl2 = 2.0;
+
+    if (inverse == 'I') b = 1.0 / b;
+    if (m <= SMALL_BLOCK){
+        for (i = 0; i < xc; i++, x += xr){
+            if (inverse == 'I') x[0] *= -1.0;
+            for (j = 0, a = 0.0; j < m; j++) a += x[j] * v[j];
+            x[0] *= -1.0;
+            for (j = 0; j < m; j++) x[j] += v[j] * (2.0 * a);
+            if (inverse == 'I') x[0] *= -1.0;
+            for (j = 0; j < m; j++) x[j] *= b;
+        }
+        return;
+    }
+
+    if (inverse == 'I') dscal_(&xc, &dblm1, x, &xr);
+    dgemv_("T", &m, &xc, &dbl1, x, &ld, v, &int1, &dbl0, wrk, &int1);
+    dscal_(&xc, &dblm1, x, &xr);
+    dger_(&m, &xc, &dbl2, v, &int1, wrk, &int1, x, &ld);
+    if (inverse == 'I') dscal_(&xc, &dblm1, x, &xr);
+    for (i = 0; i < xc; i++) dscal_(&m, &b, x + i*xr, &int1);
+}
+
+/*
+ * Scaling of the xc columns of an 's' block x of order n with leading
+ * dimension xr:  mat(xk) := r * mat(xk) * r' if t is nonzero and
+ * mat(xk) := r' * mat(xk) * r otherwise.  Only the lower triangular
+ * part of mat(xk) is referenced and updated.  wrk is a workspace of
+ * length n*n.
+ */
+static void scale_sdp(double *x, int xr, int xc, double *r, int n, int t,
+    double *wrk)
+{
+    int i, j, k, l, len = n*n, ld = MAX(1, n), inc = n + 1, int1 = 1;
+    double a, dbl0 = 0.0, dbl1 = 1.0, dbl5 = 0.5;
+
+    if (n <= SMALL_BLOCK){
+        for (i = 0; i < xc; i++, x += xr){
+            /* wrk = X*r' if t is nonzero and X*r otherwise */
+            for (j = 0; j < n; j++) for (k = 0; k < n; k++){
+                for (l = 0, a = 0.0; l < n; l++)
+                    a += x[(j >= l) ? j + l*n : l + j*n] * (t ? r[k + l*n]
+                        : r[l + k*n]);
+                wrk[j + k*n] = a;
+            }
+            /* tril(X) := tril(r*wrk) or tril(r'*wrk) */
+            for (k = 0; k < n; k++) for (j = k; j < n; j++){
+                for (l = 0, a = 0.0; l < n; l++)
+                    a += (t ? r[j + l*n] : r[l + j*n]) * wrk[l + k*n];
+                x[j + k*n] = a;
+            }
+        }
+        return;
+    }
+
+    for (i = 0; i < xc; i++){
+
+        /* scale diagonal of xk by 0.5 */
+        dscal_(&n, &dbl5, x + i*xr, &inc);
+
+        /* wrk = r*tril(x) if t is nonzero and tril(x)*r otherwise */
+        dcopy_(&len, r, &int1, wrk, &int1);
+        dtrmm_(t ? "R" : "L", "L", "N", "N", &n, &n, &dbl1, x + i*xr, &ld,
+            wrk, &ld);
+
+        /* x := (r*wrk' + wrk*r') if t is nonzero and
+         * x := (r'*wrk + wrk'*r) otherwise */
+        dsyr2k_("L", t ? "N" : "T", &n, &n, &dbl1, r, &ld, wrk, &ld, &dbl0,
+            x + i*xr, &ld);
+    }
+}
+
+/*
+ * Scaling of a 'q' block x of order m in scale2().  l is the block of
+ * lmbda.
+ */
+static void scale2_socp(double *l, double *x, int m, int inverse)
+{
+    int j, len = m - 1, int1 = 1;
+    double a, lx, x0, b;
+
+    if (m <= SMALL_BLOCK){
+        for (j = 1, a = 0.0; j < m; j++) a += l[j] * l[j];
+        a = sqrt(a);
+    }
+    else
+        a = dnrm2_(&len, l + 1, &int1);
+    a = sqrt(l[0] + a) * sqrt(l[0] - a);
+    if (m <= SMALL_BLOCK){
+        for (j = 1, lx = 0.0; j < m; j++) lx += l[j] * x[j];
+        lx = ((inverse == 'N') ? l[0] * x[0] - lx : l[0] * x[0] + lx) / a;
+    }
+    else if (inverse == 'N')
+        lx = ( l[0] * x[0] - ddot_(&len, l + 1, &int1, x + 1, &int1) ) / a;
+    else
+        lx = ddot_(&m, l, &int1, x, &int1) / a;
+    x0 = x[0];
+    x[0] = lx;
+    b = (x0 + lx) / (l[0]/a + 1.0) / a;
+    if (inverse == 'N')  b *= -1.0;
+    if (inverse == 'N')  a = 1.0 / a;
+    if (m <= SMALL_BLOCK){
+        for (j = 1; j < m; j++) x[j] += b * l[j];
+        for (j = 0; j < m; j++) x[j] *= a;
+        return;
+    }
+    daxpy_(&len, &b, l + 1, &int1, x + 1, &int1);
+    dscal_(&m, &a, x, &int1);
+}
+
+/*
+ * Scaling of an 's' block x of order m in scale2().  l is the block of
+ * lmbda.  c and sql are workspaces of length m.
+ */
+static void scale2_sdp(double *l, double *x, int m, int inverse,
+    double *c, double *sql)
+{
+    int i, j, int0 = 0, int1 = 1;
+    double b;
+
+    if (m <= SMALL_BLOCK){
+        for (j = 0; j < m; j++){
+            b = sqrt(l[j]);
+            for (i = 0; i < m; i++)
+                if (inverse == 'N') x[i + j*m] /= b * sqrt(l[i]);
+                else x[i + j*m] *= b * sqrt(l[i]);
+        }
+        return;
+    }
+
+    for (j = 0; j < m; j++) sql[j] = sqrt(l[j]);
+    for (j = 0; j < m; j++){
+        dcopy_(&m, sql, &int1, c, &int1);
+        b = sqrt(l[j]);
+        dscal_(&m, &b, c, &int1);
+        if (inverse == 'N')
+            dtbsv_("L", "N", "N", &m, &int0, c, &int1, x + j*m, &int1);
+        else
+            dtbmv_("L", "N", "N", &m, &int0, c, &int1, x + j*m, &int1);
+    }
+}
+
+/*
+ * The product x := y o x for a 'q' block of order m.
+ */
+static void sprod_socp(double *x, double *y, int m)
+{
+    int j, len = m - 1, int1 = 1;
+    double a;
+
+    if (m <= SMALL_BLOCK){
+        for (j = 0, a = 0.0; j < m; j++) a += y[j] * x[j];
+        for (j = 1; j < m; j++) x[j] = y[0] * x[j] + x[0] * y[j];
+        x[0] = a;
+        return;
+    }
+    a = ddot_(&m, y, &int1, x, &int1);
+    dscal_(&len, y, x + 1, &int1);
+    daxpy_(&len, x, y + 1, &int1, x + 1, &int1);
+    x[0] = a;
+}
+
+/*
+ * The product x := y o x for an 's' block of order m with mat(y) in
+ * unpacked storage.  The upper triangular part of mat(y) is set equal
+ * to the lower triangular part.  A is a workspace of length m*m.
+ */
+static void sprod_sdp(double *x, double *y, int m, double *A)
+{
+    int j, k, l, len = m*m, ld = MAX(1, m), int1 = 1;
+    double a, dbl5 = 0.5, dbl0 = 0.0;
+
+    dcopy_(&len, x, &int1, A, &int1);
+    if (m <= SMALL_BLOCK){
+        for (k = 0; k < m; k++) for (j = k + 1; j < m; j++){
+            A[k + j*m] = A[j + k*m];
+            y[k + j*m] = y[j + k*m];
+        }
+        for (k = 0; k < m; k++) for (j = k; j < m; j++){
+            for (l = 0, a = 0.0; l < m; l++)
+                a += A[j + l*m] * y[k + l*m] + y[j + l*m] * A[k + l*m];
+            x[j + k*m] = 0.5 * a;
+        }
+        return;
+    }
+
+    for (k = 0; k < m; k++){
+        len = m - k - 1;
+        dcopy_(&len, A + k*(m+1) + 1, &int1, A + (k+1)*(m+1)-1, &m);
+        dcopy_(&len, y + k*(m+1) + 1, &int1, y + (k+1)*(m+1)-1, &m);
+    }
+    dsyr2k_("L", "N", &m, &m, &dbl5, A, &ld, y, &ld, &dbl0, x, &ld);
+}
+
+/*
+ * The product x := y o x (inverse is 'N') or x := y o\ x (inverse is
+ * 'I') for an 's' block x of order m and a diagonal 's' block y.  A is
+ * a workspace of length m.
+ */
+static void sprod_sdp_diag(double *x, double *y, int m, int inverse,
+    double *A)
+{
+    int j, k, len, int0 = 0, int1 = 1;
+    double dbl5 = 0.5;
+
+    for (k = 0; k < m; k++){
+        len = m - k;
+        if (m <= SMALL_BLOCK){
+            for (j = 0; j < len; j++)
+                if (inverse == 'N') x[k*(m+1) + j] *= (y[k+j] + y[k]) * 0.5;
+                else x[k*(m+1) + j] /= (y[k+j] + y[k]) * 0.5;
+            continue;
+        }
+        dcopy_(&len, y + k, &int1, A, &int1);
+        for (j = 0; j < len; j++) A[j] += y[k];
+        dscal_(&len, &dbl5, A, &int1);
+        if (inverse == 'N')
+            dtbmv_("L", "N", "N", &len, &int0, A, &int1, x + k*(m+1),
+                &int1);
+        else
+            dtbsv_("L", "N", "N", &len, &int0, A, &int1, x + k*(m+1),
+                &int1);
+    }
+}
+
+/*
+ * The inverse product x := y o\ x for a 'q' block of order m.
+ */
+static void sinv_socp(double *x, double *y, int m)
+{
+    int j, len = m - 1, int1 = 1;
+    double a, c, d, alpha;
+
+    if (m <= SMALL_BLOCK){
+        for (j = 1, a = 0.0, d = 0.0; j < m; j++){
+            a += y[j] * y[j];
+            d += x[j] * y[j];
+        }
+        a = sqrt(a);
+    }
+    else {
+        a = dnrm2_(&len, y + 1, &int1);
+        d = ddot_(&len, x + 1, &int1, y + 1, &int1);
+    }
+    a = (y[0] + a) * (y[0] - a);
+    c = x[0];
+    x[0] = c * y[0] - d;
+    if (m <= SMALL_BLOCK){
+        for (j = 1; j < m; j++)
+            x[j] = (a / y[0] * x[j] + (d / y[0] - c) * y[j]) / a;
+        x[0] /= a;
+        return;
+    }
+    alpha = a / y[0];
+    dscal_(&len, &alpha, x + 1, &int1);
+    alpha = d / y[0] - c;
+    daxpy_(&len, &alpha, y + 1, &int1, x + 1, &int1);
+    alpha = 1.0 / a;
+    dscal_(&m, &alpha, x, &int1);
+}
+
+/*
+ * Sets the upper triangular part of an 's' block of order n to zero
+ * and scales the strictly lower triangular part by two.
+ */
+static void trisc_sdp(double *x, int n)
+{
+    int i, j, len, int1 = 1;
+    double dbl0 = 0.0, dbl2 = 2.0;
+
+    if (n <= SMALL_BLOCK){
+        for (j = 0; j < n; j++){
+            for (i = 0; i < j; i++) x[i + j*n] = 0.0;
+            for (i = j + 1; i < n; i++) x[i + j*n] *= 2.0;
+        }
+        return;
+    }
+    for (i = 1; i < n; i++){
+        len = n - i;
+        dscal_(&len, &dbl0, x + i*(n+1) - 1, &n);
+        dscal_(&len, &dbl2, x + n*(i-1) + i, &int1);
+    }
+}
 
 
 static char doc_scale[] =
     "Applies Nesterov-Todd scaling or its inverse.\n\n"
-    "scale(x, W, trans = 'N', inverse = 'N')\n\n"
+    "scale(x, W, trans = 'N', inverse = 'N', work = None)\n\n"
     "Computes\n\n"
     "    x := W*x        (trans is 'N', inverse = 'N')\n"
     "    x := W^T*x      (trans is 'T', inverse = 'N')\n"
@@ -80,30 +617,34 @@ static char doc_scale[] =
     "- W['rti']: list of square matrices.  rti[k] is the inverse\n"
     "  transpose of r[k]. \n\n"
     "The 'dnl' and 'dnli' entries are optional, and only present when \n"
-    "the function is called from the nonlinear solver.";
+    "the function is called from the nonlinear solver.\n\n"
+    "work is None or a workspace created by workspace(), which is used\n"
+    "instead of allocating a new workspace.";
 
 static PyObject* scale(PyObject *self, PyObject *args, PyObject *kwrds)
 {
     matrix *x, *d, *vk, *rk;
-    PyObject *W, *v, *beta, *r, *betak;
+    PyObject *W, *v, *beta, *r, *work = NULL;
+    ntblock *qb = NULL, *sb = NULL;
+    wspace *ws;
 #if PY_MAJOR_VERSION >= 3
     int trans = 'N', inverse = 'N';
 #else
     char trans = 'N', inverse = 'N';
 #endif
-    int m, n, xr, xc, ind = 0, int0 = 0, int1 = 1, i, k, inc, len, ld, 
-        maxn, N;
-    double b, dbl0 = 0.0, dbl1 = 1.0, dblm1 = -1.0, dbl2 = 2.0, dbl5 = 0.5,
-        *wrk;
-    char *kwlist[] = {"x", "W", "trans", "inverse", NULL};
+    int m, xr, xc, ind = 0, int0 = 0, int1 = 1, i, k, nq, ns, maxq = 0,
+        maxn = 0, nw, t;
+    double *wrk;
+    char *kwlist[] = {"x", "W", "trans", "inverse", "work", NULL};
 
 #if PY_MAJOR_VERSION >= 3
-    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|CC", kwlist,
-        &x, &W, &trans, &inverse)) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|CCO", kwlist,
+        &x, &W, &trans, &inverse, &work)) return NULL;
 #else
-    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|cc", kwlist,
-        &x, &W, &trans, &inverse)) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|ccO", kwlist,
+        &x, &W, &trans, &inverse, &work)) return NULL;
 #endif
+    if (!(ws = ws_get(work)) && PyErr_Occurred()) return NULL;
 
     xr = x->nrows;
     xc = x->ncols;
@@ -141,6 +682,48 @@ static PyObject* scale(PyObject *self, PyObject *args, PyObject *kwrds)
     ind += m;
 
 
+    /*
+     * The 'q' blocks and the 's' blocks are scaled in parallel by
+     * scale_socp() and scale_sdp().
+     */
+
+    v = PyDict_GetItemString(W, "v");
+    beta = PyDict_GetItemString(W, "beta");
+    r = (inverse == 'N') ? PyDict_GetItemString(W, "r") :
+        PyDict_GetItemString(W, "rti");
+    nq = (int) PyList_Size(v);
+    ns = (int) PyList_Size(r);
+    if (!(qb = (ntblock *) calloc(MAX(1, nq), sizeof(ntblock))) ||
+        !(sb = (ntblock *) calloc(MAX(1, ns), sizeof(ntblock)))){
+        free(qb);
+        return PyErr_NoMemory();
+    }
+    for (k = 0; k < nq; k++){
+        vk = (matrix *) PyList_GetItem(v, (Py_ssize_t) k);
+        qb[k].m = vk->nrows;
+        qb[k].v = MAT_BUFD(vk);
+        qb[k].beta = PyFloat_AS_DOUBLE(PyList_GetItem(beta, (Py_ssize_t)
+            k));
+        qb[k].ind2 = ind;
+        ind += qb[k].m;
+        maxq = MAX(maxq, qb[k].m);
+    }
+    for (k = 0; k < ns; k++){
+        rk = (matrix *) PyList_GetItem(r, (Py_ssize_t) k);
+        sb[k].m = rk->nrows;
+        sb[k].r = MAT_BUFD(rk);
+        sb[k].ind2 = ind;
+        ind += sb[k].m * sb[k].m;
+        maxn = MAX(maxn, sb[k].m);
+    }
+    nw = MAX(1, MAX(xc, maxn*maxn));
+    if (!(wrk = ws ? ws_scale(ws, MAX_THREADS * nw) : (double *)
+        malloc(MAX_THREADS * nw * sizeof(double)))){
+        free(qb);  free(sb);
+        return PyErr_NoMemory();
+    }
+
+
     /*
      * Scaling for 'q' component is
      *
@@ -155,33 +738,12 @@ static PyObject* scale(PyObject *self, PyObject *args, PyObject *kwrds)
      *         = 1/beta * (-J) * (2*v*((-J*xk)'*v)' + xk).
      */
 
-    v = PyDict_GetItemString(W, "v");
-    beta = PyDict_GetItemString(W, "beta");
-    N = (int) PyList_Size(v);
-    if (!(wrk = (double *) calloc(xc, sizeof(double))))
-        return PyErr_NoMemory();
-    for (k = 0; k < N; k++){
-        vk = (matrix *) PyList_GetItem(v, (Py_ssize_t) k);
-        m = vk->nrows;
-        if (inverse == 'I')
-            dscal_(&xc, &dblm1, MAT_BUFD(x) + ind, &xr);
-        ld = MAX(xr, 1);
-        dgemv_("T", &m, &xc, &dbl1, MAT_BUFD(x) + ind, &ld, MAT_BUFD(vk), 
-            &int1, &dbl0, wrk, &int1);
-        dscal_(&xc, &dblm1, MAT_BUFD(x) + ind, &xr);
-        dger_(&m, &xc, &dbl2, MAT_BUFD(vk), &int1, wrk, &int1,
-            MAT_BUFD(x) + ind, &ld);
-        if (inverse == 'I')
-            dscal_(&xc, &dblm1, MAT_BUFD(x) + ind, &xr);
-
-        betak = PyList_GetItem(beta, (Py_ssize_t) k);
-        b = PyFloat_AS_DOUBLE(betak);
-        if (inverse == 'I') b = 1.0 / b;
-        for (i = 0; i < xc; i++)
-            dscal_(&m, &b, MAT_BUFD(x) + ind + i*xr, &int1);
-        ind += m;
-    }
-    free(wrk);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(PARALLEL_BLOCKS(nq, maxq))
+#endif
+    for (k = 0; k < nq; k++)
+        scale_socp(MAT_BUFD(x) + qb[k].ind2, xr, xc, qb[k].v, qb[k].beta,
+            qb[k].m, inverse, wrk + THREAD_NUM * nw);
 
 
     /*
@@ -200,46 +762,17 @@ static PyObject* scale(PyObject *self, PyObject *args, PyObject *kwrds)
      * rti is kth element of W['rti'].
      */
 
-    r = (inverse == 'N') ? PyDict_GetItemString(W, "r") :
-        PyDict_GetItemString(W, "rti");
-    N = (int) PyList_Size(r);
-    for (k = 0, maxn = 0; k < N; k++){
-        rk = (matrix *) PyList_GetItem(r, (Py_ssize_t) k);
-        maxn = MAX(maxn, rk->nrows);
-    }
-    if (!(wrk = (double *) calloc(maxn*maxn, sizeof(double))))
-        return PyErr_NoMemory();
-    for (k = 0; k < N; k++){
-        rk = (matrix *) PyList_GetItem(r, (Py_ssize_t) k);
-        n = rk->nrows;
-        for (i = 0; i < xc; i++){
-
-            /* scale diagonal of rk by 0.5 */
-            inc = n + 1;
-            dscal_(&n, &dbl5, MAT_BUFD(x) + ind + i*xr, &inc);
-
-            /* wrk = r*tril(x) if inverse is 'N' and trans is 'T' or
-             *                 inverse is 'I' and trans is 'N'
-             * wrk = tril(x)*r otherwise. */
-            len = n*n;
-            dcopy_(&len, MAT_BUFD(rk), &int1, wrk, &int1);
-            ld = MAX(1, n);
-            dtrmm_( (( inverse == 'N' && trans == 'T') || ( inverse == 'I'
-                && trans == 'N')) ? "R" : "L", "L", "N", "N", &n, &n,
-                &dbl1, MAT_BUFD(x) + ind + i*xr, &ld, wrk, &ld);
-
-            /* x := (r*wrk' + wrk*r') if inverse is 'N' and trans is 'T'
-             *                        or inverse is 'I' and trans is 'N'
-             * x := (r'*wrk + wrk'*r) otherwise. */
-            dsyr2k_("L", ((inverse == 'N' && trans == 'T') ||
-                (inverse == 'I' && trans == 'N')) ? "N" : "T", &n, &n,
-                &dbl1, MAT_BUFD(rk), &ld, wrk, &ld, &dbl0, MAT_BUFD(x) +
-                ind + i*xr, &ld);
-        }
-        ind += n*n;
-    }
-    free(wrk);
+    t = (inverse == 'N' && trans == 'T') || (inverse == 'I' && trans ==
+        'N');
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) if(PARALLEL_BLOCKS(ns, maxn))
+#endif
+    for (k = 0; k < ns; k++)
+        scale_sdp(MAT_BUFD(x) + sb[k].ind2, xr, xc, sb[k].r, sb[k].m, t,
+            wrk + THREAD_NUM * nw);
 
+    free(qb);  free(sb);
+    if (!ws) free(wrk);
     return Py_BuildValue("");
 }
 
@@ -256,14 +789,15 @@ static char doc_scale2[] =
 static PyObject* scale2(PyObject *self, PyObject *args, PyObject *kwrds)
 {
     matrix *lmbda, *x;
-    PyObject *dims, *O, *Ok;
+    PyObject *dims, *O;
+    ntblock *qb = NULL, *sb = NULL;
 #if PY_MAJOR_VERSION >= 3
     int inverse = 'N';
 #else
     char inverse = 'N';
 #endif
-    double a, lx, x0, b, *c = NULL, *sql = NULL;
-    int m = 0, mk, i, j, len, int0 = 0, int1 = 1, maxn = 0, ind2;
+    double *wrk = NULL;
+    int m = 0, k, int0 = 0, int1 = 1, ind, ind2, nq, ns, maxq, maxn;
     char *kwlist[] = {"lmbda", "x", "dims", "mnl", "inverse", NULL};
 
 #if PY_MAJOR_VERSION >= 3
@@ -297,6 +831,15 @@ static PyObject* scale2(PyObject *self, PyObject *args, PyObject *kwrds)
         dtbmv_("L", "N", "N", &m, &int0, MAT_BUFD(lmbda), &int1,
              MAT_BUFD(x), &int1);
 
+    ind = ind2 = m;
+    if (!(qb = dims_blocks(dims, "q", &ind, &ind2, &nq, &maxq)) ||
+        !(sb = dims_blocks(dims, "s", &ind, &ind2, &ns, &maxn)) ||
+        !(wrk = (double *) malloc(MAX_THREADS * MAX(1, 2*maxn) *
+        sizeof(double)))){
+        free(qb);  free(sb);
+        return PyErr_NoMemory();
+    }
+
 
     /*
      * For 'q' blocks, if inverse is 'N',
@@ -312,34 +855,12 @@ static PyObject* scale2(PyObject *self, PyObject *args, PyObject *kwrds)
      * a = sqrt(lambda_k' * J * lambda_k), l = lambda_k / a.
      */
 
-    O = PyDict_GetItemString(dims, "q");
-    for (i = 0; i < (int) PyList_Size(O); i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        mk = (int) PyLong_AsLong(Ok);
-#else
-        mk = (int) PyInt_AsLong(Ok);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(PARALLEL_BLOCKS(nq, maxq))
 #endif
-        len = mk - 1;
-        a = dnrm2_(&len, MAT_BUFD(lmbda) + m + 1, &int1);
-        a = sqrt(MAT_BUFD(lmbda)[m] + a) * sqrt(MAT_BUFD(lmbda)[m] - a);
-        if (inverse == 'N')
-            lx = ( MAT_BUFD(lmbda)[m] * MAT_BUFD(x)[m] -
-                ddot_(&len, MAT_BUFD(lmbda) + m + 1, &int1, MAT_BUFD(x) + m
-                    + 1, &int1) ) / a;
-        else
-            lx = ddot_(&mk, MAT_BUFD(lmbda) + m, &int1, MAT_BUFD(x) + m,
-                &int1) / a;
-        x0 = MAT_BUFD(x)[m];
-        MAT_BUFD(x)[m] = lx;
-        b = (x0 + lx) / (MAT_BUFD(lmbda)[m]/a + 1.0) / a;
-        if (inverse == 'N')  b *= -1.0;
-        daxpy_(&len, &b, MAT_BUFD(lmbda) + m + 1, &int1,
-            MAT_BUFD(x) + m + 1, &int1);
-        if (inverse == 'N')  a = 1.0 / a;
-        dscal_(&mk, &a, MAT_BUFD(x) + m, &int1);
-        m += mk;
-    }
+    for (k = 0; k < nq; k++)
+        scale2_socp(MAT_BUFD(lmbda) + qb[k].ind, MAT_BUFD(x) + qb[k].ind2,
+            qb[k].m, inverse);
 
 
     /*
@@ -357,46 +878,15 @@ static PyObject* scale2(PyObject *self, PyObject *args, PyObject *kwrds)
      * inverse operation will be applied to nonsymmetric matrices.
      */
 
-    O = PyDict_GetItemString(dims, "s");
-    for (i = 0; i < (int) PyList_Size(O); i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        maxn = MAX(maxn, (int) PyLong_AsLong(Ok));
-#else
-        maxn = MAX(maxn, (int) PyInt_AsLong(Ok));
-#endif
-    }
-    if (!(c = (double *) calloc(maxn, sizeof(double))) ||
-        !(sql = (double *) calloc(maxn, sizeof(double)))){
-        free(c); free(sql);
-        return PyErr_NoMemory();
-    }
-    ind2 = m;
-    for (i = 0; i < (int) PyList_Size(O); i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        mk = (int) PyLong_AsLong(Ok);
-#else
-        mk = (int) PyInt_AsLong(Ok);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) if(PARALLEL_BLOCKS(ns, maxn))
 #endif
-        for (j = 0; j < mk; j++)
-            sql[j] = sqrt(MAT_BUFD(lmbda)[ind2 + j]);
-        for (j = 0; j < mk; j++){
-            dcopy_(&mk, sql, &int1, c, &int1);
-            b = sqrt(MAT_BUFD(lmbda)[ind2 + j]);
-            dscal_(&mk, &b, c, &int1);
-            if (inverse == 'N')
-                dtbsv_("L", "N", "N", &mk, &int0, c, &int1, MAT_BUFD(x) +
-                    m + j*mk, &int1);
-            else
-                dtbmv_("L", "N", "N", &mk, &int0, c, &int1, MAT_BUFD(x) +
-                    m + j*mk, &int1);
-        }
-        m += mk*mk;
-        ind2 += mk;
-    }
-    free(c); free(sql);
+    for (k = 0; k < ns; k++)
+        scale2_sdp(MAT_BUFD(lmbda) + sb[k].ind, MAT_BUFD(x) + sb[k].ind2,
+            sb[k].m, inverse, wrk + THREAD_NUM * 2*maxn, wrk + THREAD_NUM *
+            2*maxn + maxn);
 
+    free(qb);  free(sb);  free(wrk);
     return Py_BuildValue("");
 }
 
@@ -634,9 +1124,10 @@ static char doc_sprod[] =
 static PyObject* sprod(PyObject *self, PyObject *args, PyObject *kwrds)
 {
     matrix *x, *y;
-    PyObject *dims, *O, *Ok;
-    int i, j, k, mk, len, maxn, ind = 0, ind2, int0 = 0, int1 = 1, ld;
-    double a, *A = NULL, dbl2 = 0.5, dbl0 = 0.0;
+    PyObject *dims, *O;
+    ntblock *qb = NULL, *sb = NULL;
+    int k, ind = 0, ind2, int0 = 0, int1 = 1, nq, ns, maxq, maxn, nw;
+    double *A = NULL;
 #if PY_MAJOR_VERSION >= 3
     int diag = 'N';
 #else
@@ -668,6 +1159,18 @@ static PyObject* sprod(PyObject *self, PyObject *args, PyObject *kwrds)
     dtbmv_("L", "N", "N", &ind, &int0, MAT_BUFD(y), &int1, MAT_BUFD(x),
         &int1);
 
+    ind2 = ind;
+    if (!(qb = dims_blocks(dims, "q", &ind, &ind2, &nq, &maxq)) ||
+        !(sb = dims_blocks(dims, "s", &ind, &ind2, &ns, &maxn))){
+        free(qb);
+        return PyErr_NoMemory();
+    }
+    nw = MAX(1, (diag == 'N') ? maxn*maxn : maxn);
+    if (!(A = (double *) malloc(MAX_THREADS * nw * sizeof(double)))){
+        free(qb);  free(sb);
+        return PyErr_NoMemory();
+    }
+
 
     /*
      * For 'q' blocks:
@@ -679,22 +1182,12 @@ static PyObject* sprod(PyObject *self, PyObject *args, PyObject *kwrds)
      * where yk = (l0, l1).
      */
 
-    O = PyDict_GetItemString(dims, "q");
-    for (i = 0; i < (int) PyList_Size(O); i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        mk = (int) PyLong_AsLong(Ok);
-#else
-        mk = (int) PyInt_AsLong(Ok);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(PARALLEL_BLOCKS(nq, maxq))
 #endif
-        a = ddot_(&mk, MAT_BUFD(y) + ind, &int1, MAT_BUFD(x) + ind, &int1);
-        len = mk - 1;
-        dscal_(&len, MAT_BUFD(y) + ind, MAT_BUFD(x) + ind + 1, &int1);
-        daxpy_(&len, MAT_BUFD(x) + ind, MAT_BUFD(y) + ind + 1, &int1,
-            MAT_BUFD(x) + ind + 1, &int1);
-        MAT_BUFD(x)[ind] = a;
-        ind += mk;
-    }
+    for (k = 0; k < nq; k++)
+        sprod_socp(MAT_BUFD(x) + qb[k].ind2, MAT_BUFD(y) + qb[k].ind2,
+            qb[k].m);
 
 
     /*
@@ -705,64 +1198,19 @@ static PyObject* sprod(PyObject *self, PyObject *args, PyObject *kwrds)
      * where Yk = mat(yk) if diag is 'N' and Yk = diag(yk) if diag is 'D'.
      */
 
-    O = PyDict_GetItemString(dims, "s");
-    for (i = 0, maxn = 0; i < (int) PyList_Size(O); i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        maxn = MAX(maxn, (int) PyLong_AsLong(Ok));
-#else
-        maxn = MAX(maxn, (int) PyInt_AsLong(Ok));
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) if(PARALLEL_BLOCKS(ns, maxn))
 #endif
-    }
-    if (diag == 'N'){
-        if (!(A = (double *) calloc(maxn * maxn, sizeof(double))))
-            return PyErr_NoMemory();
-        for (i = 0; i < (int) PyList_Size(O); ind += mk*mk, i++){
-            Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-            mk = (int) PyLong_AsLong(Ok);
-#else
-            mk = (int) PyInt_AsLong(Ok);
-#endif
-            len = mk*mk;
-            dcopy_(&len, MAT_BUFD(x) + ind, &int1, A, &int1);
-
-            if (mk > 1) for (k = 0; k < mk; k++){
-                len = mk - k - 1;
-                dcopy_(&len, A + k*(mk+1) + 1, &int1, A + (k+1)*(mk+1)-1,
-                    &mk);
-                dcopy_(&len, MAT_BUFD(y) + ind + k*(mk+1) + 1, &int1,
-                    MAT_BUFD(y) + ind + (k+1)*(mk+1)-1, &mk);
-            }
-
-            ld = MAX(1, mk);
-            dsyr2k_("L", "N", &mk, &mk, &dbl2, A, &ld, MAT_BUFD(y) + ind,
-                &ld, &dbl0, MAT_BUFD(x) + ind, &ld);
-        }
-    }
-    else {
-        if (!(A = (double *) calloc(maxn, sizeof(double))))
-            return PyErr_NoMemory();
-        for (i = 0, ind2 = ind; i < (int) PyList_Size(O); ind += mk*mk,
-            ind2 += mk, i++){
-            Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-            mk = (int) PyLong_AsLong(Ok);
-#else
-            mk = (int) PyInt_AsLong(Ok);
-#endif
-            for (k = 0; k < mk; k++){
-                len = mk - k;
-                dcopy_(&len, MAT_BUFD(y) + ind2 + k, &int1, A, &int1);
-                for (j = 0; j < len; j++) A[j] += MAT_BUFD(y)[ind2 + k];
-                dscal_(&len, &dbl2, A, &int1);
-                dtbmv_("L", "N", "N", &len, &int0, A, &int1, MAT_BUFD(x) +
-                    ind + k * (mk+1), &int1);
-            }
-        }
+    for (k = 0; k < ns; k++){
+        if (diag == 'N')
+            sprod_sdp(MAT_BUFD(x) + sb[k].ind2, MAT_BUFD(y) + sb[k].ind2,
+                sb[k].m, A + THREAD_NUM * nw);
+        else
+            sprod_sdp_diag(MAT_BUFD(x) + sb[k].ind2, MAT_BUFD(y) +
+                sb[k].ind, sb[k].m, 'N', A + THREAD_NUM * nw);
     }
 
-    free(A);
+    free(qb);  free(sb);  free(A);
     return Py_BuildValue("");
 }
 
@@ -775,9 +1223,10 @@ static char doc_sinv[] =
 static PyObject* sinv(PyObject *self, PyObject *args, PyObject *kwrds)
 {
     matrix *x, *y;
-    PyObject *dims, *O, *Ok;
-    int i, j, k, mk, len, maxn, ind = 0, ind2, int0 = 0, int1 = 1;
-    double a, c, d, alpha, *A = NULL, dbl2 = 0.5;
+    PyObject *dims, *O;
+    ntblock *qb = NULL, *sb = NULL;
+    int k, ind = 0, ind2, int0 = 0, int1 = 1, nq, ns, maxq, maxn;
+    double *A = NULL;
     char *kwlist[] = {"x", "y", "dims", "mnl", NULL};
 
     if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|i", kwlist, &x, &y,
@@ -799,6 +1248,15 @@ static PyObject* sinv(PyObject *self, PyObject *args, PyObject *kwrds)
     dtbsv_("L", "N", "N", &ind, &int0, MAT_BUFD(y), &int1, MAT_BUFD(x),
         &int1);
 
+    ind2 = ind;
+    if (!(qb = dims_blocks(dims, "q", &ind, &ind2, &nq, &maxq)) ||
+        !(sb = dims_blocks(dims, "s", &ind, &ind2, &ns, &maxn)) ||
+        !(A = (double *) malloc(MAX_THREADS * MAX(1, maxn) *
+        sizeof(double)))){
+        free(qb);  free(sb);
+        return PyErr_NoMemory();
+    }
+
 
     /*
      * For 'q' blocks:
@@ -810,30 +1268,12 @@ static PyObject* sinv(PyObject *self, PyObject *args, PyObject *kwrds)
      * where yk = (l0, l1) and a = l0^2 - l1'*l1.
      */
 
-    O = PyDict_GetItemString(dims, "q");
-    for (i = 0; i < (int) PyList_Size(O); i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        mk = (int) PyLong_AsLong(Ok);
-#else
-        mk = (int) PyInt_AsLong(Ok);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(PARALLEL_BLOCKS(nq, maxq))
 #endif
-        len = mk - 1;
-        a = dnrm2_(&len, MAT_BUFD(y) + ind + 1, &int1);
-        a = (MAT_BUFD(y)[ind] + a) * (MAT_BUFD(y)[ind] - a);
-        c = MAT_BUFD(x)[ind];
-        d = ddot_(&len, MAT_BUFD(x) + ind + 1, &int1,
-            MAT_BUFD(y) + ind + 1, &int1);
-        MAT_BUFD(x)[ind] = c * MAT_BUFD(y)[ind] - d;
-        alpha = a / MAT_BUFD(y)[ind];
-        dscal_(&len, &alpha, MAT_BUFD(x) + ind + 1, &int1);
-        alpha = d / MAT_BUFD(y)[ind] - c;
-        daxpy_(&len, &alpha, MAT_BUFD(y) + ind + 1, &int1, MAT_BUFD(x) +
-            ind + 1, &int1);
-        alpha = 1.0 / a;
-        dscal_(&mk, &alpha, MAT_BUFD(x) + ind, &int1);
-        ind += mk;
-    }
+    for (k = 0; k < nq; k++)
+        sinv_socp(MAT_BUFD(x) + qb[k].ind2, MAT_BUFD(y) + qb[k].ind2,
+            qb[k].m);
 
 
     /*
@@ -844,36 +1284,14 @@ static PyObject* sinv(PyObject *self, PyObject *args, PyObject *kwrds)
      * where  gammaij = .5 * (yk_i + yk_j).
      */
 
-    O = PyDict_GetItemString(dims, "s");
-    for (i = 0, maxn = 0; i < (int) PyList_Size(O); i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        maxn = MAX(maxn, (int) PyLong_AsLong(Ok));
-#else
-        maxn = MAX(maxn, (int) PyInt_AsLong(Ok));
-#endif
-    }
-    if (!(A = (double *) calloc(maxn, sizeof(double))))
-        return PyErr_NoMemory();
-    for (i = 0, ind2 = ind; i < (int) PyList_Size(O); ind += mk*mk,
-        ind2 += mk, i++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) i);
-#if PY_MAJOR_VERSION >= 3
-        mk = (int) PyLong_AsLong(Ok);
-#else
-        mk = (int) PyInt_AsLong(Ok);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) if(PARALLEL_BLOCKS(ns, maxn))
 #endif
-        for (k = 0; k < mk; k++){
-            len = mk - k;
-            dcopy_(&len, MAT_BUFD(y) + ind2 + k, &int1, A, &int1);
-            for (j = 0; j < len; j++) A[j] += MAT_BUFD(y)[ind2 + k];
-            dscal_(&len, &dbl2, A, &int1);
-            dtbsv_("L", "N", "N", &len, &int0, A, &int1, MAT_BUFD(x) + ind
-                + k * (mk+1), &int1);
-        }
-    }
+    for (k = 0; k < ns; k++)
+        sprod_sdp_diag(MAT_BUFD(x) + sb[k].ind2, MAT_BUFD(y) + sb[k].ind,
+            sb[k].m, 'I', A + THREAD_NUM * MAX(1, maxn));
 
-    free(A);
+    free(qb);  free(sb);  free(A);
     return Py_BuildValue("");
 }
 
@@ -887,8 +1305,8 @@ static char doc_trisc[] =
 static PyObject* trisc(PyObject *self, PyObject *args, PyObject *kwrds)
 {
     matrix *x;
-    double dbl0 = 0.0, dbl2 = 2.0;
-    int ox = 0, i, k, nk, len, int1 = 1;
+    ntblock *sb;
+    int ox = 0, i, k, ns, maxn, ind = 0;
     PyObject *dims, *O, *Ok;
     char *kwlist[] = {"x", "dims", "offset", NULL};
 
@@ -912,21 +1330,14 @@ static PyObject* trisc(PyObject *self, PyObject *args, PyObject *kwrds)
 #endif
     }
 
-    O = PyDict_GetItemString(dims, "s");
-    for (k = 0; k < (int) PyList_Size(O); k++){
-        Ok = PyList_GetItem(O, (Py_ssize_t) k);
-#if PY_MAJOR_VERSION >= 3
-        nk = (int) PyLong_AsLong(Ok);
-#else
-        nk = (int) PyInt_AsLong(Ok);
+    if (!(sb = dims_blocks(dims, "s", &ind, &ox, &ns, &maxn)))
+        return PyErr_NoMemory();
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) if(PARALLEL_BLOCKS(ns, maxn))
 #endif
-        for (i = 1; i < nk; i++){
-            len = nk - i;
-            dscal_(&len, &dbl0, MAT_BUFD(x) + ox + i*(nk+1) - 1, &nk);
-            dscal_(&len, &dbl2, MAT_BUFD(x) + ox + nk*(i-1) + i, &int1);
-        }
-        ox += nk*nk;
-    }
+    for (k = 0; k < ns; k++)
+        trisc_sdp(MAT_BUFD(x) + sb[k].ind2, sb[k].m);
+    free(sb);
 
     return Py_BuildValue("");
 }
@@ -1039,28 +1450,107 @@ static PyObject* sdot(PyObject *self, PyObject *args, PyObject *kwrds)
 }
 
 
+/*
+ * Smallest eigenvalue of the symmetric matrix of order n with the lower
+ * triangle stored in A, by the Lanczos method with full
+ * reorthogonalization, started at v.  Returns 0 and the eigenvalue in
+ * lmin if a Ritz pair with residual at most tol*max(1, |lmin|) is found
+ * in maxit steps, and v is then overwritten with the Ritz vector.
+ * Otherwise returns a nonzero value and leaves v unchanged.  The
+ * residual is checked after 1, 2, 4, 8, 16 steps and every 16 steps
+ * thereafter, since each check costs O(k^3) for k steps.
+ */
+static int lanczos_min(double *A, int n, double *v, int maxit, double tol,
+    double *wrk, double *lmin)
+{
+    int i, j, k, len, int1 = 1, info;
+    double *V = wrk, *a = V + n*(maxit+1), *b = a + maxit, *d = b + maxit,
+        *e = d + maxit, *Z = e + maxit, *work = Z + maxit*maxit,
+        *h = work + 2*maxit, *q, *w, nrm, dbl0 = 0.0, dbl1 = 1.0,
+        dblm1 = -1.0;
+
+    nrm = dnrm2_(&n, v, &int1);
+    if (nrm > 0.0)
+        dcopy_(&n, v, &int1, V, &int1);
+    else {
+        for (i = 0; i < n; i++) V[i] = 1.0 / (1.0 + i);
+        nrm = dnrm2_(&n, V, &int1);
+    }
+    nrm = 1.0 / nrm;
+    dscal_(&n, &nrm, V, &int1);
+
+    for (j = 0; j < maxit; j++){
+        q = V + j*n;
+        w = q + n;
+        dsymv_("L", &n, &dbl1, A, &n, q, &int1, &dbl0, w, &int1);
+        a[j] = ddot_(&n, q, &int1, w, &int1);
+
+        /* w := w - V*V'*w, twice, with V the first j+1 Lanczos vectors. */
+        k = j + 1;
+        for (i = 0; i < 2; i++){
+            dgemv_("T", &n, &k, &dbl1, V, &n, w, &int1, &dbl0, h, &int1);
+            dgemv_("N", &n, &k, &dblm1, V, &n, h, &int1, &dbl1, w, &int1);
+        }
+        b[j] = dnrm2_(&n, w, &int1);
+
+        /* Smallest eigenpair of the tridiagonal matrix T_k. */
+        if (b[j] > 0.0 && (k & (k-1)) && k % 16 && k < maxit && k < n)
+            goto next;
+        dcopy_(&k, a, &int1, d, &int1);
+        len = k - 1;
+        dcopy_(&len, b, &int1, e, &int1);
+        dstev_("V", &k, d, e, Z, &k, work, &info);
+        if (info) return info;
+
+        if (fabs(b[j] * Z[j]) <= tol * MAX(1.0, fabs(d[0])) || k == n){
+            *lmin = d[0];
+            dgemv_("N", &n, &k, &dbl1, V, &n, Z, &int1, &dbl0, v, &int1);
+            return 0;
+        }
+next:
+        nrm = 1.0 / b[j];
+        dscal_(&n, &nrm, w, &int1);
+    }
+    return 1;
+}
+
+
 static char doc_max_step[] =
     "Returns min {t | x + t*e >= 0}\n\n."
-    "max_step(x, dims, mnl = 0, sigma = None)\n\n"
+    "max_step(x, dims, mnl = 0, sigma = None, lanczos = 0, v = None,\n"
+    "         work = None)\n\n"
     "e is defined as follows\n\n"
     "- For the nonlinear and 'l' blocks: e is the vector of ones.\n"
     "- For the 'q' blocks: e is the first unit vector.\n"
     "- For the 's' blocks: e is the identity matrix.\n\n"
     "When called with the argument sigma, also returns the eigenvalues\n"
-    "(in sigma) and the eigenvectors (in x) of the 's' components of x.\n";
+    "(in sigma) and the eigenvectors (in x) of the 's' components of x.\n\n"
+    "If sigma is None and lanczos is positive, the smallest eigenvalues\n"
+    "of the 's' blocks of order lanczos or more are computed by the\n"
+    "Lanczos method, with a fallback to LAPACK when it does not converge.\n"
+    "v is None or a 'd' matrix of length sum(dims['s']).  Its segments\n"
+    "are the starting vectors for the 's' blocks (a zero segment selects\n"
+    "a default starting vector) and are overwritten with the\n"
+    "eigenvectors of the smallest eigenvalues, for use as starting\n"
+    "vectors in the next call.\n\n"
+    "work is None or a workspace created by workspace(), which is used\n"
+    "instead of allocating a new workspace.";
 
 static PyObject* max_step(PyObject *self, PyObject *args, PyObject *kwrds)
 {
-    matrix *x, *sigma = NULL;
-    PyObject *dims, *O, *Ok;
-    int i, mk, len, maxn, ind = 0, ind2, int1 = 1, ld, Ns = 0, info, lwork,
-        *iwork = NULL, liwork, iwl, m;
-    double t = -FLT_MAX, dbl0 = 0.0, *work = NULL, wl, *Q = NULL,
-        *w = NULL;
-    char *kwlist[] = {"x", "dims", "mnl", "sigma", NULL};
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|iO", kwlist, &x,
-        &dims, &ind, &sigma)) return NULL;
+    matrix *x, *sigma = NULL, *v = NULL;
+    PyObject *dims, *O, *Ok, *vO = Py_None, *work = NULL;
+    int i, mk, len, maxn, ind = 0, ind2, int1 = 1, Ns = 0, info, m,
+        lanczos = 0, sumn, isuppz[2], need;
+    double t = -FLT_MAX, dbl0 = 0.0, lmin;
+    wspace *ws, tmp = {0};
+    char *kwlist[] = {"x", "dims", "mnl", "sigma", "lanczos", "v", "work",
+        NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|iOiOO", kwlist, &x,
+        &dims, &ind, &sigma, &lanczos, &vO, &work)) return NULL;
+    if ((PyObject *) sigma == Py_None) sigma = NULL;
+    if (!(ws = ws_get(work)) && PyErr_Occurred()) return NULL;
 
     O = PyDict_GetItemString(dims, "l");
 #if PY_MAJOR_VERSION >= 3
@@ -1086,40 +1576,37 @@ static PyObject* max_step(PyObject *self, PyObject *args, PyObject *kwrds)
 
     O = PyDict_GetItemString(dims, "s");
     Ns = (int) PyList_Size(O);
-    for (i = 0, maxn = 0; i < Ns; i++){
+    for (i = 0, maxn = 0, sumn = 0; i < Ns; i++){
         Ok = PyList_GetItem(O, (Py_ssize_t) i);
 #if PY_MAJOR_VERSION >= 3
-        maxn = MAX(maxn, (int) PyLong_AsLong(Ok));
+        mk = (int) PyLong_AsLong(Ok);
 #else
-        maxn = MAX(maxn, (int) PyInt_AsLong(Ok));
+        mk = (int) PyInt_AsLong(Ok);
 #endif
+        maxn = MAX(maxn, mk);
+        sumn += mk;
     }
     if (!maxn) return Py_BuildValue("d", (ind) ? t : 0.0);
 
-    lwork = -1;
-    liwork = -1;
-    ld = MAX(1, maxn);
-    if (sigma){
-        dsyevd_("V", "L", &maxn, NULL, &ld, NULL, &wl, &lwork, &iwl,
-            &liwork, &info);
-    }
-    else {
-        if (!(Q = (double *) calloc(maxn * maxn, sizeof(double))) ||
-            !(w = (double *) calloc(maxn, sizeof(double)))){
-            free(Q); free(w);
-            return PyErr_NoMemory();
+    if (vO != Py_None){
+        if (!Matrix_Check(vO) || MAT_ID(vO) != DOUBLE ||
+            MAT_LGT(vO) < sumn){
+            PyErr_Format(PyExc_TypeError, "'v' must be a 'd' matrix of "
+                "length at least %d", sumn);
+            return NULL;
         }
-        dsyevr_("N", "I", "L", &maxn, NULL, &ld, &dbl0, &dbl0, &int1,
-            &int1, &dbl0, &maxn, NULL, NULL, &int1, NULL, &wl, &lwork,
-            &iwl, &liwork, &info);
-    }
-    lwork = (int) wl;
-    liwork = iwl;
-    if (!(work = (double *) calloc(lwork, sizeof(double))) ||
-        (!(iwork = (int *) calloc(liwork, sizeof(int))))){
-        free(Q);  free(w);  free(work); free(iwork);
-        return PyErr_NoMemory();
+        v = (matrix *) vO;
     }
+    if (sigma || lanczos < 1 || maxn < lanczos) lanczos = 0;
+
+    /* Without a workspace, or if the blocks are larger than the blocks
+     * the workspace was created for, the buffers needed for sigma or
+     * the Lanczos method are allocated here. */
+    need = sigma ? WS_SIGMA : (lanczos ? WS_LANCZOS : WS_EIG);
+    if (!ws) ws = &tmp;
+    if ((ws->n < maxn || (ws->flags & need) != need) && ws_init(ws,
+        MAX(ws->n, maxn), ws->flags | need)) return PyErr_NoMemory();
+
     for (i = 0, ind2 = 0; i < Ns; i++){
         Ok = PyList_GetItem(O, (Py_ssize_t) i);
 #if PY_MAJOR_VERSION >= 3
@@ -1130,28 +1617,1502 @@ static PyObject* max_step(PyObject *self, PyObject *args, PyObject *kwrds)
         if (mk){
             if (sigma){
                 dsyevd_("V", "L", &mk, MAT_BUFD(x) + ind, &mk,
-                    MAT_BUFD(sigma) + ind2, work, &lwork, iwork, &liwork,
-                    &info);
+                    MAT_BUFD(sigma) + ind2, ws->workd, &ws->lworkd,
+                    ws->iworkd, &ws->liworkd, &info);
                 t = MAX(t, -MAT_BUFD(sigma)[ind2]);
             }
+            else if (lanczos && mk >= lanczos && !lanczos_min(MAT_BUFD(x)
+                + ind, mk, v ? MAT_BUFD(v) + ind2 : memset(ws->v0, 0,
+                mk*sizeof(double)), MIN(mk, LANCZOS_MAXIT), LANCZOS_TOL,
+                ws->lwrk, &lmin))
+                t = MAX(t, -lmin);
             else {
                 len = mk*mk;
-                dcopy_(&len, MAT_BUFD(x) + ind, &int1, Q, &int1);
-                ld = MAX(1, mk);
-                dsyevr_("N", "I", "L", &mk, Q, &mk, &dbl0, &dbl0, &int1,
-                    &int1, &dbl0, &m, w, NULL, &int1, NULL, work, &lwork,
-                    iwork, &liwork, &info);
-                t = MAX(t, -w[0]);
+                dcopy_(&len, MAT_BUFD(x) + ind, &int1, ws->Q, &int1);
+                /* Also the eigenvector, as starting vector for the
+                 * Lanczos method in the next call. */
+                if (v && lanczos && mk >= lanczos)
+                    dsyevr_("V", "I", "L", &mk, ws->Q, &mk, &dbl0, &dbl0,
+                        &int1, &int1, &dbl0, &m, ws->w, MAT_BUFD(v) + ind2,
+                        &mk, isuppz, ws->work, &ws->lwork, ws->iwork,
+                        &ws->liwork, &info);
+                else
+                    dsyevr_("N", "I", "L", &mk, ws->Q, &mk, &dbl0, &dbl0,
+                        &int1, &int1, &dbl0, &m, ws->w, NULL, &int1, NULL,
+                        ws->work, &ws->lwork, ws->iwork, &ws->liwork,
+                        &info);
+                t = MAX(t, -ws->w[0]);
             }
         }
         ind += mk*mk;
         ind2 += mk;
     }
-    free(work);  free(iwork);  free(Q);  free(w);
+    ws_clear(&tmp);
 
     return Py_BuildValue("d", (ind) ? t : 0.0);
 }
 
+
+static char doc_workspace[] =
+    "Returns a workspace for scale() and max_step().\n\n"
+    "work = workspace(dims)\n\n"
+    "The workspace is sized for vectors with the cone dimensions dims,\n"
+    "so that the functions do not allocate memory or query LAPACK\n"
+    "workspace sizes when called with the argument work.  It is\n"
+    "enlarged if it is used for larger 's' blocks.  A workspace must not\n"
+    "be used by two calls at the same time.";
+
+static PyObject* workspace(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    PyObject *dims;
+    ntblock *sb;
+    wspace *ws;
+    int ind = 0, ind2 = 0, ns, maxn;
+    char *kwlist[] = {"dims", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O", kwlist, &dims))
+        return NULL;
+    if (!(sb = dims_blocks(dims, "s", &ind, &ind2, &ns, &maxn)))
+        return PyErr_NoMemory();
+    free(sb);
+    if (!(ws = (wspace *) calloc(1, sizeof(wspace))) || (maxn &&
+        ws_init(ws, maxn, WS_ALL)) || !ws_scale(ws, MAX_THREADS * MAX(1,
+        maxn*maxn))){
+        if (ws) ws_free_ptr(ws);
+        return PyErr_NoMemory();
+    }
+#if PY_MAJOR_VERSION >= 3
+    return PyCapsule_New((void *) ws, WSPACE_NAME, ws_free);
+#else
+    return PyCObject_FromVoidPtrAndDesc((void *) ws, WSPACE_NAME, ws_free);
+#endif
+}
+
+/*
+ * Returns W[key] if it is a 'd' matrix of size (nrows, ncols).
+ * Otherwise stores a new matrix of that size in W[key] and returns it.
+ * The reference is borrowed.
+ */
+static matrix* W_matrix(PyObject *W, char *key, int nrows, int ncols)
+{
+    matrix *A = (matrix *) PyDict_GetItemString(W, key);
+
+    if (A && Matrix_Check(A) && MAT_ID(A) == DOUBLE && MAT_NROWS(A) ==
+        nrows && MAT_NCOLS(A) == ncols) return A;
+    if (!(A = Matrix_New(nrows, ncols, DOUBLE))) return NULL;
+    if (PyDict_SetItemString(W, key, (PyObject *) A)) A = NULL;
+    Py_XDECREF(A);
+    return A;
+}
+
+/*
+ * Returns the list W[key] of n 'd' matrices of size (b[k].m, 1), or
+ * (b[k].m, b[k].m) if square is nonzero.  Matrices of W[key] that have
+ * the correct size are reused.  The reference is borrowed.
+ */
+static PyObject* W_list(PyObject *W, char *key, ntblock *b, int n,
+    int square)
+{
+    PyObject *L = PyDict_GetItemString(W, key);
+    matrix *A;
+    int k, reuse = L && PyList_Check(L) && PyList_Size(L) == n;
+
+    if (!reuse && !(L = PyList_New(n))) return NULL;
+    for (k = 0; k < n; k++){
+        A = reuse ? (matrix *) PyList_GET_ITEM(L, k) : NULL;
+        if (A && Matrix_Check(A) && MAT_ID(A) == DOUBLE && MAT_NROWS(A)
+            == b[k].m && MAT_NCOLS(A) == (square ? b[k].m : 1)) continue;
+        if (!(A = Matrix_New(b[k].m, square ? b[k].m : 1, DOUBLE)) ||
+            PyList_SetItem(L, k, (PyObject *) A)){
+            if (!reuse) Py_DECREF(L);
+            return NULL;
+        }
+    }
+    if (!reuse){
+        k = PyDict_SetItemString(W, key, L);
+        Py_DECREF(L);
+        if (k) return NULL;
+    }
+    return L;
+}
+
+/*
+ * Stores the numbers b[k].beta in the list W['beta'].
+ */
+static int W_beta(PyObject *W, ntblock *b, int n)
+{
+    PyObject *L = PyDict_GetItemString(W, "beta"), *f;
+    int k;
+
+    if (!L || !PyList_Check(L) || PyList_Size(L) != n){
+        if (!(L = PyList_New(n))) return -1;
+        k = PyDict_SetItemString(W, "beta", L);
+        Py_DECREF(L);
+        if (k) return -1;
+    }
+    for (k = 0; k < n; k++)
+        if (!(f = PyFloat_FromDouble(b[k].beta)) || PyList_SetItem(L, k, f))
+            return -1;
+    return 0;
+}
+
+/*
+ * Scaling for a 'q' block of compute_scaling(): computes v = W['v'][k],
+ * beta = W['beta'][k] and lambda_k from s = sk and z = zk.
+ */
+static void cs_socp(ntblock *b, double *s, double *z, double *lmbda)
+{
+    int m = b->m, len = m - 1, int1 = 1;
+    double a, aa, bb, cc, dd, *v = b->v;
+
+    /* aa = sqrt( sk' * J * sk ), bb = sqrt( zk' * J * zk ) */
+    a = dnrm2_(&len, s + 1, &int1);
+    aa = sqrt(s[0] - a) * sqrt(s[0] + a);
+    a = dnrm2_(&len, z + 1, &int1);
+    bb = sqrt(z[0] - a) * sqrt(z[0] + a);
+    b->beta = sqrt(aa / bb);
+
+    /* cc = sqrt( (sk/a)' * (zk/b) + 1 ) / sqrt(2) */
+    cc = sqrt( ( ddot_(&m, s, &int1, z, &int1) / aa / bb + 1.0 ) / 2.0 );
+
+    /* v = 1/(2*c) * ( (sk/a) + J * (zk/b) ) */
+    dcopy_(&m, z, &int1, v, &int1);
+    a = -1.0/bb;
+    dscal_(&m, &a, v, &int1);
+    v[0] *= -1.0;
+    a = 1.0/aa;
+    daxpy_(&m, &a, s, &int1, v, &int1);
+    a = 1.0/2.0/cc;
+    dscal_(&m, &a, v, &int1);
+
+    /* v = 1/sqrt(2*(v0 + 1)) * ( v + e ) */
+    v[0] += 1.0;
+    a = 1.0/sqrt(2.0 * v[0]);
+    dscal_(&m, &a, v, &int1);
+
+    /* lambda_k = sqrt(a*b) * [ c;
+     *     (c + zk0/b)/d * sk1/a + (c + sk0/a)/d * zk1/b ] */
+    lmbda[0] = cc;
+    dd = 2*cc + s[0]/aa + z[0]/bb;
+    dcopy_(&len, s + 1, &int1, lmbda + 1, &int1);
+    a = (cc + z[0]/bb)/dd/aa;
+    dscal_(&len, &a, lmbda + 1, &int1);
+    a = (cc + s[0]/aa)/dd/bb;
+    daxpy_(&len, &a, z + 1, &int1, lmbda + 1, &int1);
+    a = sqrt(aa*bb);
+    dscal_(&m, &a, lmbda, &int1);
+}
+
+/*
+ * Scaling for an 's' block of compute_scaling(): computes r = W['r'][k],
+ * rti = W['rti'][k] and lambda_k from s = sk and z = zk.  Ls, Lz and U
+ * are workspaces of length m*m, work has length b->lwork.
+ */
+static void cs_sdp(ntblock *b, double *s, double *z, double *lmbda,
+    double *Ls, double *Lz, double *U, double *work)
+{
+    int m = b->m, len = m*m, int1 = 1, i;
+    double a, dbl0 = 0.0, dbl1 = 1.0;
+
+    b->info = 0;
+    if (!m) return;
+
+    /* Factor sk = Ls*Ls' and zk = Lz*Lz'. */
+    dcopy_(&len, s, &int1, Ls, &int1);
+    dpotrf_("L", &m, Ls, &m, &b->info);
+    if (b->info) return;
+    dcopy_(&len, z, &int1, Lz, &int1);
+    dpotrf_("L", &m, Lz, &m, &b->info);
+    if (b->info) return;
+
+    /* SVD Lz'*Ls = U*diag(lambda_k)*V'. */
+    for (i = 0; i < m; i++) dscal_(&i, &dbl0, Ls + i*m, &int1);
+    dcopy_(&len, Ls, &int1, U, &int1);
+    dtrmm_("L", "L", "T", "N", &m, &m, &dbl1, Lz, &m, U, &m);
+    dgesvd_("O", "N", &m, &m, U, &m, lmbda, NULL, &int1, NULL, &int1,
+        work, &b->lwork, &b->info);
+    if (b->info) return;
+
+    /* r = Lz^{-T} * U * diag(sqrt(lambda_k)),
+     * rti = Lz * U * diag(1 ./ sqrt(lambda_k)) */
+    dcopy_(&len, U, &int1, b->r, &int1);
+    dtrsm_("L", "L", "T", "N", &m, &m, &dbl1, Lz, &m, b->r, &m);
+    dcopy_(&len, U, &int1, b->rti, &int1);
+    dtrmm_("L", "L", "N", "N", &m, &m, &dbl1, Lz, &m, b->rti, &m);
+    for (i = 0; i < m; i++){
+        a = sqrt(lmbda[i]);
+        dscal_(&m, &a, b->r + m*i, &int1);
+        a = 1.0/a;
+        dscal_(&m, &a, b->rti + m*i, &int1);
+    }
+}
+
+/*
+ * Update for a 'q' block of update_scaling().  s and z are the new
+ * iterates in the current scaling.
+ */
+static void us_socp(ntblock *b, double *s, double *z, double *lmbda)
+{
+    int m = b->m, len = m - 1, int1 = 1;
+    double a, aa, bb, cc, dd, vs, vz, vq, vu, wk0, *v = b->v;
+
+    /* s := s / a, z := z / b with a = sqrt( st' * J * st ),
+     * b = sqrt( zt' * J * zt ) */
+    a = dnrm2_(&len, s + 1, &int1);
+    aa = sqrt(s[0] - a) * sqrt(s[0] + a);
+    a = 1.0/aa;
+    dscal_(&m, &a, s, &int1);
+    a = dnrm2_(&len, z + 1, &int1);
+    bb = sqrt(z[0] - a) * sqrt(z[0] + a);
+    a = 1.0/bb;
+    dscal_(&m, &a, z, &int1);
+
+    /* c = sqrt( ( 1 + (st'*zt) / (a*b) ) / 2 ) */
+    cc = sqrt( ( 1.0 + ddot_(&m, s, &int1, z, &int1) ) / 2.0 );
+
+    /* vs = v' * st / a, vz = v' * J * zt / b, vq = v' * q,
+     * vu = v' * u */
+    vs = ddot_(&m, v, &int1, s, &int1);
+    vz = v[0] * z[0] - ddot_(&len, v + 1, &int1, z + 1, &int1);
+    vq = (vs + vz ) / 2.0 / cc;
+    vu = vs - vz;
+
+    /* lambda_k0 = c,
+     * lambda_k1 = 2 * v_k1 * vk' * (-d*q + u/2) - d*q1 + u1/2 */
+    lmbda[0] = cc;
+    wk0 = 2 * v[0] * vq - ( s[0] + z[0] ) / 2.0 / cc;
+    dd = (v[0] * vu - s[0]/2.0 + z[0]/2.0) / (wk0 + 1.0);
+    dcopy_(&len, v + 1, &int1, lmbda + 1, &int1);
+    a = 2.0 * (-dd * vq + 0.5 * vu);
+    dscal_(&len, &a, lmbda + 1, &int1);
+    a = 0.5 * (1.0 - dd/cc);
+    daxpy_(&len, &a, s + 1, &int1, lmbda + 1, &int1);
+    a = 0.5 * (1.0 + dd/cc);
+    daxpy_(&len, &a, z + 1, &int1, lmbda + 1, &int1);
+    a = sqrt(aa*bb);
+    dscal_(&m, &a, lmbda, &int1);
+
+    /* v := (2*v*v' - J) * q, v := v^{1/2} */
+    a = 2.0 * vq;
+    dscal_(&m, &a, v, &int1);
+    v[0] -= s[0] / 2.0 / cc;
+    a = 0.5/cc;
+    daxpy_(&len, &a, s + 1, &int1, v + 1, &int1);
+    a = -0.5/cc;
+    daxpy_(&m, &a, z, &int1, v, &int1);
+    v[0] += 1.0;
+    a = 1.0 / sqrt(2.0 * v[0]);
+    dscal_(&m, &a, v, &int1);
+
+    b->beta *= sqrt( aa / bb );
+}
+
+/*
+ * Update for an 's' block of update_scaling().  s and z contain the
+ * factors Ls and Lz, and are overwritten with U and V' in the SVD
+ * Lz'*Ls = U * diag(lambda_k) * V'.  C is a workspace of length m*m,
+ * work has length b->lwork.
+ */
+static void us_sdp(ntblock *b, double *s, double *z, double *lmbda,
+    double *C, double *work)
+{
+    int m = b->m, len = m*m, int1 = 1, i;
+    double a, dbl0 = 0.0, dbl1 = 1.0;
+
+    b->info = 0;
+    if (!m) return;
+
+    /* r := r*Ls, rti := rti*Lz */
+    dgemm_("N", "N", &m, &m, &m, &dbl1, b->r, &m, s, &m, &dbl0, C, &m);
+    dcopy_(&len, C, &int1, b->r, &int1);
+    dgemm_("N", "N", &m, &m, &m, &dbl1, b->rti, &m, z, &m, &dbl0, C, &m);
+    dcopy_(&len, C, &int1, b->rti, &int1);
+
+    /* SVD Lz'*Ls = U * lmbds^+ * V'; store U in s and V' in z. */
+    dgemm_("T", "N", &m, &m, &m, &dbl1, z, &m, s, &m, &dbl0, C, &m);
+    dgesvd_("A", "A", &m, &m, C, &m, lmbda, s, &m, z, &m, work,
+        &b->lwork, &b->info);
+    if (b->info) return;
+
+    /* r := r*V, rti := rti*U */
+    dgemm_("N", "T", &m, &m, &m, &dbl1, b->r, &m, z, &m, &dbl0, C, &m);
+    dcopy_(&len, C, &int1, b->r, &int1);
+    dgemm_("N", "N", &m, &m, &m, &dbl1, b->rti, &m, s, &m, &dbl0, C, &m);
+    dcopy_(&len, C, &int1, b->rti, &int1);
+
+    /* r := r*lambda^{-1/2}; rti := rti*lambda^{-1/2} */
+    for (i = 0; i < m; i++){
+        a = 1.0 / sqrt(lmbda[i]);
+        dscal_(&m, &a, b->r + m*i, &int1);
+        dscal_(&m, &a, b->rti + m*i, &int1);
+    }
+}
+
+/*
+ * Sets b[k].lwork to the workspace size of dgesvd for the 's' blocks,
+ * with jobu = jobvt = 'A' if full is nonzero and jobu = 'O',
+ * jobvt = 'N' otherwise.  Returns the maximum.
+ */
+static int gesvd_lwork(ntblock *b, int n, int full)
+{
+    int k, m, ldU, lwork, info, maxlw = 0;
+    double wl;
+
+    for (k = 0; k < n; k++){
+        if (!(m = b[k].m)) continue;
+        ldU = full ? m : 1;
+        lwork = -1;
+        dgesvd_(full ? "A" : "O", full ? "A" : "N", &m, &m, NULL, &m, NULL,
+            NULL, &ldU, NULL, &ldU, &wl, &lwork, &info);
+        b[k].lwork = (int) wl;
+        maxlw = MAX(maxlw, b[k].lwork);
+    }
+    return maxlw;
+}
+
+/* Returns the first nonzero b[k].info, or 0. */
+static int blocks_info(ntblock *b, int n)
+{
+    int k;
+    for (k = 0; k < n; k++) if (b[k].info) return b[k].info;
+    return 0;
+}
+
+static char doc_compute_scaling[] =
+    "Returns the Nesterov-Todd scaling W at points s and z, and stores\n"
+    "the scaled variable in lmbda.\n\n"
+    "W = compute_scaling(s, z, lmbda, dims, mnl = None, W = None)\n\n"
+    "    W * z = W^{-T} * s = lmbda.\n\n"
+    "W is a dictionary with the entries described in scale().  The\n"
+    "entries 'dnl' and 'dnli' are only present if mnl is not None.\n"
+    "If the argument W is a dictionary, the scaling is stored in W and\n"
+    "the matrices of W are overwritten if they have the correct size.\n\n"
+    "The 'q' and 's' blocks are processed in parallel if the module is\n"
+    "compiled with OpenMP support.  The results are identical to those\n"
+    "of the Python version in cvxopt.misc.";
+
+static PyObject* compute_scaling(PyObject *self, PyObject *args,
+    PyObject *kwrds)
+{
+    matrix *s, *z, *lmbda, *dnl = NULL, *dnli = NULL, *d, *di;
+    PyObject *dims, *mnlO = Py_None, *W = Py_None, *v, *r, *rti;
+    ntblock *qb = NULL, *sb = NULL;
+    int i, k, mnl = 0, ml, nq, ns, ind, ind2, maxq, maxn, nw = 0, info;
+    double *ws = NULL, *wk;
+    char *kwlist[] = {"s", "z", "lmbda", "dims", "mnl", "W", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|OO", kwlist, &s,
+        &z, &lmbda, &dims, &mnlO, &W)) return NULL;
+    if (W == Py_None){
+        if (!(W = PyDict_New())) return NULL;
+    }
+    else if (!PyDict_Check(W)){
+        PyErr_SetString(PyExc_TypeError, "W must be a dictionary");
+        return NULL;
+    }
+    else
+        Py_INCREF(W);
+
+#if PY_MAJOR_VERSION >= 3
+    if (mnlO != Py_None) mnl = (int) PyLong_AsLong(mnlO);
+    ml = (int) PyLong_AsLong(PyDict_GetItemString(dims, "l"));
+#else
+    if (mnlO != Py_None) mnl = (int) PyInt_AsLong(mnlO);
+    ml = (int) PyInt_AsLong(PyDict_GetItemString(dims, "l"));
+#endif
+
+    ind = ind2 = mnl + ml;
+    if (!(qb = dims_blocks(dims, "q", &ind, &ind2, &nq, &maxq)) ||
+        !(sb = dims_blocks(dims, "s", &ind, &ind2, &ns, &maxn))) goto nomem;
+    if (len(s) < ind2 || len(z) < ind2 || len(lmbda) < ind){
+        PyErr_SetString(PyExc_TypeError, "incompatible dimensions of s, "
+            "z or lmbda");
+        goto error;
+    }
+
+    if (mnlO != Py_None){
+        if (!(dnl = W_matrix(W, "dnl", mnl, 1)) ||
+            !(dnli = W_matrix(W, "dnli", mnl, 1))) goto error;
+    }
+    else {
+        if (PyDict_GetItemString(W, "dnl")) PyDict_DelItemString(W, "dnl");
+        if (PyDict_GetItemString(W, "dnli"))
+            PyDict_DelItemString(W, "dnli");
+    }
+    if (!(d = W_matrix(W, "d", ml, 1)) || !(di = W_matrix(W, "di", ml, 1))
+        || !(v = W_list(W, "v", qb, nq, 0)) || !(r = W_list(W, "r", sb, ns,
+        1)) || !(rti = W_list(W, "rti", sb, ns, 1))) goto error;
+    for (k = 0; k < nq; k++)
+        qb[k].v = MAT_BUFD(PyList_GET_ITEM(v, k));
+    for (k = 0; k < ns; k++){
+        sb[k].r = MAT_BUFD(PyList_GET_ITEM(r, k));
+        sb[k].rti = MAT_BUFD(PyList_GET_ITEM(rti, k));
+    }
+
+    if (ns){
+        nw = 3*maxn*maxn + gesvd_lwork(sb, ns, 0);
+        if (!(ws = (double *) malloc(MAX_THREADS * nw * sizeof(double))))
+            goto nomem;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+
+    /*
+     * Nonlinear and 'l' blocks:
+     *
+     *     W['dnl'] = sqrt( s[:mnl] ./ z[:mnl] ),  W['dnli'] = W['dnl'].^-1
+     *     W['d'] = sqrt( sk ./ zk ),  W['di'] = W['d'].^-1
+     *     lambda_k = sqrt( sk .* zk ).
+     */
+    for (i = 0; i < mnl; i++){
+        MAT_BUFD(dnl)[i] = sqrt(MAT_BUFD(s)[i] / MAT_BUFD(z)[i]);
+        MAT_BUFD(dnli)[i] = pow(MAT_BUFD(dnl)[i], -1.0);
+    }
+    for (i = 0; i < ml; i++){
+        MAT_BUFD(d)[i] = sqrt(MAT_BUFD(s)[mnl+i] / MAT_BUFD(z)[mnl+i]);
+        MAT_BUFD(di)[i] = pow(MAT_BUFD(d)[i], -1.0);
+    }
+    for (i = 0; i < mnl + ml; i++)
+        MAT_BUFD(lmbda)[i] = sqrt(MAT_BUFD(s)[i] * MAT_BUFD(z)[i]);
+
+    /* 'q' and 's' blocks. */
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(PARALLEL_BLOCKS(nq, maxq))
+#endif
+    for (k = 0; k < nq; k++)
+        cs_socp(qb + k, MAT_BUFD(s) + qb[k].ind2, MAT_BUFD(z) +
+            qb[k].ind2, MAT_BUFD(lmbda) + qb[k].ind);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) private(wk) \
+        if(PARALLEL_BLOCKS(ns, maxn))
+#endif
+    for (k = 0; k < ns; k++){
+        wk = ws + THREAD_NUM * nw;
+        cs_sdp(sb + k, MAT_BUFD(s) + sb[k].ind2, MAT_BUFD(z) + sb[k].ind2,
+            MAT_BUFD(lmbda) + sb[k].ind, wk, wk + maxn*maxn, wk +
+            2*maxn*maxn, wk + 3*maxn*maxn);
+    }
+
+    Py_END_ALLOW_THREADS
+
+    if ((info = blocks_info(sb, ns))){
+        PyErr_SetObject(PyExc_ArithmeticError, Py_BuildValue("i", info));
+        goto error;
+    }
+    if (W_beta(W, qb, nq)) goto error;
+    free(qb);  free(sb);  free(ws);
+    return W;
+
+nomem:
+    PyErr_NoMemory();
+error:
+    free(qb);  free(sb);  free(ws);
+    Py_DECREF(W);
+    return NULL;
+}
+
+static char doc_update_scaling[] =
+    "Updates the Nesterov-Todd scaling matrix W and the scaled variable\n"
+    "lmbda so that on exit\n\n"
+    "    W * zt = W^{-T} * st = lmbda.\n\n"
+    "update_scaling(W, lmbda, s, z)\n\n"
+    "On entry, the nonlinear, 'l' and 'q' components of the arguments s\n"
+    "and z contain W^{-T}*st and W*zt, i.e, the new iterates in the\n"
+    "current scaling.\n\n"
+    "The 's' components contain the factors Ls, Lz in a factorization\n"
+    "of the new iterates in the current scaling, W^{-T}*st = Ls*Ls',\n"
+    "W*zt = Lz*Lz'.\n\n"
+    "W is updated in place.  The 'q' and 's' blocks are processed in\n"
+    "parallel if the module is compiled with OpenMP support.";
+
+static PyObject* update_scaling(PyObject *self, PyObject *args,
+    PyObject *kwrds)
+{
+    matrix *lmbda, *s, *z, *dnl, *dnli = NULL, *d, *di, *A;
+    PyObject *W, *v, *beta, *r, *rti;
+    ntblock *qb = NULL, *sb = NULL;
+    int i, k, mnl = 0, ml, m, nq, ns, ind, ind2, maxq = 0, maxn = 0,
+        nw = 0, int0 = 0, int1 = 1, info;
+    double *ws = NULL, *wk;
+    char *kwlist[] = {"W", "lmbda", "s", "z", NULL};
+    char *keys[] = {"d", "di", "v", "beta", "r", "rti"};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O!OOO", kwlist,
+        &PyDict_Type, &W, &lmbda, &s, &z)) return NULL;
+    for (k = 0; k < 6; k++)
+        if (!PyDict_GetItemString(W, keys[k])){
+            PyErr_Format(PyExc_KeyError, "missing item W['%s']", keys[k]);
+            return NULL;
+        }
+    if ((dnl = (matrix *) PyDict_GetItemString(W, "dnl"))){
+        if (!(dnli = (matrix *) PyDict_GetItemString(W, "dnli"))){
+            PyErr_SetString(PyExc_KeyError, "missing item W['dnli']");
+            return NULL;
+        }
+        mnl = len(dnl);
+    }
+    d = (matrix *) PyDict_GetItemString(W, "d");
+    di = (matrix *) PyDict_GetItemString(W, "di");
+    v = PyDict_GetItemString(W, "v");
+    beta = PyDict_GetItemString(W, "beta");
+    r = PyDict_GetItemString(W, "r");
+    rti = PyDict_GetItemString(W, "rti");
+    ml = len(d);
+    m = mnl + ml;
+
+    nq = (int) PyList_Size(v);
+    ns = (int) PyList_Size(r);
+    if (!(qb = (ntblock *) calloc(MAX(1, nq), sizeof(ntblock))) ||
+        !(sb = (ntblock *) calloc(MAX(1, ns), sizeof(ntblock)))){
+        free(qb);
+        return PyErr_NoMemory();
+    }
+    for (k = 0, ind = m; k < nq; k++){
+        A = (matrix *) PyList_GetItem(v, (Py_ssize_t) k);
+        qb[k].m = len(A);
+        qb[k].v = MAT_BUFD(A);
+        qb[k].beta = PyFloat_AsDouble(PyList_GetItem(beta, (Py_ssize_t) k));
+        qb[k].ind = qb[k].ind2 = ind;
+        ind += qb[k].m;
+        maxq = MAX(maxq, qb[k].m);
+    }
+    for (k = 0, ind2 = ind; k < ns; k++){
+        A = (matrix *) PyList_GetItem(r, (Py_ssize_t) k);
+        sb[k].m = MAT_NROWS(A);
+        sb[k].r = MAT_BUFD(A);
+        sb[k].rti = MAT_BUFD(PyList_GetItem(rti, (Py_ssize_t) k));
+        sb[k].ind = ind;
+        sb[k].ind2 = ind2;
+        ind += sb[k].m;
+        ind2 += sb[k].m * sb[k].m;
+        maxn = MAX(maxn, sb[k].m);
+    }
+    if (PyErr_Occurred()) goto error;
+    if (len(s) < ind2 || len(z) < ind2 || len(lmbda) < ind){
+        PyErr_SetString(PyExc_TypeError, "incompatible dimensions of s, "
+            "z or lmbda");
+        goto error;
+    }
+
+    if (ns){
+        nw = maxn*maxn + gesvd_lwork(sb, ns, 1);
+        if (!(ws = (double *) malloc(MAX_THREADS * nw * sizeof(double)))){
+            PyErr_NoMemory();
+            goto error;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+
+    /*
+     * Nonlinear and 'l' blocks:
+     *
+     *    d :=  d .* sqrt( s ./ z )
+     *    lmbda := lmbda .* sqrt(s) .* sqrt(z)
+     */
+    for (i = 0; i < m; i++){
+        MAT_BUFD(s)[i] = sqrt(MAT_BUFD(s)[i]);
+        MAT_BUFD(z)[i] = sqrt(MAT_BUFD(z)[i]);
+    }
+    if (dnl){
+        dtbmv_("L", "N", "N", &mnl, &int0, MAT_BUFD(s), &int1,
+            MAT_BUFD(dnl), &int1);
+        dtbsv_("L", "N", "N", &mnl, &int0, MAT_BUFD(z), &int1,
+            MAT_BUFD(dnl), &int1);
+        for (i = 0; i < mnl; i++)
+            MAT_BUFD(dnli)[i] = pow(MAT_BUFD(dnl)[i], -1.0);
+    }
+    dtbmv_("L", "N", "N", &ml, &int0, MAT_BUFD(s) + mnl, &int1,
+        MAT_BUFD(d), &int1);
+    dtbsv_("L", "N", "N", &ml, &int0, MAT_BUFD(z) + mnl, &int1,
+        MAT_BUFD(d), &int1);
+    for (i = 0; i < ml; i++)
+        MAT_BUFD(di)[i] = pow(MAT_BUFD(d)[i], -1.0);
+    dcopy_(&m, MAT_BUFD(s), &int1, MAT_BUFD(lmbda), &int1);
+    dtbmv_("L", "N", "N", &m, &int0, MAT_BUFD(z), &int1, MAT_BUFD(lmbda),
+        &int1);
+
+    /* 'q' and 's' blocks. */
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(PARALLEL_BLOCKS(nq, maxq))
+#endif
+    for (k = 0; k < nq; k++)
+        us_socp(qb + k, MAT_BUFD(s) + qb[k].ind2, MAT_BUFD(z) +
+            qb[k].ind2, MAT_BUFD(lmbda) + qb[k].ind);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) private(wk) \
+        if(PARALLEL_BLOCKS(ns, maxn))
+#endif
+    for (k = 0; k < ns; k++){
+        wk = ws + THREAD_NUM * nw;
+        us_sdp(sb + k, MAT_BUFD(s) + sb[k].ind2, MAT_BUFD(z) + sb[k].ind2,
+            MAT_BUFD(lmbda) + sb[k].ind, wk, wk + maxn*maxn);
+    }
+
+    Py_END_ALLOW_THREADS
+
+    if ((info = blocks_info(sb, ns))){
+        PyErr_SetObject(PyExc_ArithmeticError, Py_BuildValue("i", info));
+        goto error;
+    }
+    if (W_beta(W, qb, nq)) goto error;
+    free(qb);  free(sb);  free(ws);
+    return Py_BuildValue("");
+
+error:
+    free(qb);  free(sb);  free(ws);
+    return NULL;
+}
+
+/*
+ * Column j of the 's' block of G with offset ind2 and order m: the
+ * entries (a, b, f) of its lower triangular part, with f halved on the
+ * diagonal, so that the symmetric matrix is sum f * (E_ab + E_ba).
+ */
+typedef struct {
+    int a, b;
+    double f;
+} scentry;
+
+/*
+ * Adds to column i of H the entries H[j, i], j >= i, of the Schur
+ * complement of an 's' block, with V = rti * rti' and the columns F_j of
+ * G stored in e[cp[j] : cp[j+1]].  If f2 is nonzero, B = V * F_i * V is
+ * computed first (in the workspace w of length 3*m*m + m, using only
+ * the rows of F_i that are not zero), and
+ *
+ *     H[j, i] += tr(F_j * B) = 2 * sum g * B[p, q].
+ *
+ * Otherwise
+ *
+ *     H[j, i] += 2 * sum f * g * (V[a, p] * V[b, q] + V[a, q] * V[b, p])
+ *
+ * over the entries (a, b, f) of F_i and (p, q, g) of F_j.
+ */
+static void schur_col(int i, int n, int m, double *V, scentry *e, int *cp,
+    int f2, double *H, double *w)
+{
+    int j, k, l, nr = 0, a, b, *row = (int *) (w + 3*m*m);
+    double *T = w, *Vr = w + m*m, *B = w + 2*m*m, dbl0 = 0.0, dbl1 = 1.0,
+        hji;
+
+    if (f2){
+
+        /* Rows of F_i that are not zero, and T = F_i[rows, :] * V. */
+        for (k = 0; k < m; k++) row[k] = -1;
+        for (k = cp[i]; k < cp[i+1]; k++){
+            if (row[e[k].a] < 0) row[e[k].a] = nr++;
+            if (row[e[k].b] < 0) row[e[k].b] = nr++;
+        }
+        for (k = 0; k < nr*m; k++) T[k] = 0.0;
+        for (k = cp[i]; k < cp[i+1]; k++){
+            a = e[k].a;  b = e[k].b;
+            for (l = 0; l < m; l++){
+                T[row[a] + l*nr] += e[k].f * V[b + l*m];
+                T[row[b] + l*nr] += e[k].f * V[a + l*m];
+            }
+        }
+
+        /* B = V[:, rows] * T = V[rows, :]' * T. */
+        for (k = 0; k < m; k++)
+            if (row[k] >= 0) dcopy_(&m, V + k, &m, Vr + row[k], &nr);
+        dgemm_("T", "N", &m, &m, &nr, &dbl1, Vr, &nr, T, &nr, &dbl0, B,
+            &m);
+        for (j = i; j < n; j++){
+            for (k = cp[j], hji = 0.0; k < cp[j+1]; k++)
+                hji += e[k].f * B[e[k].a + e[k].b * m];
+            H[j + i*n] += 2.0 * hji;
+        }
+    }
+    else {
+        for (j = i; j < n; j++){
+            hji = 0.0;
+            for (k = cp[i]; k < cp[i+1]; k++)
+                for (l = cp[j]; l < cp[j+1]; l++)
+                    hji += e[k].f * e[l].f * (V[e[k].a + e[l].a * m] *
+                        V[e[k].b + e[l].b * m] + V[e[k].a + e[l].b * m] *
+                        V[e[k].b + e[l].a * m]);
+            H[j + i*n] += 2.0 * hji;
+        }
+    }
+}
+
+static char doc_schur[] =
+    "Adds the 's' blocks of G' * W^{-1} * W^{-T} * G to H.\n\n"
+    "schur(G, W, H, dims)\n\n"
+    "G is a sparse 'd' matrix of size (N, n) with\n\n"
+    "    N = dims['l'] + sum(dims['q']) + sum( k**2 for k in dims['s'] ),"
+    "\n\n"
+    "and only the lower triangular parts of its 's' blocks are\n"
+    "referenced.  W is a scaling dictionary as in scale().  On exit the\n"
+    "lower triangular part of the 'd' matrix H of order n is\n\n"
+    "    H := H + sum_k Gk' * W_k^{-1} * W_k^{-T} * Gk,\n\n"
+    "where the sum is over the 's' blocks and Gk are the rows of G for\n"
+    "block k.  With V = rti * rti' and F_i the symmetric matrix in\n"
+    "column i of Gk, the (j, i) entry of block k is tr(F_j * V * F_i *\n"
+    "V).  For each column i, either B = V * F_i * V is computed from the\n"
+    "nonzero rows of F_i and the sum is over the nonzeros of F_j, or the\n"
+    "sum is over pairs of nonzeros of F_i and F_j, whichever is cheaper\n"
+    "(the formulas F2 and F3 of SDPA).  The number of operations is\n"
+    "therefore proportional to the number of nonzeros of G instead of\n"
+    "the size of the blocks.  The columns are processed in parallel if\n"
+    "the module is compiled with OpenMP support.";
+
+static PyObject* schur(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    PyObject *G, *W, *dims, *rti;
+    matrix *H, *R;
+    ntblock *sb = NULL;
+    scentry *e = NULL;
+    int n, ns, maxn, ind = 0, ind2 = 0, i, j, k, m, nnz, lo, hi, r, *cp =
+        NULL, *f2 = NULL, nthreads;
+    int_t *colptr, *rowind;
+    double *V = NULL, *w = NULL, *val, dbl0 = 0.0, dbl1 = 1.0, c2, c3,
+        rest;
+    char *kwlist[] = {"G", "W", "H", "dims", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO!OO!", kwlist, &G,
+        &PyDict_Type, &W, &H, &PyDict_Type, &dims)) return NULL;
+    if (!SpMatrix_Check(G) || SP_ID(G) != DOUBLE){
+        PyErr_SetString(PyExc_TypeError, "G must be a sparse 'd' matrix");
+        return NULL;
+    }
+    n = (int) SP_NCOLS(G);
+    if (!Matrix_Check(H) || MAT_ID(H) != DOUBLE || H->nrows != n ||
+        H->ncols != n){
+        PyErr_SetString(PyExc_TypeError, "H must be a 'd' matrix of order "
+            "G.size[1]");
+        return NULL;
+    }
+    if (!(rti = PyDict_GetItemString(W, "rti"))){
+        PyErr_SetString(PyExc_KeyError, "missing item W['rti']");
+        return NULL;
+    }
+#if PY_MAJOR_VERSION >= 3
+    ind2 = (int) PyLong_AsLong(PyDict_GetItemString(dims, "l"));
+#else
+    ind2 = (int) PyInt_AsLong(PyDict_GetItemString(dims, "l"));
+#endif
+    if (!(sb = dims_blocks(dims, "q", &ind, &ind2, &ns, &maxn))) return
+        PyErr_NoMemory();
+    free(sb);
+    if (!(sb = dims_blocks(dims, "s", &ind, &ind2, &ns, &maxn))) return
+        PyErr_NoMemory();
+    if (PyErr_Occurred()) goto error;
+    if (SP_NROWS(G) < ind2 || PyList_Size(rti) != ns){
+        PyErr_SetString(PyExc_TypeError, "incompatible dimensions of G, W "
+            "or dims");
+        goto error;
+    }
+    colptr = SP_COL(G);
+    rowind = SP_ROW(G);
+    val = SP_VALD(G);
+    nthreads = MAX_THREADS;
+    if (!(e = (scentry *) malloc(MAX(1, SP_NNZ(G)) * sizeof(scentry))) ||
+        !(cp = (int *) malloc((n+1) * sizeof(int))) ||
+        !(f2 = (int *) malloc(MAX(1, n) * sizeof(int))) ||
+        !(V = (double *) malloc(MAX(1, maxn*maxn) * sizeof(double))) ||
+        !(w = (double *) malloc(nthreads * (3*maxn*maxn + maxn) *
+        sizeof(double)))){
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    for (k = 0; k < ns; k++){
+        m = sb[k].m;
+        R = (matrix *) PyList_GetItem(rti, (Py_ssize_t) k);
+        if (!Matrix_Check(R) || R->nrows != m || R->ncols != m){
+            PyErr_SetString(PyExc_TypeError, "incompatible dimensions of "
+                "W['rti'] and dims");
+            goto error;
+        }
+
+        /* The lower triangular entries of the columns of the block. */
+        for (j = 0, nnz = 0; j < n; j++){
+            cp[j] = nnz;
+            for (lo = (int) colptr[j], hi = (int) colptr[j+1]; lo < hi &&
+                rowind[lo] < sb[k].ind2; lo++);
+            for (; lo < hi && rowind[lo] < sb[k].ind2 + m*m; lo++){
+                r = (int) rowind[lo] - sb[k].ind2;
+                if (r % m < r / m || val[lo] == 0.0) continue;
+                e[nnz].a = r % m;
+                e[nnz].b = r / m;
+                e[nnz].f = (e[nnz].a == e[nnz].b) ? 0.5 * val[lo] :
+                    val[lo];
+                nnz++;
+            }
+        }
+        cp[n] = nnz;
+        if (!nnz) continue;
+
+        /* F2 if it requires fewer operations than F3. */
+        for (j = n-1, rest = 0.0; j >= 0; j--){
+            rest += cp[j+1] - cp[j];
+            c2 = 2.0 * m * m * MIN(m, 2*(cp[j+1] - cp[j])) + rest;
+            c3 = 4.0 * (cp[j+1] - cp[j]) * rest;
+            f2[j] = (c2 < c3);
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        dsyrk_("L", "N", &m, &m, &dbl1, MAT_BUFD(R), &m, &dbl0, V, &m);
+        for (j = 0; j < m; j++)
+            for (i = j + 1; i < m; i++) V[j + i*m] = V[i + j*m];
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic) num_threads(nthreads) \
+            if(n > 1 && nnz > SMALL_BLOCK*SMALL_BLOCK)
+#endif
+        for (i = 0; i < n; i++)
+            if (cp[i+1] > cp[i])
+                schur_col(i, n, m, V, e, cp, f2[i], MAT_BUFD(H), w +
+                    THREAD_NUM * (3*maxn*maxn + maxn));
+        Py_END_ALLOW_THREADS
+    }
+
+    free(sb);  free(e);  free(cp);  free(f2);  free(V);  free(w);
+    return Py_BuildValue("");
+
+error:
+    free(sb);  free(e);  free(cp);  free(f2);  free(V);  free(w);
+    return NULL;
+}
+
+
+static char doc_nlfunction[] =
+    "Evaluates a nonlinear function implemented in C.\n\n"
+    "m, n, x0 = nlfunction(F)\n"
+    "indom = nlfunction(F, x, z, f, Df, H)\n\n"
+    "F is a PyCapsule with a pointer to a cvxopt_nlfunction (see\n"
+    "cvxopt.h).  With only the argument F, returns the dimensions and\n"
+    "a copy of the starting point.  Otherwise evaluates the functions at\n"
+    "the 'd' matrix x of length n and stores the values in the 'd'\n"
+    "matrices f (length m) and Df (size (m,n)).  If z is not None, a\n"
+    "'d' matrix of length m, also stores sum_k z[k] * f_k''(x) in the\n"
+    "'d' matrix H of size (n,n).  Returns False if x is not in the\n"
+    "domain, and True otherwise.";
+
+static PyObject* nlfunction(PyObject *self, PyObject *args, PyObject
+    *kwrds)
+{
+    PyObject *F, *x = Py_None, *z = Py_None, *f = Py_None, *Df = Py_None,
+        *H = Py_None;
+    cvxopt_nlfunction *nl;
+    matrix *x0;
+    int i, j, m, n, info;
+    char *kwlist[] = {"F", "x", "z", "f", "Df", "H", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|OOOOO", kwlist, &F,
+        &x, &z, &f, &Df, &H)) return NULL;
+    if (!PyCapsule_IsValid(F, CVXOPT_NLFUNCTION))
+        PY_ERR_TYPE("F must be a PyCapsule with name '" CVXOPT_NLFUNCTION
+            "'");
+    nl = (cvxopt_nlfunction *) PyCapsule_GetPointer(F, CVXOPT_NLFUNCTION);
+    m = nl->m;  n = nl->n;
+    if (m < 0 || n < 1 || !nl->eval)
+        PY_ERR(PyExc_ValueError, "invalid cvxopt_nlfunction");
+
+    if (x == Py_None){
+        if (!(x0 = Matrix_New(n, 1, DOUBLE))) return NULL;
+        for (i = 0; i < n; i++) MAT_BUFD(x0)[i] = nl->x0 ? nl->x0[i] : 0.0;
+        return Py_BuildValue("iiN", m, n, x0);
+    }
+
+    if (!Matrix_Check(x) || MAT_ID(x) != DOUBLE || MAT_LGT(x) != n)
+        PY_ERR_TYPE("x must be a 'd' matrix of length n");
+    if (!Matrix_Check(f) || MAT_ID(f) != DOUBLE || MAT_LGT(f) != m)
+        PY_ERR_TYPE("f must be a 'd' matrix of length m");
+    if (!Matrix_Check(Df) || MAT_ID(Df) != DOUBLE || MAT_NROWS(Df) != m
+        || MAT_NCOLS(Df) != n)
+        PY_ERR_TYPE("Df must be a 'd' matrix of size (m,n)");
+    if (z != Py_None && (!Matrix_Check(z) || MAT_ID(z) != DOUBLE ||
+        MAT_LGT(z) != m || !Matrix_Check(H) || MAT_ID(H) != DOUBLE ||
+        MAT_NROWS(H) != n || MAT_NCOLS(H) != n))
+        PY_ERR_TYPE("z and H must be 'd' matrices of length m and size "
+            "(n,n)");
+
+    Py_BEGIN_ALLOW_THREADS
+    info = nl->eval(MAT_BUFD(x), z == Py_None ? NULL : MAT_BUFD(z),
+        MAT_BUFD(f), MAT_BUFD(Df), z == Py_None ? NULL : MAT_BUFD(H),
+        nl->params);
+    if (info == 0 && z != Py_None)
+        for (j = 0; j < n; j++)
+            for (i = j+1; i < n; i++)
+                MAT_BUFD(H)[j + i*n] = MAT_BUFD(H)[i + j*n];
+    Py_END_ALLOW_THREADS
+
+    if (info != 0 && info != 1){
+        PyErr_Format(PyExc_ValueError, "evaluation of the nonlinear "
+            "function failed (eval() returned %d)", info);
+        return NULL;
+    }
+    return PyBool_FromLong(info == 0);
+}
+
+
+static char doc_nlfunction_batch[] =
+    "Evaluates a nonlinear function implemented in C at several points.\n\n"
+    "indom = nlfunction_batch(F, X, f, Df, nthreads = 1)\n\n"
+    "F is a PyCapsule with a pointer to a cvxopt_nlfunction (see\n"
+    "cvxopt.h).  X, f and Df are lists of k 'd' matrices, with X[i]\n"
+    "of length n, f[i] of length m and Df[i] of size (m,n).  Evaluates\n"
+    "the functions and their derivatives at X[i] in f[i], Df[i], for\n"
+    "i = 0, ..., k-1, using nthreads OpenMP threads.  The eval()\n"
+    "function of F must be thread-safe if nthreads is greater than\n"
+    "one.  Returns a list of k booleans, with indom[i] False if X[i] is\n"
+    "not in the domain.";
+
+static PyObject* nlfunction_batch(PyObject *self, PyObject *args,
+    PyObject *kwrds)
+{
+    PyObject *F, *X, *f, *Df, *indom, *xi, *fi, *Dfi;
+    cvxopt_nlfunction *nl;
+    double **bx, **bf, **bDf;
+    int i, k, m, n, *info, err = 0, nthreads = 1;
+    char *kwlist[] = {"F", "X", "f", "Df", "nthreads", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO!O!O!|i", kwlist, &F,
+        &PyList_Type, &X, &PyList_Type, &f, &PyList_Type, &Df, &nthreads))
+        return NULL;
+    if (!PyCapsule_IsValid(F, CVXOPT_NLFUNCTION))
+        PY_ERR_TYPE("F must be a PyCapsule with name '" CVXOPT_NLFUNCTION
+            "'");
+    nl = (cvxopt_nlfunction *) PyCapsule_GetPointer(F, CVXOPT_NLFUNCTION);
+    m = nl->m;  n = nl->n;
+    if (m < 0 || n < 1 || !nl->eval)
+        PY_ERR(PyExc_ValueError, "invalid cvxopt_nlfunction");
+    if (nthreads < 1) PY_ERR(PyExc_ValueError, "nthreads must be positive");
+    k = (int) PyList_Size(X);
+    if (PyList_Size(f) < k || PyList_Size(Df) < k)
+        PY_ERR_TYPE("f and Df must have at least len(X) elements");
+
+    bx = malloc(3 * MAX(k, 1) * sizeof(double *));
+    info = malloc(MAX(k, 1) * sizeof(int));
+    if (!bx || !info){
+        free(bx);  free(info);
+        return PyErr_NoMemory();
+    }
+    bf = bx + k;  bDf = bx + 2*k;
+    for (i = 0; i < k; i++){
+        xi = PyList_GET_ITEM(X, i);
+        fi = PyList_GET_ITEM(f, i);
+        Dfi = PyList_GET_ITEM(Df, i);
+        if (!Matrix_Check(xi) || MAT_ID(xi) != DOUBLE || MAT_LGT(xi) != n ||
+            !Matrix_Check(fi) || MAT_ID(fi) != DOUBLE || MAT_LGT(fi) != m ||
+            !Matrix_Check(Dfi) || MAT_ID(Dfi) != DOUBLE || MAT_NROWS(Dfi)
+            != m || MAT_NCOLS(Dfi) != n){
+            free(bx);  free(info);
+            PY_ERR_TYPE("X[i], f[i] and Df[i] must be 'd' matrices of "
+                "length n, length m and size (m,n)");
+        }
+        bx[i] = MAT_BUFD(xi);  bf[i] = MAT_BUFD(fi);  bDf[i] = MAT_BUFD(Dfi);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+    for (i = 0; i < k; i++)
+        info[i] = nl->eval(bx[i], NULL, bf[i], bDf[i], NULL, nl->params);
+    Py_END_ALLOW_THREADS
+
+    for (i = 0; i < k; i++)
+        if (info[i] != 0 && info[i] != 1) err = info[i];
+    if (err){
+        free(bx);  free(info);
+        PyErr_Format(PyExc_ValueError, "evaluation of the nonlinear "
+            "function failed (eval() returned %d)", err);
+        return NULL;
+    }
+    if ((indom = PyList_New(k)))
+        for (i = 0; i < k; i++)
+            PyList_SET_ITEM(indom, i, PyBool_FromLong(info[i] == 0));
+    free(bx);  free(info);
+    return indom;
+}
+
+
+/*
+ * Data and results of a dense QP
+ *
+ *     minimize    (1/2)*x'*P*x + q'*x
+ *     subject to  G*x + s = h,  A*x = b,  s >= 0,
+ *
+ * solved by qp_solve().  The matrices are stored in column major order
+ * and only the lower triangle of P is referenced.  P is NULL for an LP.
+ * The iterates are stored in x, s, y, z.
+ */
+typedef struct {
+    int n, m, p, maxiters, correction;
+    double *P, *q, *G, *h, *A, *b, *x, *s, *y, *z;
+    double abstol, reltol, feastol, kktreg;
+    int status, iters, hasrelgap;
+    double pcost, dcost, gap, relgap, pres, dres;
+} qpdata;
+
+enum {QP_OPTIMAL, QP_UNKNOWN, QP_SINGULAR, QP_NOMEM};
+
+static char *qp_status[] = {"optimal", "unknown", "singular"};
+
+/*
+ * Computes the LDL^T factorization of the KKT matrix
+ *
+ *     [ P + r*I      A'     G'*diag(di) ]
+ *     [ A           -r*I    0           ]
+ *     [ diag(di)*G   0     -(1+r)*I     ]
+ *
+ * in K, where r = kktreg and di = sqrt(z./s) is the inverse of the
+ * Nesterov-Todd scaling.  di is taken to be the vector of ones if it is
+ * NULL.  This is the matrix factored by kktsolver 'ldl' in coneqp().
+ */
+static int qp_factor(qpdata *d, double *di, double *K, int *ipiv,
+    double *work, int lwork)
+{
+    int i, j, n = d->n, m = d->m, p = d->p, N = d->n + d->p + d->m,
+        info;
+
+    for (i = 0; i < N*N; i++) K[i] = 0.0;
+    for (j = 0; j < n; j++){
+        if (d->P)
+            for (i = j; i < n; i++) K[i + j*N] = d->P[i + j*n];
+        K[j + j*N] += d->kktreg;
+        for (i = 0; i < p; i++) K[n + i + j*N] = d->A[i + j*p];
+        for (i = 0; i < m; i++)
+            K[n + p + i + j*N] = di ? di[i] * d->G[i + j*m] :
+                d->G[i + j*m];
+    }
+    for (i = n; i < n + p; i++) K[i + i*N] = -d->kktreg;
+    for (i = n + p; i < N; i++) K[i + i*N] = -1.0 - d->kktreg;
+    dsytrf_("L", &N, K, &N, ipiv, work, &lwork, &info);
+    return info;
+}
+
+/*
+ * Solves the linearized optimality conditions
+ *
+ *     P*dx + A'*dy + G'*dz = bx,  A*dx = by,  G*dx + ds = bz,
+ *     z.*ds + s.*dz = bs,
+ *
+ * using the factorization computed by qp_factor() for di = sqrt(z./s).
+ * Eliminating ds gives G*dx - diag(s./z)*dz = bz - bs./z, which is
+ * scaled by diag(di) and solved for dx, dy and dz./di.  On entry the
+ * first n+p entries of u are [bx; by].  On exit u = [dx; dy; dz./di],
+ * bz is overwritten with dz and bs with ds.  Returns 1 if the solution
+ * is not finite.
+ */
+static int qp_kktsolve(qpdata *d, double *di, double *K, int *ipiv,
+    double *u, double *bz, double *bs)
+{
+    int i, n = d->n, m = d->m, p = d->p, N = d->n + d->p + d->m,
+        int1 = 1, info;
+    double nrm;
+
+    for (i = 0; i < m; i++)
+        u[n + p + i] = di[i] * (bz[i] - bs[i] / d->z[i]);
+    dsytrs_("L", &N, &int1, K, &N, ipiv, u, &N, &info);
+    for (i = 0; i < m; i++){
+        bz[i] = di[i] * u[n + p + i];
+        bs[i] = (bs[i] - d->s[i] * bz[i]) / d->z[i];
+    }
+    nrm = dnrm2_(&N, u, &int1);
+    return (nrm != nrm || nrm > DBL_MAX);
+}
+
+/* Returns max {0, max_k -ds_k/s_k, max_k -dz_k/z_k}. */
+static double qp_step(qpdata *d, double *ds, double *dz)
+{
+    int i;
+    double t = 0.0;
+
+    for (i = 0; i < d->m; i++){
+        t = MAX(t, -ds[i] / d->s[i]);
+        t = MAX(t, -dz[i] / d->z[i]);
+    }
+    return t;
+}
+
+/*
+ * Solves the QP in d by the algorithm of coneqp() with kktsolver 'ldl'
+ * for a problem with only 'l' inequalities, without calling back into
+ * Python.  The Nesterov-Todd scaling for the nonnegative orthant is
+ * W = diag(sqrt(s./z)), so the iteration can be expressed in terms of s
+ * and z directly.
+ */
+static void qp_solve(qpdata *d)
+{
+    int n = d->n, m = d->m, p = d->p, N = d->n + d->p + d->m, i, k,
+        int1 = 1, lwork = -1, info, *ipiv;
+    double dbl1 = 1.0, wl, *work, *K, *u, *rx, *ry, *rz, *di, *ds, *dz,
+        *dsdz, resx0, resy0, resz0, nrm, ts, f0, mu, t, step = 1.0,
+        sigma = 0.0, dsdzsum;
+
+    dsytrf_("L", &N, NULL, &N, NULL, &wl, &lwork, &info);
+    lwork = MAX(1, (int) wl);
+    ipiv = (int *) malloc(N * sizeof(int));
+    work = (double *) malloc((lwork + N*N + 2*N + 4*m) * sizeof(double));
+    if (!ipiv || !work){
+        free(ipiv);  free(work);
+        d->status = QP_NOMEM;
+        return;
+    }
+    K = work + lwork;
+    u = K + N*N;
+    rx = u + N;
+    ry = rx + n;
+    rz = ry + p;
+    di = rz + m;
+    ds = di + m;
+    dz = ds + m;
+    dsdz = dz + m;
+
+    resx0 = MAX(1.0, dnrm2_(&n, d->q, &int1));
+    resy0 = MAX(1.0, dnrm2_(&p, d->b, &int1));
+    resz0 = MAX(1.0, dnrm2_(&m, d->h, &int1));
+
+    /*
+     * Initial point.  Solve
+     *
+     *     [ P  A'  G' ] [ x ]   [ -q ]
+     *     [ A  0   0  ] [ y ] = [  b ]
+     *     [ G  0  -I  ] [ z ]   [  h ]
+     *
+     * and take s = -z, shifted into the interior of the cone.
+     */
+    d->iters = 0;  d->hasrelgap = 0;
+    d->pcost = d->dcost = d->gap = d->relgap = d->pres = d->dres = 0.0;
+    if (qp_factor(d, NULL, K, ipiv, work, lwork)){
+        d->status = QP_SINGULAR;
+        free(ipiv);  free(work);
+        return;
+    }
+    for (i = 0; i < n; i++) u[i] = -d->q[i];
+    dcopy_(&p, d->b, &int1, u + n, &int1);
+    dcopy_(&m, d->h, &int1, u + n + p, &int1);
+    dsytrs_("L", &N, &int1, K, &N, ipiv, u, &N, &info);
+    nrm = dnrm2_(&N, u, &int1);
+    if (nrm != nrm || nrm > DBL_MAX){
+        d->status = QP_SINGULAR;
+        free(ipiv);  free(work);
+        return;
+    }
+    dcopy_(&n, u, &int1, d->x, &int1);
+    dcopy_(&p, u + n, &int1, d->y, &int1);
+    dcopy_(&m, u + n + p, &int1, d->z, &int1);
+    for (i = 0; i < m; i++) d->s[i] = -d->z[i];
+    for (k = 0; k < 2; k++){
+        double *v = k ? d->z : d->s;
+        nrm = dnrm2_(&m, v, &int1);
+        for (i = 0, ts = -DBL_MAX; i < m; i++) ts = MAX(ts, -v[i]);
+        if (m && ts >= -1e-8 * MAX(nrm, 1.0))
+            for (i = 0; i < m; i++) v[i] += 1.0 + ts;
+    }
+    d->gap = ddot_(&m, d->s, &int1, d->z, &int1);
+
+    for (d->iters = 0; ; d->iters++){
+
+        /* rx = P*x + q + A'*y + G'*z,  f0 = (1/2)*x'*P*x + q'*x */
+        dcopy_(&n, d->q, &int1, rx, &int1);
+        if (d->P) dsymv_("L", &n, &dbl1, d->P, &n, d->x, &int1, &dbl1, rx,
+            &int1);
+        f0 = 0.5 * (ddot_(&n, d->x, &int1, rx, &int1) +
+            ddot_(&n, d->x, &int1, d->q, &int1));
+        if (p) dgemv_("T", &p, &n, &dbl1, d->A, &p, d->y, &int1, &dbl1, rx,
+            &int1);
+        if (m) dgemv_("T", &m, &n, &dbl1, d->G, &m, d->z, &int1, &dbl1, rx,
+            &int1);
+
+        /* ry = A*x - b,  rz = s + G*x - h */
+        for (i = 0; i < p; i++) ry[i] = -d->b[i];
+        if (p) dgemv_("N", &p, &n, &dbl1, d->A, &p, d->x, &int1, &dbl1, ry,
+            &int1);
+        for (i = 0; i < m; i++) rz[i] = d->s[i] - d->h[i];
+        if (m) dgemv_("N", &m, &n, &dbl1, d->G, &m, d->x, &int1, &dbl1, rz,
+            &int1);
+
+        d->pcost = f0;
+        d->dcost = f0 + ddot_(&p, d->y, &int1, ry, &int1) +
+            ddot_(&m, d->z, &int1, rz, &int1) - d->gap;
+        d->hasrelgap = 1;
+        if (d->pcost < 0.0) d->relgap = d->gap / -d->pcost;
+        else if (d->dcost > 0.0) d->relgap = d->gap / d->dcost;
+        else d->hasrelgap = 0;
+        d->pres = MAX(dnrm2_(&p, ry, &int1) / resy0,
+            dnrm2_(&m, rz, &int1) / resz0);
+        d->dres = dnrm2_(&n, rx, &int1) / resx0;
+
+        /*
+         * Without inequalities the initial point solves the optimality
+         * conditions, up to the accuracy of the factorization, and the
+         * status is 'unknown' if the residuals are not small.
+         */
+        if (d->pres <= d->feastol && d->dres <= d->feastol &&
+            (d->gap <= d->abstol || (d->hasrelgap && d->relgap <=
+            d->reltol))){
+            d->status = QP_OPTIMAL;
+            break;
+        }
+        if (!m || d->iters == d->maxiters){
+            d->status = QP_UNKNOWN;
+            break;
+        }
+
+        for (i = 0; i < m; i++) di[i] = sqrt(d->z[i] / d->s[i]);
+        if (qp_factor(d, di, K, ipiv, work, lwork)){
+            d->status = d->iters ? QP_UNKNOWN : QP_SINGULAR;
+            break;
+        }
+        mu = d->gap / m;
+
+        /*
+         * Predictor (k = 0) and corrector (k = 1) step.  The right-hand
+         * side of the complementarity equation is
+         *
+         *     -s.*z  (k = 0)
+         *     -s.*z - dsa.*dza + sigma*mu  (k = 1),
+         *
+         * with dsa, dza the predictor direction.
+         */
+        for (k = 0; k < 2; k++){
+            for (i = 0; i < n; i++) u[i] = -rx[i];
+            for (i = 0; i < p; i++) u[n + i] = -ry[i];
+            for (i = 0; i < m; i++){
+                dz[i] = -rz[i];
+                ds[i] = -d->s[i] * d->z[i];
+                if (k) ds[i] += sigma * mu - (d->correction ? dsdz[i] : 0.0);
+            }
+            if (qp_kktsolve(d, di, K, ipiv, u, dz, ds)){
+                d->status = d->iters ? QP_UNKNOWN : QP_SINGULAR;
+                break;
+            }
+            t = qp_step(d, ds, dz);
+            if (k == 0){
+                for (i = 0, dsdzsum = 0.0; i < m; i++){
+                    dsdz[i] = ds[i] * dz[i];
+                    dsdzsum += dsdz[i];
+                }
+                step = (t == 0.0) ? 1.0 : MIN(1.0, 1.0 / t);
+                sigma = pow(MIN(1.0, MAX(0.0, 1.0 - step + dsdzsum /
+                    d->gap * step * step)), 3);
+            }
+            else
+                step = (t == 0.0) ? 1.0 : MIN(1.0, 0.99 / t);
+        }
+        if (k < 2) break;
+
+        daxpy_(&n, &step, u, &int1, d->x, &int1);
+        daxpy_(&p, &step, u + n, &int1, d->y, &int1);
+        daxpy_(&m, &step, ds, &int1, d->s, &int1);
+        daxpy_(&m, &step, dz, &int1, d->z, &int1);
+        d->gap = ddot_(&m, d->s, &int1, d->z, &int1);
+    }
+    free(ipiv);  free(work);
+}
+
+/*
+ * Parses a tuple (q, G, h, A, b, P) of dense 'd' matrices into d.  P can
+ * be None.  Allocates the matrices x, s, y, z for the solution in sol.
+ * On failure the entries of sol are NULL.
+ */
+static int qp_parse(PyObject *prob, qpdata *d, matrix **sol)
+{
+    matrix *q, *G, *h, *A, *b;
+    PyObject *P;
+    int n, m, p, k;
+
+    for (k = 0; k < 4; k++) sol[k] = NULL;
+    if (!PyTuple_Check(prob)){
+        PyErr_SetString(PyExc_TypeError, "the problem must be a tuple "
+            "(q, G, h, A, b, P)");
+        return -1;
+    }
+    if (!PyArg_ParseTuple(prob, "OOOOOO", &q, &G, &h, &A, &b, &P))
+        return -1;
+    if (!Matrix_Check(q) || MAT_ID(q) != DOUBLE || MAT_NCOLS(q) != 1 ||
+        MAT_NROWS(q) < 1){
+        PyErr_SetString(PyExc_TypeError, "q must be a nonempty 'd' matrix "
+            "with one column");
+        return -1;
+    }
+    n = MAT_NROWS(q);
+    if (!Matrix_Check(G) || MAT_ID(G) != DOUBLE || MAT_NCOLS(G) != n){
+        PyErr_SetString(PyExc_TypeError, "G must be a 'd' matrix with "
+            "len(q) columns");
+        return -1;
+    }
+    m = MAT_NROWS(G);
+    if (!Matrix_Check(h) || MAT_ID(h) != DOUBLE || MAT_NROWS(h) != m ||
+        MAT_NCOLS(h) != 1){
+        PyErr_SetString(PyExc_TypeError, "incompatible dimensions of h");
+        return -1;
+    }
+    if (!Matrix_Check(A) || MAT_ID(A) != DOUBLE || MAT_NCOLS(A) != n){
+        PyErr_SetString(PyExc_TypeError, "A must be a 'd' matrix with "
+            "len(q) columns");
+        return -1;
+    }
+    p = MAT_NROWS(A);
+    if (!Matrix_Check(b) || MAT_ID(b) != DOUBLE || MAT_NROWS(b) != p ||
+        MAT_NCOLS(b) != 1){
+        PyErr_SetString(PyExc_TypeError, "incompatible dimensions of b");
+        return -1;
+    }
+    if (P != Py_None && (!Matrix_Check(P) || MAT_ID(P) != DOUBLE ||
+        MAT_NROWS(P) != n || MAT_NCOLS(P) != n)){
+        PyErr_SetString(PyExc_TypeError, "P must be None or a 'd' matrix "
+            "of size (len(q), len(q))");
+        return -1;
+    }
+    d->n = n;  d->m = m;  d->p = p;
+    d->q = MAT_BUFD(q);  d->G = MAT_BUFD(G);  d->h = MAT_BUFD(h);
+    d->A = MAT_BUFD(A);  d->b = MAT_BUFD(b);
+    d->P = (P == Py_None) ? NULL : MAT_BUFD(P);
+    if (!(sol[0] = Matrix_New(n, 1, DOUBLE)) ||
+        !(sol[1] = Matrix_New(m, 1, DOUBLE)) ||
+        !(sol[2] = Matrix_New(p, 1, DOUBLE)) ||
+        !(sol[3] = Matrix_New(m, 1, DOUBLE))){
+        for (k = 0; k < 4; k++) Py_CLEAR(sol[k]);
+        PyErr_NoMemory();
+        return -1;
+    }
+    d->x = MAT_BUFD(sol[0]);  d->s = MAT_BUFD(sol[1]);
+    d->y = MAT_BUFD(sol[2]);  d->z = MAT_BUFD(sol[3]);
+    return 0;
+}
+
+/* Returns the tuple (status, x, s, y, z, info) and releases sol. */
+static PyObject* qp_result(qpdata *d, matrix **sol)
+{
+    PyObject *relgap;
+
+    if (d->status == QP_NOMEM){
+        Py_DECREF(sol[0]);  Py_DECREF(sol[1]);
+        Py_DECREF(sol[2]);  Py_DECREF(sol[3]);
+        return PyErr_NoMemory();
+    }
+    if (d->hasrelgap) relgap = PyFloat_FromDouble(d->relgap);
+    else {
+        Py_INCREF(Py_None);
+        relgap = Py_None;
+    }
+    return Py_BuildValue("sNNNN{sisdsdsdsNsdsd}", qp_status[d->status],
+        sol[0], sol[1], sol[2], sol[3], "iterations", d->iters,
+        "primal objective", d->pcost, "dual objective", d->dcost, "gap",
+        d->gap, "relative gap", relgap, "primal infeasibility", d->pres,
+        "dual infeasibility", d->dres);
+}
+
+static char doc_qp[] =
+    "Solves a small dense QP or LP.\n\n"
+    "status, x, s, y, z, info = qp(prob, maxiters = 100, abstol = 1e-7,\n"
+    "    reltol = 1e-6, feastol = 1e-7, kktreg = 0.0, correction = True)\n\n"
+    "prob is a tuple (q, G, h, A, b, P) of dense 'd' matrices that\n"
+    "defines the problem\n\n"
+    "    minimize    (1/2)*x'*P*x + q'*x\n"
+    "    subject to  G*x <= h,  A*x = b.\n\n"
+    "P is None for an LP.  Only the lower triangle of P is referenced.\n"
+    "The algorithm is the algorithm of coneqp(), implemented in C and\n"
+    "executed without holding the global interpreter lock.  The 3 x 3\n"
+    "KKT matrix used by kktsolver 'ldl' in coneqp() is factored as a\n"
+    "dense symmetric indefinite matrix.\n\n"
+    "status is 'optimal', 'unknown' or 'singular'.  'singular' means\n"
+    "that the KKT matrix at the starting point is singular.  info is a\n"
+    "dictionary with the keys 'iterations', 'primal objective',\n"
+    "'dual objective', 'gap', 'relative gap', 'primal infeasibility'\n"
+    "and 'dual infeasibility'.";
+
+static PyObject* qp(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    PyObject *prob;
+    matrix *sol[4];
+    qpdata d;
+    char *kwlist[] = {"prob", "maxiters", "abstol", "reltol", "feastol",
+        "kktreg", "correction", NULL};
+
+    d.maxiters = 100;  d.correction = 1;  d.abstol = 1e-7;
+    d.reltol = 1e-6;  d.feastol = 1e-7;  d.kktreg = 0.0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O!|iddddi", kwlist,
+        &PyTuple_Type, &prob, &d.maxiters, &d.abstol, &d.reltol,
+        &d.feastol, &d.kktreg, &d.correction)) return NULL;
+    if (qp_parse(prob, &d, sol)) return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    qp_solve(&d);
+    Py_END_ALLOW_THREADS
+
+    return qp_result(&d, sol);
+}
+
+static char doc_qp_batch[] =
+    "Solves a list of small dense QPs or LPs.\n\n"
+    "sols = qp_batch(probs, nthreads = 1, maxiters = 100, abstol = 1e-7,\n"
+    "    reltol = 1e-6, feastol = 1e-7, kktreg = 0.0, correction = True)\n"
+    "\n"
+    "probs is a list of tuples (q, G, h, A, b, P) as in qp().  Returns\n"
+    "the list of tuples (status, x, s, y, z, info) returned by qp().\n"
+    "The problems are solved without holding the global interpreter\n"
+    "lock, by nthreads OpenMP threads if the module is compiled with\n"
+    "OpenMP support, and sequentially otherwise.";
+
+static PyObject* qp_batch(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+    PyObject *probs, *sols = NULL, *r;
+    matrix **sol;
+    qpdata *d;
+    int k, N, nsol, nthreads = 1, maxiters = 100, correction = 1;
+    double abstol = 1e-7, reltol = 1e-6, feastol = 1e-7, kktreg = 0.0;
+    char *kwlist[] = {"probs", "nthreads", "maxiters", "abstol", "reltol",
+        "feastol", "kktreg", "correction", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O!|iiddddi", kwlist,
+        &PyList_Type, &probs, &nthreads, &maxiters, &abstol, &reltol,
+        &feastol, &kktreg, &correction)) return NULL;
+    if (nthreads < 1){
+        PyErr_SetString(PyExc_ValueError, "nthreads must be positive");
+        return NULL;
+    }
+
+    N = (int) PyList_Size(probs);
+    d = (qpdata *) calloc(MAX(1, N), sizeof(qpdata));
+    sol = (matrix **) calloc(MAX(1, 4*N), sizeof(matrix *));
+    if (!d || !sol){
+        free(d);  free(sol);
+        return PyErr_NoMemory();
+    }
+    for (k = 0; k < N; k++){
+        d[k].maxiters = maxiters;  d[k].correction = correction;
+        d[k].abstol = abstol;  d[k].reltol = reltol;
+        d[k].feastol = feastol;  d[k].kktreg = kktreg;
+        if (qp_parse(PyList_GetItem(probs, (Py_ssize_t) k), d + k,
+            sol + 4*k)) break;
+    }
+
+    if (k == N){
+        Py_BEGIN_ALLOW_THREADS
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+        for (k = 0; k < N; k++) qp_solve(d + k);
+        Py_END_ALLOW_THREADS
+
+        sols = PyList_New(N);
+        for (k = 0; k < N && sols; k++){
+            if (!(r = qp_result(d + k, sol + 4*k))) Py_CLEAR(sols);
+            else PyList_SET_ITEM(sols, k, r);
+        }
+        nsol = k;
+    }
+    else
+        nsol = 0;
+
+    /* Release the solution matrices that were not returned. */
+    for (k = 0; k < N; k++){
+        if (k >= nsol && sol[4*k]){
+            Py_DECREF(sol[4*k]);  Py_DECREF(sol[4*k+1]);
+            Py_DECREF(sol[4*k+2]);  Py_DECREF(sol[4*k+3]);
+        }
+    }
+    free(d);  free(sol);
+    return sols;
+}
+
 static PyMethodDef misc_solvers_functions[] = {
     {"scale", (PyCFunction) scale, METH_VARARGS|METH_KEYWORDS, doc_scale},
     {"scale2", (PyCFunction) scale2, METH_VARARGS|METH_KEYWORDS,
@@ -1169,6 +3130,20 @@ static PyMethodDef misc_solvers_functions[] = {
     {"sinv", (PyCFunction) sinv, METH_VARARGS|METH_KEYWORDS, doc_sinv},
     {"max_step", (PyCFunction) max_step, METH_VARARGS|METH_KEYWORDS,
         doc_max_step},
+    {"workspace", (PyCFunction) workspace, METH_VARARGS|METH_KEYWORDS,
+        doc_workspace},
+    {"compute_scaling", (PyCFunction) compute_scaling,
+        METH_VARARGS|METH_KEYWORDS, doc_compute_scaling},
+    {"update_scaling", (PyCFunction) update_scaling,
+        METH_VARARGS|METH_KEYWORDS, doc_update_scaling},
+    {"schur", (PyCFunction) schur, METH_VARARGS|METH_KEYWORDS, doc_schur},
+    {"nlfunction", (PyCFunction) nlfunction, METH_VARARGS|METH_KEYWORDS,
+        doc_nlfunction},
+    {"nlfunction_batch", (PyCFunction) nlfunction_batch,
+        METH_VARARGS|METH_KEYWORDS, doc_nlfunction_batch},
+    {"qp", (PyCFunction) qp, METH_VARARGS|METH_KEYWORDS, doc_qp},
+    {"qp_batch", (PyCFunction) qp_batch, METH_VARARGS|METH_KEYWORDS,
+        doc_qp_batch},
     {NULL}  /* Sentinel */
 };
 
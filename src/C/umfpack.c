@@ -98,10 +98,67 @@ static void free_umfpack_z_numeric(void *F, void *descr)
 #endif
 
 
+/*
+ * Solves with the numeric factor of A for the nrhs columns of B that
+ * start at B (a pointer into the matrix buffer) with leading dimension
+ * ldB, and overwrites B with the solution.  The columns are divided
+ * over nthreads threads if CVXOPT is compiled with OpenMP.  Each thread
+ * allocates the workspace of umfpack_*_wsolve and a solution vector
+ * once and reuses them for all its columns.  Does not use the Python
+ * API, so it can be called with the GIL released.  Returns the first
+ * UMFPACK status that differs from UMFPACK_OK.
+ */
+static double solve_columns(int sys, spmatrix *A, void *numeric,
+    unsigned char *B, int ldB, int nrhs, int nthreads)
+{
+    int t, nt = 1, n = SP_NROWS(A), id = SP_ID(A);
+    double status = UMFPACK_OK, *tstatus;
+
+#ifdef _OPENMP
+    nt = MAX(1, MIN(nthreads, nrhs));
+#endif
+    if (!(tstatus = malloc(nt*sizeof(double))))
+        return UMFPACK_ERROR_out_of_memory;
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+    for (t=0; t<nt; t++) {
+        int k;
+        double info[UMFPACK_INFO];
+        int_t *Wi = malloc(n*sizeof(int_t));
+        double *W = malloc((id == DOUBLE ? 5 : 10)*n*sizeof(double));
+        unsigned char *x = malloc(n*E_SIZE[id]);
+
+        tstatus[t] = UMFPACK_OK;
+        if (!Wi || !W || !x) tstatus[t] = UMFPACK_ERROR_out_of_memory;
+        for (k = t*nrhs/nt; k < (t+1)*nrhs/nt &&
+            tstatus[t] == UMFPACK_OK; k++) {
+            unsigned char *b = B + (size_t) k*ldB*E_SIZE[id];
+            if (id == DOUBLE)
+                UMFD(wsolve)(sys, SP_COL(A), SP_ROW(A), SP_VAL(A),
+                    (double *) x, (double *) b, numeric, NULL, info,
+                    Wi, W);
+            else
+                UMFZ(wsolve)(sys, SP_COL(A), SP_ROW(A), SP_VAL(A),
+                    NULL, (double *) x, NULL, (double *) b, NULL,
+                    numeric, NULL, info, Wi, W);
+            tstatus[t] = info[UMFPACK_STATUS];
+            if (tstatus[t] == UMFPACK_OK) memcpy(b, x, n*E_SIZE[id]);
+        }
+        free(Wi);  free(W);  free(x);
+    }
+
+    for (t=0; t<nt && status == UMFPACK_OK; t++) status = tstatus[t];
+    free(tstatus);
+    return status;
+}
+
+
 static char doc_linsolve[] =
     "Solves a sparse set of linear equations.\n\n"
     "linsolve(A, B, trans='N', nrhs=B.size[1], ldB=max(1,B.size[0]),\n"
-    "         offsetB=0)\n\n"
+    "         offsetB=0, nthreads=1)\n\n"
     "PURPOSE\n"
     "If trans is 'N', solves A*X = B.\n"
     "If trans is 'T', solves A^T*X = B.\n"
@@ -116,7 +173,10 @@ static char doc_linsolve[] =
     "nrhs      integer.  If negative, the default value is used.\n\n"
     "ldB       nonnegative integer.  ldB >= max(1,n).  If zero, the\n"
     "          default value is used.\n\n"
-    "offsetB   nonnegative integer";
+    "offsetB   nonnegative integer\n\n"
+    "nthreads  positive integer.  The number of threads over which\n"
+    "          the columns of B are divided.  Only used if CVXOPT\n"
+    "          is compiled with OpenMP.";
 
 static PyObject* linsolve(PyObject *self, PyObject *args,
     PyObject *kwrds)
@@ -128,18 +188,18 @@ static PyObject* linsolve(PyObject *self, PyObject *args,
 #endif
     char trans='N';
     double info[UMFPACK_INFO];
-    int oB=0, n, nrhs=-1, ldB=0, k;
-    void *symbolic, *numeric, *x;
+    int oB=0, n, nrhs=-1, ldB=0, nthreads=1;
+    void *symbolic, *numeric;
     char *kwlist[] = {"A", "B", "trans", "nrhs", "ldB", "offsetB",
-        NULL};
+        "nthreads", NULL};
 
 #if PY_MAJOR_VERSION >= 3
-    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|Ciii", kwlist,
-        &A, &B, &trans_, &nrhs, &ldB, &oB)) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|Ciiii", kwlist,
+        &A, &B, &trans_, &nrhs, &ldB, &oB, &nthreads)) return NULL;
     trans = (char) trans_;
 #else
-    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|ciii", kwlist,
-        &A, &B, &trans, &nrhs, &ldB, &oB)) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|ciiii", kwlist,
+        &A, &B, &trans, &nrhs, &ldB, &oB, &nthreads)) return NULL;
 #endif
 
     if (!SpMatrix_Check(A) || SP_NROWS(A) != SP_NCOLS(A))
@@ -158,6 +218,8 @@ static PyObject* linsolve(PyObject *self, PyObject *args,
 
     if (trans != 'N' && trans != 'T' && trans != 'C')
         err_char("trans", "'N', 'T', 'C'");
+    if (nthreads < 1) PY_ERR(PyExc_ValueError, "nthreads must be "
+        "positive");
 
     if (SP_ID(A) == DOUBLE)
         UMFD(symbolic)(n, n, SP_COL(A), SP_ROW(A), SP_VAL(A), &symbolic,
@@ -210,31 +272,12 @@ static PyObject* linsolve(PyObject *self, PyObject *args,
         }
     }
 
-    if (!(x = malloc(n*E_SIZE[SP_ID(A)]))) {
-        if (SP_ID(A) == DOUBLE)
-            UMFD(free_numeric)(&numeric);
-        else
-            UMFZ(free_numeric)(&numeric);
-        return PyErr_NoMemory();
-    }
-    for (k=0; k<nrhs; k++){
-        if (SP_ID(A) == DOUBLE)
-            UMFD(solve)(trans == 'N' ? UMFPACK_A: UMFPACK_Aat,
-                SP_COL(A), SP_ROW(A), SP_VAL(A), x,
-                MAT_BUFD(B) + k*ldB + oB, numeric, NULL, info);
-        else
-            UMFZ(solve)(trans == 'N' ? UMFPACK_A: trans == 'C' ?
-                UMFPACK_At : UMFPACK_Aat, SP_COL(A), SP_ROW(A),
-                SP_VAL(A), NULL, x, NULL,
-                (double *)(MAT_BUFZ(B) + k*ldB + oB), NULL, numeric,
-                NULL, info);
-        if (info[UMFPACK_STATUS] == UMFPACK_OK)
-	  memcpy((unsigned char*)B->buffer + (k*ldB + oB)*E_SIZE[SP_ID(A)], x,
-                n*E_SIZE[SP_ID(A)]);
-        else
-	    break;
-    }
-    free(x);
+    Py_BEGIN_ALLOW_THREADS
+    info[UMFPACK_STATUS] = solve_columns(trans == 'N' ? UMFPACK_A :
+        (trans == 'C' && SP_ID(A) == COMPLEX) ? UMFPACK_At : UMFPACK_Aat,
+        A, numeric, (unsigned char *) B->buffer + oB*E_SIZE[SP_ID(A)],
+        ldB, nrhs, nthreads);
+    Py_END_ALLOW_THREADS
     if (SP_ID(A) == DOUBLE)
         UMFD(free_numeric)(&numeric);
     else
@@ -438,7 +481,7 @@ static PyObject* numeric(PyObject *self, PyObject *args)
 static char doc_solve[] =
     "Solves a factored set of linear equations.\n\n"
     "solve(A, F, B, trans='N', nrhs=B.size[1], ldB=max(1,B.size[0]),\n"
-    "      offsetB=0)\n\n"
+    "      offsetB=0, nthreads=1)\n\n"
     "PURPOSE\n"
     "If trans is 'N', solves A*X = B.\n"
     "If trans is 'T', solves A^T*X = B.\n"
@@ -456,7 +499,10 @@ static char doc_solve[] =
     "nrhs      integer.  If negative, the default value is used.\n\n"
     "ldB       nonnegative integer.  ldB >= max(1,n).  If zero, the\n"
     "          default value is used.\n\n"
-    "offsetB   nonnegative integer";
+    "offsetB   nonnegative integer\n\n"
+    "nthreads  positive integer.  The number of threads over which\n"
+    "          the columns of B are divided.  Only used if CVXOPT\n"
+    "          is compiled with OpenMP.";
 
 static PyObject* solve(PyObject *self, PyObject *args, PyObject *kwrds)
 {
@@ -469,18 +515,19 @@ static PyObject* solve(PyObject *self, PyObject *args, PyObject *kwrds)
     const char *descrz = "UMFPACK NUM Z FACTOR"; 
 #endif
     char trans='N';
-    double *x, info[UMFPACK_INFO];
-    int oB=0, n, ldB=0, nrhs=-1, k;
+    double info[UMFPACK_INFO];
+    void *numeric;
+    int oB=0, n, ldB=0, nrhs=-1, nthreads=1;
     char *kwlist[] = {"A", "F", "B", "trans", "nrhs", "ldB", "offsetB",
-        NULL};
+        "nthreads", NULL};
 
 #if PY_MAJOR_VERSION >= 3
-    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|Ciii", kwlist,
-        &A, &F, &B, &trans_, &nrhs, &ldB, &oB)) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|Ciiii", kwlist,
+        &A, &F, &B, &trans_, &nrhs, &ldB, &oB, &nthreads)) return NULL;
     trans = (char) trans_;
 #else
-    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|ciii", kwlist,
-        &A, &F, &B, &trans, &nrhs, &ldB, &oB)) return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|ciiii", kwlist,
+        &A, &F, &B, &trans, &nrhs, &ldB, &oB, &nthreads)) return NULL;
 #endif
 
     if (!SpMatrix_Check(A) || SP_NROWS(A) != SP_NCOLS(A))
@@ -521,43 +568,20 @@ static PyObject* solve(PyObject *self, PyObject *args, PyObject *kwrds)
 
     if (trans != 'N' && trans != 'T' && trans != 'C')
         err_char("trans", "'N', 'T', 'C'");
+    if (nthreads < 1) PY_ERR(PyExc_ValueError, "nthreads must be "
+        "positive");
 
-    if (!(x = malloc(n*E_SIZE[SP_ID(A)]))) return PyErr_NoMemory();
-
-    for (k=0; k<nrhs; k++) {
-        if (SP_ID(A) == DOUBLE)
-#if PY_MAJOR_VERSION >= 3
-            UMFD(solve)(trans == 'N' ? UMFPACK_A : UMFPACK_Aat,
-                SP_COL(A), SP_ROW(A), SP_VAL(A), x,
-                MAT_BUFD(B) + k*ldB + oB,
-                (void *) PyCapsule_GetPointer(F, descrd), NULL, info);
-#else
-            UMFD(solve)(trans == 'N' ? UMFPACK_A : UMFPACK_Aat,
-                SP_COL(A), SP_ROW(A), SP_VAL(A), x,
-                MAT_BUFD(B) + k*ldB + oB,
-                (void *) PyCObject_AsVoidPtr(F), NULL, info);
-#endif
-        else
 #if PY_MAJOR_VERSION >= 3
-            UMFZ(solve)(trans == 'N' ? UMFPACK_A : trans == 'C' ?
-                UMFPACK_At : UMFPACK_Aat, SP_COL(A), SP_ROW(A),
-                SP_VAL(A), NULL, x, NULL,
-                (double *)(MAT_BUFZ(B) + k*ldB + oB), NULL,
-                (void *) PyCapsule_GetPointer(F, descrz), NULL, info);
+    numeric = PyCapsule_GetPointer(F, SP_ID(A) == DOUBLE ? descrd : descrz);
 #else
-            UMFZ(solve)(trans == 'N' ? UMFPACK_A : trans == 'C' ?
-                UMFPACK_At : UMFPACK_Aat, SP_COL(A), SP_ROW(A),
-                SP_VAL(A), NULL, x, NULL,
-                (double *)(MAT_BUFZ(B) + k*ldB + oB), NULL,
-                (void *) PyCObject_AsVoidPtr(F), NULL, info);
+    numeric = PyCObject_AsVoidPtr(F);
 #endif
-        if (info[UMFPACK_STATUS] == UMFPACK_OK)
-	    memcpy((unsigned char*)B->buffer + (k*ldB + oB)*E_SIZE[SP_ID(A)], x,
-                n*E_SIZE[SP_ID(A)]);
-        else
-	    break;
-    }
-    free(x);
+    Py_BEGIN_ALLOW_THREADS
+    info[UMFPACK_STATUS] = solve_columns(trans == 'N' ? UMFPACK_A :
+        (trans == 'C' && SP_ID(A) == COMPLEX) ? UMFPACK_At : UMFPACK_Aat,
+        A, numeric, (unsigned char *) B->buffer + oB*E_SIZE[SP_ID(A)],
+        ldB, nrhs, nthreads);
+    Py_END_ALLOW_THREADS
 
     if (info[UMFPACK_STATUS] != UMFPACK_OK){
         if (info[UMFPACK_STATUS] == UMFPACK_ERROR_out_of_memory)
@@ -578,12 +602,154 @@ static PyObject* solve(PyObject *self, PyObject *args, PyObject *kwrds)
     return Py_BuildValue("");
 }
 
+/*
+ * save() writes the UMFPACK file followed by a trailer of UMF_TRAILER
+ * bytes with the descriptor of the factor, which is used by load() to
+ * select the UMFPACK routine.  UMFPACK ignores the trailing bytes.
+ */
+#define UMF_TRAILER 32
+
+static const char *umf_names[] = {"UMFPACK SYM D FACTOR",
+    "UMFPACK SYM Z FACTOR", "UMFPACK NUM D FACTOR",
+    "UMFPACK NUM Z FACTOR"};
+
+static char doc_save[] =
+    "Writes an UMFPACK factorization to a file.\n\n"
+    "save(F, filename)\n\n"
+    "ARGUMENTS\n"
+    "F         symbolic or numeric factorization computed by\n"
+    "          umfpack.symbolic or umfpack.numeric\n\n"
+    "filename  string";
+
+static PyObject* save(PyObject *self, PyObject *args)
+{
+    PyObject *F;
+    const char *filename;
+    char trailer[UMF_TRAILER];
+    int kind, status;
+    void *Fptr;
+    FILE *f;
+#if PY_MAJOR_VERSION >= 3
+    const char *descr;
+#else
+    char *descr;
+#endif
+
+    if (!PyArg_ParseTuple(args, "Os", &F, &filename)) return NULL;
+
+#if PY_MAJOR_VERSION >= 3
+    if (!PyCapsule_CheckExact(F) || !(descr = PyCapsule_GetName(F)))
+        err_CO("F");
+#else
+    if (!PyCObject_Check(F)) err_CO("F");
+    if (!(descr = PyCObject_GetDesc(F)))
+        PY_ERR_TYPE("F is not an UMFPACK factor");
+#endif
+    for (kind = 0; kind < 4; kind++)
+        if (!strcmp(descr, umf_names[kind])) break;
+    if (kind == 4) PY_ERR_TYPE("F is not an UMFPACK factor");
+#if PY_MAJOR_VERSION >= 3
+    Fptr = PyCapsule_GetPointer(F, descr);
+#else
+    Fptr = PyCObject_AsVoidPtr(F);
+#endif
+
+    switch (kind) {
+        case 0: status = UMFD(save_symbolic)(Fptr, (char *) filename);
+            break;
+        case 1: status = UMFZ(save_symbolic)(Fptr, (char *) filename);
+            break;
+        case 2: status = UMFD(save_numeric)(Fptr, (char *) filename);
+            break;
+        default: status = UMFZ(save_numeric)(Fptr, (char *) filename);
+    }
+    if (status != UMFPACK_OK){
+        snprintf(umfpack_error,20,"%s %i","UMFPACK ERROR", status);
+        PyErr_SetString(PyExc_IOError, umfpack_error);
+        return NULL;
+    }
+
+    memset(trailer, 0, UMF_TRAILER);
+    strcpy(trailer, umf_names[kind]);
+    if (!(f = fopen(filename, "ab")))
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, filename);
+    status = (fwrite(trailer, 1, UMF_TRAILER, f) == UMF_TRAILER);
+    if (fclose(f) || !status)
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, filename);
+
+    return Py_BuildValue("");
+}
+
+
+static char doc_load[] =
+    "Reads an UMFPACK factorization from a file written by\n"
+    "umfpack.save.\n\n"
+    "F = load(filename)\n\n"
+    "ARGUMENTS\n"
+    "filename  string\n\n"
+    "F         the symbolic or numeric factorization, as an opaque C\n"
+    "          object";
+
+static PyObject* load(PyObject *self, PyObject *args)
+{
+    const char *filename;
+    char trailer[UMF_TRAILER];
+    int kind, status;
+    void *Fptr = NULL;
+    FILE *f;
+
+    if (!PyArg_ParseTuple(args, "s", &filename)) return NULL;
+
+    if (!(f = fopen(filename, "rb")))
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, filename);
+    status = !fseek(f, -UMF_TRAILER, SEEK_END) &&
+        fread(trailer, 1, UMF_TRAILER, f) == UMF_TRAILER;
+    fclose(f);
+    trailer[UMF_TRAILER-1] = 0;
+    for (kind = 0; status && kind < 4; kind++)
+        if (!strcmp(trailer, umf_names[kind])) break;
+    if (!status || kind == 4)
+        PY_ERR(PyExc_ValueError, "not a valid UMFPACK factor file");
+
+    switch (kind) {
+        case 0: status = UMFD(load_symbolic)(&Fptr, (char *) filename);
+            break;
+        case 1: status = UMFZ(load_symbolic)(&Fptr, (char *) filename);
+            break;
+        case 2: status = UMFD(load_numeric)(&Fptr, (char *) filename);
+            break;
+        default: status = UMFZ(load_numeric)(&Fptr, (char *) filename);
+    }
+    if (status != UMFPACK_OK){
+        if (status == UMFPACK_ERROR_out_of_memory)
+            return PyErr_NoMemory();
+        snprintf(umfpack_error,20,"%s %i","UMFPACK ERROR", status);
+        PyErr_SetString(PyExc_ValueError, umfpack_error);
+        return NULL;
+    }
+
+#if PY_MAJOR_VERSION >= 3
+    return (PyObject *) PyCapsule_New(Fptr, umf_names[kind],
+        (PyCapsule_Destructor) (kind == 0 ? &free_umfpack_d_symbolic :
+        kind == 1 ? &free_umfpack_z_symbolic : kind == 2 ?
+        &free_umfpack_d_numeric : &free_umfpack_z_numeric));
+#else
+    return (PyObject *) PyCObject_FromVoidPtrAndDesc(Fptr,
+        (void *) umf_names[kind], kind == 0 ? free_umfpack_d_symbolic :
+        kind == 1 ? free_umfpack_z_symbolic : kind == 2 ?
+        free_umfpack_d_numeric : free_umfpack_z_numeric);
+#endif
+}
+
+
 static PyMethodDef umfpack_functions[] = {
     {"linsolve", (PyCFunction) linsolve, METH_VARARGS|METH_KEYWORDS,
         doc_linsolve},
     {"symbolic", (PyCFunction) symbolic, METH_VARARGS, doc_symbolic},
     {"numeric", (PyCFunction) numeric, METH_VARARGS, doc_numeric},
     {"solve", (PyCFunction) solve, METH_VARARGS|METH_KEYWORDS, doc_solve},
+    {"save", (PyCFunction) save, METH_VARARGS, doc_save},
+    {"load", (PyCFunction) load, METH_VARARGS, doc_load},
     {NULL}  /* Sentinel */
 };
 
@@ -278,10 +278,11 @@ from cvxopt.base import matrix, spmatrix, sparse, spdiag, sqrt, sin, cos, \
 
 from cvxopt import solvers, blas, lapack
 
-__all__ = [ 'blas', 'lapack', 'amd', 'umfpack', 'cholmod', 'solvers',
-    'modeling', 'printing', 'info', 'matrix', 'spmatrix', 'sparse', 
-    'spdiag', 'sqrt', 'sin', 'cos', 'exp', 'log', 'min', 'max', 'mul', 
-    'div', 'normal', 'uniform', 'setseed', 'getseed' ]
+__all__ = [ 'blas', 'lapack', 'amd', 'umfpack', 'cholmod', 'cache',
+    'solvers', 'modeling', 'printing', 'info', 'matrix', 'spmatrix', 
+    'sparse', 'spdiag', 'sqrt', 'sin', 'cos', 'exp', 'log', 'min', 'max',
+    'mul', 'div', 'normal', 'uniform', 'setseed', 'getseed', 'presolve',
+    'chordal' ]
 
 from ._version import get_versions
 __version__ = get_versions()['version']
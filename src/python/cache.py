@@ -0,0 +1,209 @@
+"""
+Cache of symbolic factorizations of sparse matrices.
+
+symbolic:   cached version of cholmod.symbolic.
+info:       returns the number of cache hits and misses.
+clear:      empties the cache and resets the counters.
+options:    dictionary with the maximum size of the cache.
+
+The symbolic factorizations (orderings and symbolic analysis) are
+stored in a process-wide cache, keyed by a hash of the sparsity pattern
+of the matrix.  When the cache contains more than options['maxsize']
+factorizations, the least recently used one is discarded.  Setting
+options['maxsize'] to zero disables the cache.
+
+If options['path'] is the name of a directory, factorizations that are
+not in memory are looked up in, and added to, an on-disk store in that
+directory, so that they survive process restarts.
+
+Factor:     picklable wrapper of a CHOLMOD or UMFPACK factorization.
+"""
+
+# Copyright 2012-2020 M. Andersen and L. Vandenberghe.
+# Copyright 2010-2011 L. Vandenberghe.
+# Copyright 2004-2009 J. Dahl and L. Vandenberghe.
+#
+# This file is part of CVXOPT.
+#
+# CVXOPT is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# CVXOPT is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import hashlib, os, tempfile, threading
+from collections import OrderedDict
+
+options = {'maxsize': 32, 'path': None}
+
+__all__ = ['symbolic', 'info', 'clear', 'options', 'Factor']
+
+_cache = OrderedDict()
+_lock = threading.Lock()
+_stats = {'hits': 0, 'misses': 0}
+
+
+def _maxsize():
+
+    maxsize = options.get('maxsize', 32)
+    if not isinstance(maxsize, int) or maxsize < 0:
+        raise ValueError("options['maxsize'] must be a nonnegative integer")
+    return maxsize
+
+
+def pattern_key(A):
+    """
+    Returns a hash of the size, type and sparsity pattern of the sparse
+    matrix A.
+    """
+
+    colptr, rowind = A.CCS[:2]
+    h = hashlib.sha1()
+    h.update(memoryview(colptr))
+    h.update(memoryview(rowind))
+    return (A.size, A.typecode, h.hexdigest())
+
+
+def _lookup(key, create, module):
+
+    maxsize = _maxsize()
+    if not maxsize:
+        return create()
+    with _lock:
+        F = _cache.pop(key, None)
+        if F is not None: 
+            _stats['hits'] += 1
+        else: 
+            _stats['misses'] += 1
+    if F is None:
+        F = _disk_lookup(key, create, module)
+    with _lock:
+        _cache[key] = F
+        while len(_cache) > maxsize:
+            _cache.popitem(last = False)
+    return F
+
+
+def _disk_lookup(key, create, module):
+
+    path = options.get('path', None)
+    if path is None:
+        return create()
+    filename = os.path.join(path, hashlib.sha1(repr(key).encode()
+        ).hexdigest() + '.fac')
+    try:
+        return module.load(filename)
+    except (IOError, OSError, ValueError):
+        pass
+    F = create()
+
+    # Write to a temporary file first, so that other processes never 
+    # read an incomplete file.
+    tmpname = None
+    try:
+        fd, tmpname = tempfile.mkstemp(dir = path)
+        os.close(fd)
+        module.save(F, tmpname)
+        os.rename(tmpname, filename)
+    except (IOError, OSError):
+        if tmpname and os.path.exists(tmpname): os.remove(tmpname)
+    return F
+
+
+def symbolic(A, uplo = 'L'):
+    """
+    Symbolic Cholesky factorization of a real symmetric or Hermitian
+    sparse matrix, using a cached factorization if a matrix with the
+    same sparsity pattern was analyzed before.
+
+    F = symbolic(A, uplo = 'L')
+
+    Returns a new copy of the symbolic factorization computed by
+    cholmod.symbolic(A, uplo = uplo), which can be passed to
+    cholmod.numeric.  The cached factorization is not modified by later
+    numeric factorizations.
+    """
+
+    from cvxopt import cholmod
+    key = ('cholmod', uplo, tuple(sorted(cholmod.options.items()))) + \
+        pattern_key(A)
+    return cholmod.copy(_lookup(key, lambda: cholmod.symbolic(A, uplo =
+        uplo), cholmod))
+
+
+def info():
+    """
+    Returns a dictionary with the number of cache hits and misses, the
+    number of cached factorizations and the maximum size of the cache.
+    """
+
+    with _lock:
+        return {'hits': _stats['hits'], 'misses': _stats['misses'],
+            'size': len(_cache), 'maxsize': _maxsize()}
+
+
+def clear():
+    """
+    Removes all factorizations from the cache and resets the counters.
+    """
+
+    with _lock:
+        _cache.clear()
+        _stats['hits'] = _stats['misses'] = 0
+
+
+def _dumps(module, F):
+
+    fd, filename = tempfile.mkstemp()
+    os.close(fd)
+    try:
+        module.save(F, filename)
+        with open(filename, 'rb') as f:
+            return f.read()
+    finally:
+        os.remove(filename)
+
+
+def _loads(name, data):
+
+    from cvxopt import cholmod, umfpack
+    module = {'cholmod': cholmod, 'umfpack': umfpack}[name]
+    fd, filename = tempfile.mkstemp()
+    try:
+        os.write(fd, data)
+        os.close(fd)
+        return Factor(module.load(filename))
+    finally:
+        os.remove(filename)
+
+
+class Factor(object):
+    """
+    Picklable wrapper of a CHOLMOD or UMFPACK factorization.
+
+    Factor(F) wraps the symbolic or numeric factorization F computed by
+    the cholmod or umfpack routines.  The factorization is the
+    attribute F of the object.  Pickling a Factor object writes F with
+    cholmod.save or umfpack.save, and unpickling reads it back with
+    cholmod.load or umfpack.load.  As with other pickled data, the
+    result should only be unpickled from trusted sources.
+    """
+
+    def __init__(self, F):
+        self.F = F
+
+    def __reduce__(self):
+        from cvxopt import cholmod, umfpack
+        for name, module in [('cholmod', cholmod), ('umfpack', umfpack)]:
+            try:
+                return _loads, (name, _dumps(module, self.F))
+            except TypeError:
+                pass
+        raise TypeError("F is not a CHOLMOD or UMFPACK factorization")
@@ -0,0 +1,464 @@
+"""
+Chordal conversion of linear matrix inequalities.
+
+convert:    replaces the sparse 's' blocks of a cone LP by smaller blocks,
+            one for each clique of a chordal extension of their
+            sparsity pattern.
+recover:    maps a solution of the converted problem to the original
+            problem.
+
+The problems have the form
+
+    minimize    c'*x
+    subject to  G*x + s = h
+                A*x = b
+                s >= 0
+
+as in conelp().  Let E be the aggregate sparsity pattern of an 's' block,
+i.e., the union of the patterns of the lower triangular parts of h and
+of the columns of G, and let C_1, ..., C_p be the cliques of a chordal
+extension of E, arranged in a clique tree.  A matrix with pattern E is
+positive semidefinite if and only if it is a sum of positive
+semidefinite matrices, each with nonzeros only in the rows and columns
+of one clique, and a matrix Z has a positive semidefinite completion if
+and only if its principal submatrices Z[C_k, C_k] are positive
+semidefinite.  convert() therefore replaces the block by p blocks of the
+orders |C_k|.  The entries of the original block are assigned to one of
+the cliques that contain them, and for each entry of the intersection
+of a clique with its parent in the clique tree, a free variable is
+added that is subtracted from one block and added to the other.  The
+converted problem has the same equality constraints and no other new
+constraints, and the variables x are extended with these variables.
+
+recover() computes s as the sum of the clique blocks, and z as the
+maximum determinant positive semidefinite completion of the entries
+given by the clique blocks.
+"""
+
+# Copyright 2012-2020 M. Andersen and L. Vandenberghe.
+# Copyright 2010-2011 L. Vandenberghe.
+# Copyright 2004-2009 J. Dahl and L. Vandenberghe.
+#
+# This file is part of CVXOPT.
+#
+# CVXOPT is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# CVXOPT is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import heapq, bisect
+from cvxopt import blas, lapack
+from cvxopt.base import matrix, spmatrix, sparse
+
+options = {'tsize': 8, 'tfill': 8}
+
+__all__ = ['convert', 'recover', 'cliques', 'merge', 'completion',
+    'options']
+
+
+def cliques(n, edges):
+    """
+    Returns a clique tree of a chordal extension of a graph.
+
+    (order, snodes, cliques, parent) = cliques(n, edges)
+
+    PURPOSE
+    The graph has vertices 0, ..., n-1 and the edges (i, j) in the list
+    edges.  The extension is the filled graph of a greedy minimum degree
+    elimination.  Returns the elimination order (a perfect elimination
+    ordering of the extension), and for each clique k its supernode
+    snodes[k] (the vertices that belong to no clique closer to the root),
+    its vertices cliques[k] in increasing order, and the index parent[k]
+    of its parent in the clique tree (None for a root).
+    """
+
+    adj = [ set() for i in range(n) ]
+    for i, j in edges:
+        if i != j:
+            adj[i].add(j)
+            adj[j].add(i)
+
+    # Minimum degree elimination with a heap of (degree, vertex) pairs;
+    # pairs with outdated degrees are skipped.
+    heap = [ (len(adj[i]), i) for i in range(n) ]
+    heapq.heapify(heap)
+    pos, order, higher = [None] * n, [], [None] * n
+    while heap:
+        d, v = heapq.heappop(heap)
+        if pos[v] is not None or d != len(adj[v]): continue
+        pos[v] = len(order)
+        order.append(v)
+        higher[v] = adj[v]
+        for w in adj[v]:
+            adj[w].discard(v)
+            new = adj[v] - adj[w] - set([w])
+            if new: adj[w] |= new
+            heapq.heappush(heap, (len(adj[w]), w))
+        adj[v] = set()
+
+    # The parent of v in the elimination tree is its first eliminated
+    # higher neighbor.  {v} + higher[v] is a maximal clique, unless v has
+    # a child u with one more higher neighbor; v then belongs to the
+    # supernode of u.
+    etree = [ min(higher[v], key = lambda w: pos[w]) if higher[v] else
+        None for v in range(n) ]
+    rep = [None] * n
+    for v in order:
+        if rep[v] is None: rep[v] = v
+        p = etree[v]
+        if p is not None and len(higher[p]) + 1 == len(higher[v]) and \
+            rep[p] is None:
+            rep[p] = rep[v]
+
+    # Supernodes in the order of their first vertices; the last vertex of
+    # a supernode determines the parent clique.
+    index, snodes, last = {}, [], []
+    for v in order:
+        if rep[v] == v:
+            index[v] = len(snodes)
+            snodes.append([])
+            last.append(v)
+        snodes[index[rep[v]]].append(v)
+        last[index[rep[v]]] = v
+    cliques = [ sorted(snodes[k] + list(higher[last[k]])) for k in
+        range(len(snodes)) ]
+    parent = [ index[rep[etree[v]]] if etree[v] is not None else None for
+        v in last ]
+    return order, snodes, cliques, parent
+
+
+def merge(snodes, cliques, parent, tsize = 8, tfill = 8):
+    """
+    Merges cliques of a clique tree.
+
+    (snodes, cliques, parent) = merge(snodes, cliques, parent, tsize = 8,
+        tfill = 8)
+
+    PURPOSE
+    A clique is merged with its parent if both have order at most tsize,
+    or if the merge adds at most tfill entries to the lower triangular
+    part of the pattern.  The cliques are visited from the leaves to the
+    root.  Returns the supernodes, cliques and parent indices of the new
+    clique tree, in the format of cliques().  Merging reduces the number
+    of blocks and of variables added by convert(), at the cost of larger
+    blocks.
+    """
+
+    p = len(cliques)
+    snodes = [ list(S) for S in snodes ]
+    cliques = [ set(C) for C in cliques ]
+    parent = list(parent)
+    depth = [None] * p
+    def level(k):
+        if depth[k] is None:
+            depth[k] = 0 if parent[k] is None else level(parent[k]) + 1
+        return depth[k]
+    for k in range(p): level(k)
+
+    # into[k] is the clique that k was merged into, or k.  The parent of
+    # k is visited after k, so it has not been merged when k is visited.
+    into = list(range(p))
+    def find(k):
+        while into[k] != k: k = into[k]
+        return k
+    for k in sorted(range(p), key = lambda k: -depth[k]):
+        q = parent[k]
+        if q is None: continue
+        nsep = len(cliques[k] & cliques[q])
+        fill = (len(cliques[k]) - nsep) * (len(cliques[q]) - nsep)
+        if fill <= tfill or max(len(cliques[k]), len(cliques[q])) <= tsize:
+            cliques[q] |= cliques[k]
+            snodes[q] += snodes[k]
+            into[k] = q
+
+    keep = [ k for k in range(p) if into[k] == k ]
+    index = dict([ (k, i) for i, k in enumerate(keep) ])
+    return [ snodes[k] for k in keep ], [ sorted(cliques[k]) for k in keep
+        ], [ None if parent[k] is None else index[find(parent[k])] for k in
+        keep ]
+
+
+def completion(Z, order, cliques):
+    """
+    Maximum determinant positive semidefinite completion.
+
+    completion(Z, order, cliques)
+
+    PURPOSE
+    Z is a symmetric 'd' matrix of order n.  The entries of Z in the
+    lower triangular parts of the submatrices Z[C, C] for C in cliques
+    are given, and order is a perfect elimination ordering of the
+    chordal graph with these cliques, as returned by cliques().  On exit
+    Z is the maximum determinant positive semidefinite completion of the
+    given entries, if it exists, and is symmetric.  The entries are
+    computed in reverse elimination order: if L is the set of vertices
+    eliminated after v and Av the neighbors of v in L, then
+
+        Z[L - Av, v] = Z[L - Av, Av] * Z[Av, Av]^{-1} * Z[Av, v].
+
+    A singular Z[Av, Av] is replaced by its pseudo-inverse.
+    """
+
+    n = Z.size[0]
+    known = [ set() for i in range(n) ]
+    for C in cliques:
+        for i in C: known[i].update(C)
+    for i in range(n):
+        for j in range(i):
+            Z[j, i] = Z[i, j]
+
+    for t in range(n-2, -1, -1):
+        v = order[t]
+        L = order[t+1:]
+        Av = [ w for w in L if w in known[v] ]
+        R = [ w for w in L if w not in known[v] ]
+        if not R: continue
+        if not Av:
+            Z[R, v] = 0.0
+            Z[v, R] = 0.0
+            continue
+        y = Z[Av, v]
+        B = Z[Av, Av]
+        try:
+            lapack.posv(matrix(B), y)
+        except ArithmeticError:
+            w = matrix(0.0, (len(Av), 1))
+            lapack.syevd(B, w, jobz = 'V')
+            tol = 1e-12 * max(1.0, max(abs(w)))
+            u = B.T * Z[Av, v]
+            for k in range(len(Av)):
+                u[k] = u[k] / w[k] if w[k] > tol else 0.0
+            y = B * u
+        Z[R, v] = Z[R, Av] * y
+        Z[v, R] = Z[R, v].T
+
+
+def _entries(M, h, offsets):
+    """
+    Returns for each 's' block, with rows offsets[k]:offsets[k+1] of M
+    and h, a dictionary with the nonzero rows of M as lists of (column,
+    value) pairs, and the list of nonzero rows of h.
+    """
+
+    E = [ dict() for k in range(len(offsets) - 1) ]
+    H = [ list() for k in range(len(offsets) - 1) ]
+    for v, i, j in zip(M.V, M.I, M.J):
+        k = bisect.bisect_right(offsets, i) - 1
+        if 0 <= k < len(E) and v != 0.0:
+            E[k].setdefault(i, []).append((j, v))
+    hs = sparse(h)
+    for v, i in zip(hs.V, hs.I):
+        k = bisect.bisect_right(offsets, i) - 1
+        if 0 <= k < len(H) and v != 0.0:
+            H[k].append(i)
+    return E, H
+
+
+def convert(c, G, h, dims, A = None, b = None):
+    """
+    Chordal conversion of the 's' blocks of a cone LP.
+
+    R = convert(c, G, h, dims, A = None, b = None)
+
+    PURPOSE
+    Returns a dictionary R with the data of the converted problem in
+    R['c'], R['G'], R['h'], R['dims'], R['A'], R['b'], the number of
+    converted blocks in R['blocks converted'], and the information
+    needed by recover().  A block of order n is converted if the
+    chordal extension of its aggregate sparsity pattern has more than
+    one clique and the sum of the squares of the clique orders is less
+    than n**2.  If no block is converted, R['blocks converted'] is zero
+    and the data are returned unchanged.  The number of variables of
+    the converted problem is R['c'].size[0], and its first c.size[0]
+    variables are the variables of the original problem.
+
+    ARGUMENTS
+    c         'd' matrix of size (n,1)
+
+    G         dense or sparse 'd' matrix of size (K,n), with
+              K = dims['l'] + sum(dims['q']) + sum(k**2 for k in
+              dims['s']).  Only the lower triangular parts of the 's'
+              blocks are referenced.
+
+    h         'd' matrix of size (K,1)
+
+    dims      dictionary with the cone dimensions, as in conelp()
+
+    A         dense or sparse 'd' matrix of size (p,n), or None
+
+    b         'd' matrix of size (p,1), or None
+    """
+
+    n = c.size[0]
+    if A is None: A = spmatrix([], [], [], (0, n))
+    if b is None: b = matrix(0.0, (0, 1))
+    Gs = sparse(G)
+    ind = dims['l'] + sum(dims['q'])
+
+    # For each 's' block, either None (not converted), or the clique tree
+    # and, for the entry (i, j) with i >= j in the extended pattern, the
+    # clique that owns it.
+    offsets = [ind]
+    for m in dims['s']: offsets.append(offsets[-1] + m*m)
+    Gblocks, hblocks = _entries(Gs, h, offsets)
+    blocks, nconv = [], 0
+    for m, offset, Gb, hb in zip(dims['s'], offsets, Gblocks, hblocks):
+        edges = set()
+        for k in list(Gb.keys()) + hb:
+            i, j = (k - offset) % m, (k - offset) // m
+            if i > j: edges.add((i, j))
+        order, snodes, cl, parent = cliques(m, edges)
+        snodes, cl, parent = merge(snodes, cl, parent, options.get('tsize',
+            8), options.get('tfill', 8))
+        if len(cl) > 1 and sum([ len(C)**2 for C in cl ]) < m*m:
+            owner = [None] * m
+            for k, S in enumerate(snodes):
+                for v in S: owner[v] = k
+            blocks.append((m, offset, order, cl, parent, owner, Gb, hb))
+            nconv += 1
+        else:
+            blocks.append((m, offset, None, None, None, None, Gb, hb))
+
+    R = {'data': (c, G, h, dims, A, b), 'blocks converted': nconv}
+    if not nconv:
+        R.update({'c': c, 'G': G, 'h': h, 'dims': dims, 'A': A, 'b': b})
+        return R
+
+    # Rows of G and h for the 'l' and 'q' blocks.
+    V, I, J = [], [], []
+    for v, i, j in zip(Gs.V, Gs.I, Gs.J):
+        if i < ind:
+            V.append(v)
+            I.append(i)
+            J.append(j)
+    hnew = [ h[:ind] ]
+    sdims, nu, row = [], 0, ind
+    info = []
+    for m, offset, order, cl, parent, owner, Gb, hb in blocks:
+        if order is None:
+            for i, entries in Gb.items():
+                for j, v in entries:
+                    V.append(v)
+                    I.append(i - offset + row)
+                    J.append(j)
+            hnew.append(h[offset : offset + m*m])
+            sdims.append(m)
+            info.append((m, row, None, None))
+            row += m*m
+            continue
+
+        # Offsets of the clique blocks, and positions of the vertices in
+        # the cliques.
+        start, local = [], []
+        for C in cl:
+            start.append(row)
+            local.append(dict([ (v, k) for k, v in enumerate(C) ]))
+            sdims.append(len(C))
+            row += len(C)**2
+
+        def position(k, i, j):
+            # Row of entry (i, j), i >= j, of the block in clique k.
+            q = len(cl[k])
+            return start[k] + local[k][i] + local[k][j] * q
+
+        # The entry (i, j) is owned by the clique of the vertex of i and j
+        # that is eliminated first.
+        pos = dict([ (v, k) for k, v in enumerate(order) ])
+        def own(i, j):
+            return owner[i] if pos[i] < pos[j] else owner[j]
+
+        hk = matrix(0.0, (row - start[0], 1))
+        for r in hb:
+            i, j = (r - offset) % m, (r - offset) // m
+            if i >= j: hk[position(own(i, j), i, j) - start[0]] = h[r]
+        hnew.append(hk)
+        for r, entries in Gb.items():
+            i, j = (r - offset) % m, (r - offset) // m
+            if i < j: continue
+            for col, v in entries:
+                V.append(v)
+                I.append(position(own(i, j), i, j))
+                J.append(col)
+
+        # Free variables for the entries shared by a clique and its parent:
+        # added to the child block and subtracted from the parent block.
+        for k, p in enumerate(parent):
+            if p is None: continue
+            sep = [ v for v in cl[k] if v in local[p] ]
+            for a in range(len(sep)):
+                for bb in range(a + 1):
+                    i, j = max(sep[a], sep[bb]), min(sep[a], sep[bb])
+                    V += [-1.0, 1.0]
+                    I += [position(k, i, j), position(p, i, j)]
+                    J += [n + nu, n + nu]
+                    nu += 1
+        info.append((m, start, cl, order))
+
+    K = row
+    Gnew = spmatrix(V, I, J, (K, n + nu))
+    Anew = sparse([[ sparse(A) ], [ spmatrix([], [], [], (A.size[0], nu))
+        ]]) if nu else A
+    R.update({'c': matrix([c, matrix(0.0, (nu, 1))]), 'G': Gnew, 'h':
+        matrix(hnew), 'dims': {'l': dims['l'], 'q': list(dims['q']), 's':
+        sdims}, 'A': Anew, 'b': b, 'blocks': info})
+    return R
+
+
+def recover(R, sol):
+    """
+    Maps a solution of the converted problem to the original problem.
+
+    sol = recover(R, sol)
+
+    PURPOSE
+    R is the dictionary returned by convert() and sol a solution
+    dictionary returned by conelp() for the converted problem.  Returns
+    a copy of sol in which 'x' has the original variables, the 's'
+    blocks of 's' are the sums of the clique blocks, and the 's' blocks
+    of 'z' are the maximum determinant positive semidefinite completions
+    of the clique blocks.  The objective values, residuals and slacks
+    are those of the converted problem.  The key 'chordal' is added
+    with a list of the clique orders of each 's' block (None for the
+    blocks that were not converted).
+    """
+
+    if not R['blocks converted']: return sol
+    c, G, h, dims, A, b = R['data']
+    n = c.size[0]
+    ind = dims['l'] + sum(dims['q'])
+    sol = dict(sol)
+    if sol.get('x') is not None: sol['x'] = sol['x'][:n]
+    for key in ['s', 'z']:
+        u = sol.get(key)
+        if u is None: continue
+        x, offset = [ u[:ind] ], ind
+        for m, start, cl, order in R['blocks']:
+            if cl is None:
+                x.append(u[start : start + m*m])
+                continue
+            X = matrix(0.0, (m, m))
+            for k, C in enumerate(cl):
+                q = len(C)
+                for a in range(q):
+                    for bb in range(a + 1):
+                        v = u[start[k] + a + bb*q]
+                        if key == 's': X[C[a], C[bb]] += v
+                        else: X[C[a], C[bb]] = v
+            if key == 's':
+                for i in range(m):
+                    for j in range(i): X[j, i] = X[i, j]
+            else:
+                completion(X, order, cl)
+            x.append(X[:])
+        sol[key] = matrix(x)
+    sol['chordal'] = [ None if cl is None else [ len(C) for C in cl ] for
+        m, start, cl, order in R['blocks'] ]
+    return sol
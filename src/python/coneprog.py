@@ -21,7 +21,7 @@ Solver for linear and quadratic cone programs.
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-import sys
+import atexit, sys, threading
 if sys.version > '3': long = int
 
 __all__ = []
@@ -31,7 +31,7 @@ options = {}
 def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
     dualstart = None, kktsolver = None, xnewcopy = None, xdot = None,
     xaxpy = None, xscal = None, ynewcopy = None, ydot = None, yaxpy = None,
-    yscal = None, **kwargs):
+    yscal = None, warmstart = None, **kwargs):
 
     """
     Solves a pair of primal and dual cone programs
@@ -95,6 +95,11 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
         corresponding to the strictly upper triangular entries of u are
         not referenced.
 
+        G can also be a misc.LowRank object, with the columns of the 's'
+        blocks given in factored form U*U' or sym(U*V').  It is used
+        with the default KKT solver 'chol', which computes the Schur
+        complement from the factors.
+
         h is a dense 'd' matrix of size (K,1), representing a vector in V,
         in the same format as the columns of G.
 
@@ -117,6 +122,13 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
         - dualstart['z'] is a dense 'd' matrix of size (K,1), representing
           a vector that is strictly positive with respect to the cone C.
 
+        The argument warmstart is a solution dictionary returned by
+        conelp() for a problem with the same dimensions, for example a
+        problem with slightly different c, h or b.  If it has status
+        'optimal' or 'unknown', the starting point is computed from its
+        'x', 's', 'y', 'z' fields by shifting s and z into the interior
+        of the cone, and primalstart and dualstart are ignored.
+
         It is assumed that rank(A) = p and rank([A; G]) = n.
 
         The other arguments are normally not needed.  They make it possible
@@ -414,7 +426,55 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
             1 otherwise)
         options['abstol'] scalar (default: 1e-7 )
         options['reltol'] scalar (default: 1e-6)
-        options['feastol'] scalar (default: 1e-7).
+        options['feastol'] scalar (default: 1e-7)
+        options['mixed_precision'] True/False (default: False).  If True,
+            the KKT matrix is factored in single precision and the
+            solutions are refined in double precision.  Requires 
+            kktsolver 'ldl', 'ldl2' or 'chol' (default: 'chol').
+        options['centrality_correctors'] nonnegative integer (default:
+            0).  The maximum number of Gondzio centrality correctors per
+            iteration.  The correctors reuse the factorization of the
+            KKT matrix, and improve the centrality of the componentwise
+            inequalities and of the variables tau and kappa.
+        options['equilibrate'] True/False (default: False).  If True and
+            kktsolver is not a function, the rows and columns of G and A
+            are scaled by misc.equilibrate() and the solution of the
+            scaled problem is mapped back.  The 'l' rows of G are scaled
+            individually and each 'q' and 's' block by a single factor.
+            The residuals in the solution dictionary refer to the scaled
+            problem.
+        options['chordal'] True/False (default: False).  If True and
+            kktsolver is not a function, the sparse 's' blocks are
+            replaced by the blocks for the cliques of a chordal extension
+            of their aggregate sparsity patterns, by chordal.convert(),
+            and the solution is mapped back by chordal.recover().  The
+            dual variable of a converted block is the maximum determinant
+            positive semidefinite completion of the clique blocks, and
+            the solution dictionary has an entry 'chordal' with the
+            clique orders.  The arguments primalstart, dualstart and
+            warmstart are ignored when a block is converted.
+        options['profile'] True/False (default: False).  If True, the
+            solution dictionary has an entry 'profile' with the time
+            spent per iteration in the KKT factorizations and solves,
+            the scaling updates, the step length computations and the
+            residuals, as described in misc.Profile.result().
+        options['profile_callback'] function (default: None).  If
+            options['profile'] is True, it is called with the record of
+            each iteration when the iteration ends.
+        options['time_limit'] positive scalar (default: None).  A limit
+            on the wall-clock time in seconds.  It is checked once per
+            iteration, and when it is exceeded the current iterate is
+            returned with status 'time limit'.
+        options['cancel'] solvers.CancelToken (default: None).  It is
+            checked once per iteration, and after token.cancel() has
+            been called, from any thread, the current iterate is
+            returned with status 'cancelled'.
+        options['lanczos'] nonnegative integer (default: 0).  If positive,
+            the step length of the affine scaling direction is computed
+            with the Lanczos method for the 's' blocks of order
+            options['lanczos'] or more, started at the eigenvectors of
+            the previous iteration.  LAPACK is used for blocks where the
+            Lanczos method does not converge.
 
     """
     import math
@@ -423,6 +483,9 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
     EXPON = 3
     STEP = 0.99
 
+    # Parameters of the centrality correctors.
+    BETAMIN, BETAMAX, GSTEP = 0.1, 10.0, 0.1
+
     options = kwargs.get('options',globals()['options'])
 
     DEBUG = options.get('debug', False)
@@ -437,6 +500,15 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
     if not isinstance(MAXITERS,(int,long)) or MAXITERS < 1:
         raise ValueError("options['maxiters'] must be a positive integer")
 
+    CORRECTORS = options.get('centrality_correctors', 0)
+    if not isinstance(CORRECTORS,(int,long)) or CORRECTORS < 0:
+        raise ValueError("options['centrality_correctors'] must be a "\
+            "nonnegative integer")
+
+    LANCZOS = options.get('lanczos', 0)
+    if not isinstance(LANCZOS,(int,long)) or LANCZOS < 0:
+        raise ValueError("options['lanczos'] must be a nonnegative integer")
+
     ABSTOL = options.get('abstol',1e-7)
     if not isinstance(ABSTOL,(float,int,long)):
         raise ValueError("options['abstol'] must be a scalar")
@@ -455,21 +527,65 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
 
     show_progress = options.get('show_progress', True)
 
+    MIXED = options.get('mixed_precision', False)
+    if MIXED not in (True, False):
+        raise ValueError("options['mixed_precision'] must be True or False")
+
+    EQUIL = options.get('equilibrate', False)
+    if EQUIL not in (True, False):
+        raise ValueError("options['equilibrate'] must be True or False")
+
+    CHORDAL = options.get('chordal', False)
+    if CHORDAL not in (True, False):
+        raise ValueError("options['chordal'] must be True or False")
+
+    # options['time_limit'] and options['cancel'] are checked once per
+    # iteration.
+    deadline = misc.Deadline.from_options(options)
+
+    # With options['profile'] True, the problem is solved with a Profile
+    # object in options['profile'] that records the timings.
+    prof = options.get('profile', False)
+    if not isinstance(prof, misc.Profile):
+        if prof not in (True, False):
+            raise ValueError("options['profile'] must be True or False")
+        if prof:
+            prof = misc.Profile(options.get('profile_callback', None))
+            sol = conelp(c, G, h, dims, A, b, primalstart, dualstart,
+                kktsolver, xnewcopy, xdot, xaxpy, xscal, ynewcopy, ydot,
+                yaxpy, yscal, warmstart, options = dict(options, profile =
+                prof))
+            sol['profile'] = prof.result()
+            return sol
+        prof = None
+
+    # A KKT solver created by Problem is used as the default solver with
+    # its name, with the factorization routine it created for G and A.
+    prebuilt = None
+    if isinstance(kktsolver, _KKTSolver):
+        prebuilt, kktsolver = kktsolver, kktsolver.name
+
+    lowrankG = isinstance(G, misc.LowRank)
     if kktsolver is None:
-        if dims and (dims['q'] or dims['s']):
-            kktsolver = 'qr'
-        else:
-            kktsolver = 'chol2'
+        kktsolver = _default_kktsolver(G, dims, mixed = MIXED)
     defaultsolvers = ('ldl', 'ldl2', 'qr', 'chol', 'chol2')
     if isinstance(kktsolver,str) and kktsolver not in defaultsolvers:
         raise ValueError("'%s' is not a valid value for kktsolver" \
             %kktsolver)
+    if MIXED and isinstance(kktsolver,str) and kktsolver not in ('ldl',
+        'ldl2', 'chol'):
+        raise ValueError("options['mixed_precision'] requires kktsolver "\
+            "'ldl', 'ldl2' or 'chol'")
 
     # Argument error checking depends on level of customization.
     customkkt = not isinstance(kktsolver,str)
     matrixG = isinstance(G, (matrix, spmatrix))
     matrixA = isinstance(A, (matrix, spmatrix))
-    if (not matrixG or (not matrixA and A is not None)) and not customkkt:
+    if lowrankG and kktsolver != 'chol' and not customkkt:
+        raise ValueError("G of type LowRank requires kktsolver 'chol' "\
+            "or a user-provided kktsolver")
+    if (not (matrixG or lowrankG) or (not matrixA and A is not None)) \
+        and not customkkt:
         raise ValueError("use of function valued G, A requires a "\
             "user-provided kktsolver")
     customx = (xnewcopy != None or xdot != None or xaxpy != None or
@@ -532,6 +648,9 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
             misc.sgemv(G, x, y, dims, trans = trans, alpha = alpha,
                 beta = beta)
     else:
+        if lowrankG and G.size != (cdim, c.size[0]):
+            raise TypeError("'G' must be of size (%d, %d)" %(cdim,
+                c.size[0]))
         Gf = G
 
     if A is None:
@@ -562,6 +681,34 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
             raise ValueError("use of non vector type for y requires b")
 
 
+    # Solve the problem with the sparse 's' blocks replaced by blocks for
+    # the cliques of their chordal extensions, and map the solution back.
+    # Starting points are not converted.
+    if CHORDAL and kktsolver in defaultsolvers and matrixG and dims['s']:
+        from cvxopt import chordal
+        R = chordal.convert(c, G, h, dims, A, b)
+        if R['blocks converted']:
+            sol = conelp(R['c'], R['G'], R['h'], R['dims'], R['A'], R['b'],
+                kktsolver = kktsolver, options = dict(options, chordal =
+                False))
+            return chordal.recover(R, sol)
+
+    # Solve the problem with scaled rows and columns of G and A, and map
+    # the solution back.
+    if EQUIL and kktsolver in defaultsolvers and matrixG:
+        c, G, h, A, b, P, S = misc.equilibrate(c, G, h, dims, A, b)
+        if primalstart is not None:
+            primalstart = misc.unscale_point(S, primalstart, inverse = True)
+        if dualstart is not None:
+            dualstart = misc.unscale_point(S, dualstart, inverse = True)
+        if warmstart is not None:
+            warmstart = misc.unscale_point(S, warmstart, inverse = True)
+        sol = conelp(c, G, h, dims, A, b, primalstart, dualstart,
+            kktsolver = kktsolver, warmstart = warmstart, options =
+            dict(options, equilibrate = False))
+        return misc.unscale_point(S, sol)
+
+
     # kktsolver(W) returns a routine for solving 3x3 block KKT system
     #
     #     [ 0   A'  G'*W^{-1} ] [ ux ]   [ bx ]
@@ -571,19 +718,18 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
     if kktsolver in defaultsolvers:
         if KKTREG is None and (b.size[0] > c.size[0] or b.size[0] + cdim_pckd < c.size[0]):
            raise ValueError("Rank(A) < p or Rank([G; A]) < n")
-        if kktsolver == 'ldl':
-            factor = misc.kkt_ldl(G, dims, A, kktreg = KKTREG)
-        elif kktsolver == 'ldl2':
-            factor = misc.kkt_ldl2(G, dims, A)
-        elif kktsolver == 'qr':
-            factor = misc.kkt_qr(G, dims, A)
-        elif kktsolver == 'chol':
-            factor = misc.kkt_chol(G, dims, A)
+        if prof: prof.set_kkt(kktsolver, c.size[0], b.size[0], cdim)
+        if prebuilt is not None:
+            factor = prebuilt.factor
         else:
-            factor = misc.kkt_chol2(G, dims, A)
+            factor = _kkt_factor(kktsolver, G, dims, A, KKTREG, MIXED)
         def kktsolver(W):
             return factor(W)
 
+    if prof:
+        kktsolver = prof.kktsolver(kktsolver)
+        misc = prof.module(misc)
+
 
     # res() evaluates residual in 5x5 block KKT system
     #
@@ -659,6 +805,12 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
     ds, dz = matrix(0.0, (cdim,1)), matrix(0.0, (cdim,1))
     dkappa, dtau = matrix(0.0, (1,1)), matrix(0.0, (1,1))
 
+    if warmstart is not None:
+        warmstart = misc.warm_start(warmstart, dims)
+    if warmstart is not None:
+        primalstart = {'x': warmstart['x'], 's': warmstart['s']}
+        dualstart = {'y': warmstart['y'], 'z': warmstart['z']}
+
     if primalstart is None or dualstart is None:
 
         # Factor
@@ -846,11 +998,26 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
 
     tau, kappa = 1.0, 1.0
 
+    # With a warm start, kappa is chosen so that tau*kappa is equal to
+    # the average complementarity of s and z.
+    if warmstart is not None:
+        kappa = misc.sdot(s, z, dims) / max(1, dims['l'] +
+            len(dims['q']) + sum(dims['s']))
+
     rx, hrx = xnewcopy(c), xnewcopy(c)
     ry, hry = ynewcopy(b), ynewcopy(b)
     rz, hrz = matrix(0.0, (cdim,1)), matrix(0.0, (cdim,1))
     sigs = matrix(0.0, (sum(dims['s']), 1))
     sigz = matrix(0.0, (sum(dims['s']), 1))
+
+    # Workspace of misc.scale() and misc.max_step().
+    work = misc.workspace(dims)
+
+    # Starting vectors of the Lanczos method in max_step().
+    if LANCZOS:
+        eigvs = matrix(0.0, (sum(dims['s']), 1))
+        eigvz = matrix(0.0, (sum(dims['s']), 1))
+
     lmbda = matrix(0.0, (cdim_diag + 1, 1))
     lmbdasq = matrix(0.0, (cdim_diag + 1, 1))
 
@@ -858,6 +1025,8 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
 
     for iters in range(MAXITERS+1):
 
+        if prof: prof.iteration(iters)
+
         # hrx = -A'*y - G'*z
         Af(y, hrx, alpha = -1.0, trans = 'T')
         Gf(z, hrx, alpha = -1.0, beta = 1.0, trans = 'T')
@@ -913,6 +1082,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
            dinfres = max(hresy / resy0, hresz/resz0) / (-cx)
         else:
            dinfres = None
+        if prof: prof.mark('residuals')
 
         if show_progress:
             if iters == 0:
@@ -922,9 +1092,14 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                 %(iters, pcost, dcost, gap, pres, dres, kappa/tau))
 
 
-        if ( pres <= FEASTOL and dres <= FEASTOL and ( gap <= ABSTOL or
-            (relgap is not None and relgap <= RELTOL) ) ) or \
-            iters == MAXITERS:
+        converged = pres <= FEASTOL and dres <= FEASTOL and ( gap <=
+            ABSTOL or (relgap is not None and relgap <= RELTOL) )
+        if converged: halt = None
+        elif iters == MAXITERS: halt = 'unknown'
+        elif deadline: halt = deadline.check()
+        else: halt = None
+
+        if converged or halt:
             xscal(1.0/tau, x)
             yscal(1.0/tau, y)
             blas.scal(1.0/tau, s)
@@ -934,14 +1109,13 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                 misc.symm(s, m, ind)
                 misc.symm(z, m, ind)
                 ind += m**2
-            ts = misc.max_step(s, dims)
-            tz = misc.max_step(z, dims)
-            if iters == MAXITERS:
+            ts = misc.max_step(s, dims, work = work)
+            tz = misc.max_step(z, dims, work = work)
+            if halt:
                 if show_progress:
-                    print("Terminated (maximum number of iterations "\
-                        "reached).")
+                    print(misc.terminated[halt])
                 return { 'x': x, 'y': y, 's': s, 'z': z,
-                    'status': 'unknown',
+                    'status': halt,
                     'gap': gap,
                     'relative gap': relgap,
                     'primal objective': pcost,
@@ -980,7 +1154,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
             for m in dims['s']:
                 misc.symm(z, m, ind)
                 ind += m**2
-            tz = misc.max_step(z, dims)
+            tz = misc.max_step(z, dims, work = work)
             if show_progress:
                 print("Certificate of primal infeasibility found.")
             return { 'x': None, 'y': y, 's': None, 'z': z,
@@ -1005,7 +1179,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                 misc.symm(s, m, ind)
                 ind += m**2
             y, z = None, None
-            ts = misc.max_step(s, dims)
+            ts = misc.max_step(s, dims, work = work)
             if show_progress:
                 print("Certificate of dual infeasibility found.")
             return {'x': x, 'y': None, 's': s, 'z': None,
@@ -1088,8 +1262,8 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                     misc.symm(s, m, ind)
                     misc.symm(z, m, ind)
                     ind += m**2
-                ts = misc.max_step(s, dims)
-                tz = misc.max_step(z, dims)
+                ts = misc.max_step(s, dims, work = work)
+                tz = misc.max_step(z, dims, work = work)
                 if show_progress:
                     print("Terminated (singular KKT matrix).")
                 return { 'x': x, 'y': y, 's': s, 'z': z,
@@ -1125,7 +1299,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
         # th = W^{-T} * h
         if iters == 0: th = matrix(0.0, (cdim,1))
         blas.copy(h, th)
-        misc.scale(th, W, trans = 'T', inverse = 'I')
+        misc.scale(th, W, trans = 'T', inverse = 'I', work = work)
 
         def f6_no_ir(x, y, z, tau, s, kappa):
 
@@ -1160,7 +1334,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
 
             # z := -(z + W'*s) = -bz + W'*(lambda o\ bs)
             blas.copy(s, ws3)
-            misc.scale(ws3, W, trans = 'T')
+            misc.scale(ws3, W, trans = 'T', work = work)
             blas.axpy(ws3, z)
             blas.scal(-1.0, z)
 
@@ -1245,6 +1419,34 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                 print("    'kappa': %e" %abs(wkappa[0]))
 
 
+        if CORRECTORS:
+            if iters == 0:
+                gx, gy = xnewcopy(c), ynewcopy(b)
+                gz, gs = matrix(0.0, (cdim, 1)), matrix(0.0, (cdim, 1))
+                gtau, gkappa = matrix(0.0), matrix(0.0)
+                ws4, wz4 = matrix(0.0, (cdim, 1)), matrix(0.0, (cdim, 1))
+
+            # stepsize() returns the maximum step to the boundary in the
+            # direction (ds, dz, dtau, dkappa), up to 1.
+            def stepsize(ds, dz, dtau, dkappa):
+                blas.copy(ds, ws4)
+                blas.copy(dz, wz4)
+                misc.scale2(lmbda, ws4, dims)
+                misc.scale2(lmbda, wz4, dims)
+                t = max([ 0.0, misc.max_step(ws4, dims, work = work),
+                    misc.max_step(wz4, dims, work = work), -dtau[0] /
+                    lmbda[-1], -dkappa[0] / lmbda[-1] ])
+                if t == 0.0: return 1.0
+                else: return min(1.0, 1.0 / t)
+
+            # target(v) returns the change needed to move the product v
+            # into the interval [lo, hi], or to reduce it by hi if it is
+            # larger than 2*hi.
+            def target(v):
+                if v < lo: return lo - v
+                elif v > hi: return max(hi - v, -hi)
+                else: return 0.0
+
         mu = blas.nrm2(lmbda)**2 / (1 + cdim_diag)
         sigma = 0.0
         for i in [0,1]:
@@ -1305,6 +1507,56 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                 misc.sprod(ws3, dz, dims)
                 wkappa3 = dtau[0] * dkappa[0]
 
+            # Gondzio's centrality correctors.  A corrector solves the
+            # Newton equations with zero residuals and
+            #
+            #     lmbda o (dz + ds) = t,  lmbdag * (dtau + dkappa) = tg,
+            #
+            # where t and tg move the products of the 'l' components and
+            # of tau and kappa at the trial point lmbda + step2 * (ds, dz),
+            # lmbdag + step2 * (dtau, dkappa), into [BETAMIN*sigma*mu,
+            # BETAMAX*sigma*mu].  step2 is the step in the current
+            # direction plus GSTEP.  The corrector is added to the
+            # direction if this increases the step by at least GSTEP/10.
+            # The 'q' and 's' components of t are zero.
+
+            if i == 1 and CORRECTORS:
+                lo, hi = BETAMIN * sigma * mu, BETAMAX * sigma * mu
+                step = stepsize(ds, dz, dtau, dkappa)
+                for k in range(CORRECTORS):
+                    if step == 1.0: break
+                    step2 = min(1.0, step + GSTEP)
+
+                    xscal(0.0, gx)
+                    yscal(0.0, gy)
+                    blas.scal(0.0, gz)
+                    gtau[0] = 0.0
+                    blas.scal(0.0, gs)
+                    if dims['l']:
+                        v = base.mul(lmbda[:dims['l']] + step2 *
+                            ds[:dims['l']], lmbda[:dims['l']] + step2 *
+                            dz[:dims['l']])
+                        gs[:dims['l']] = matrix([ -target(vk) for vk in v ])
+                    gkappa[0] = -target((lmbda[-1] + step2 * dtau[0]) *
+                        (lmbda[-1] + step2 * dkappa[0]))
+                    f6(gx, gy, gz, gtau, gs, gkappa)
+
+                    xaxpy(dx, gx)
+                    yaxpy(dy, gy)
+                    blas.axpy(dz, gz)
+                    gtau[0] += dtau[0]
+                    blas.axpy(ds, gs)
+                    gkappa[0] += dkappa[0]
+                    gstep = stepsize(gs, gz, gtau, gkappa)
+                    if gstep < step + 0.1 * GSTEP: break
+                    xcopy(gx, dx)
+                    ycopy(gy, dy)
+                    blas.copy(gz, dz)
+                    dtau[0] = gtau[0]
+                    blas.copy(gs, ds)
+                    dkappa[0] = gkappa[0]
+                    step = gstep
+
             # Maximum step to boundary.
             #
             # If i is 1, also compute eigenvalue decomposition of the 's'
@@ -1313,12 +1565,17 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
 
             misc.scale2(lmbda, ds, dims)
             misc.scale2(lmbda, dz, dims)
-            if i == 0:
-                ts = misc.max_step(ds, dims)
-                tz = misc.max_step(dz, dims)
+            if i == 0 and LANCZOS:
+                ts = misc.max_step(ds, dims, lanczos = LANCZOS, v =
+                    eigvs, work = work)
+                tz = misc.max_step(dz, dims, lanczos = LANCZOS, v =
+                    eigvz, work = work)
+            elif i == 0:
+                ts = misc.max_step(ds, dims, work = work)
+                tz = misc.max_step(dz, dims, work = work)
             else:
-                ts = misc.max_step(ds, dims, sigma = sigs)
-                tz = misc.max_step(dz, dims, sigma = sigz)
+                ts = misc.max_step(ds, dims, sigma = sigs, work = work)
+                tz = misc.max_step(dz, dims, sigma = sigz, work = work)
             tt = -dtau[0] / lmbda[-1]
             tk = -dkappa[0] / lmbda[-1]
             t = max([ 0.0, ts, tz, tt, tk ])
@@ -1419,7 +1676,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                 incy = m+1)
             ind += m
             ind2 += m*m
-        misc.scale(s, W, trans = 'T')
+        misc.scale(s, W, trans = 'T', work = work)
 
         blas.copy(lmbda, z, n = dims['l'] + sum(dims['q']))
         ind = dims['l'] + sum(dims['q'])
@@ -1430,7 +1687,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
                     incy = m+1)
             ind += m
             ind2 += m*m
-        misc.scale(z, W, inverse = 'I')
+        misc.scale(z, W, inverse = 'I', work = work)
 
         kappa, tau = lmbda[-1]/dgi, lmbda[-1]*dgi
         gap = ( blas.nrm2(lmbda, n = lmbda.size[0]-1) / tau )**2
@@ -1440,7 +1697,7 @@ def conelp(c, G, h, dims = None, A = None, b = None, primalstart = None,
 def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
     initvals = None, kktsolver = None, xnewcopy = None, xdot = None,
     xaxpy = None, xscal = None, ynewcopy = None, ydot = None, yaxpy = None,
-    yscal = None, **kwargs):
+    yscal = None, warmstart = None, **kwargs):
     """
 
     Solves a pair of primal and dual convex quadratic cone programs
@@ -1529,6 +1786,12 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
         A default initialization is used for the variables that are not
         specified in initvals.
 
+        The argument warmstart is a solution dictionary returned by
+        coneqp() for a problem with the same dimensions.  If it has
+        status 'optimal' or 'unknown', the starting point is computed
+        from its 'x', 's', 'y', 'z' fields by shifting s and z into the
+        interior of the cone, and initvals is ignored.
+
         It is assumed that rank(A) = p and rank([P; A; G]) = n.
 
         The other arguments are normally not needed.  They make it possible
@@ -1757,7 +2020,26 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
            1 otherwise)
        options['abstol'] scalar (default: 1e-7)
        options['reltol'] scalar (default: 1e-6)
-       options['feastol'] scalar (default: 1e-7).
+       options['feastol'] scalar (default: 1e-7)
+       options['mixed_precision'] True/False (default: False).  If True,
+           the KKT matrix is factored in single precision and the
+           solutions are refined in double precision.  Requires 
+           kktsolver 'ldl', 'ldl2' or 'chol' (default: 'chol').
+       options['centrality_correctors'] nonnegative integer (default:
+           0).  The maximum number of Gondzio centrality correctors per
+           iteration (see conelp()).
+       options['equilibrate'] True/False (default: False).  If True and
+           kktsolver is not a function, the rows and columns of P, G and
+           A are scaled as in conelp() before the problem is solved.
+       options['profile'] True/False (default: False).
+       options['profile_callback'] function (default: None).  See
+           conelp().
+       options['time_limit'] positive scalar (default: None).  See
+           conelp().
+       options['cancel'] solvers.CancelToken (default: None).  See
+           conelp().
+       options['lanczos'] nonnegative integer (default: 0).  See
+           conelp().
 
     """
     import math
@@ -1767,6 +2049,9 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
     STEP = 0.99
     EXPON = 3
 
+    # Parameters of the centrality correctors.
+    BETAMIN, BETAMAX, GSTEP = 0.1, 10.0, 0.1
+
     options = kwargs.get('options',globals()['options'])
 
     DEBUG = options.get('debug',False)
@@ -1784,6 +2069,15 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
     if not isinstance(MAXITERS,(int,long)) or MAXITERS < 1:
         raise ValueError("options['maxiters'] must be a positive integer")
 
+    CORRECTORS = options.get('centrality_correctors', 0)
+    if not isinstance(CORRECTORS,(int,long)) or CORRECTORS < 0:
+        raise ValueError("options['centrality_correctors'] must be a "\
+            "nonnegative integer")
+
+    LANCZOS = options.get('lanczos', 0)
+    if not isinstance(LANCZOS,(int,long)) or LANCZOS < 0:
+        raise ValueError("options['lanczos'] must be a nonnegative integer")
+
     ABSTOL = options.get('abstol',1e-7)
     if not isinstance(ABSTOL,(float,int,long)):
         raise ValueError("options['abstol'] must be a scalar")
@@ -1802,15 +2096,48 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
 
     show_progress = options.get('show_progress',True)
 
+    MIXED = options.get('mixed_precision', False)
+    if MIXED not in (True, False):
+        raise ValueError("options['mixed_precision'] must be True or False")
+
+    EQUIL = options.get('equilibrate', False)
+    if EQUIL not in (True, False):
+        raise ValueError("options['equilibrate'] must be True or False")
+
+    # options['time_limit'] and options['cancel'] are checked once per
+    # iteration.
+    deadline = misc.Deadline.from_options(options)
+
+    # With options['profile'] True, the problem is solved with a Profile
+    # object in options['profile'] that records the timings.
+    prof = options.get('profile', False)
+    if not isinstance(prof, misc.Profile):
+        if prof not in (True, False):
+            raise ValueError("options['profile'] must be True or False")
+        if prof:
+            prof = misc.Profile(options.get('profile_callback', None))
+            sol = coneqp(P, q, G, h, dims, A, b, initvals, kktsolver,
+                xnewcopy, xdot, xaxpy, xscal, ynewcopy, ydot, yaxpy, yscal,
+                warmstart, options = dict(options, profile = prof))
+            sol['profile'] = prof.result()
+            return sol
+        prof = None
+
+    # A KKT solver created by Problem is used as the default solver with
+    # its name, with the factorization routine it created for G and A.
+    prebuilt = None
+    if isinstance(kktsolver, _KKTSolver):
+        prebuilt, kktsolver = kktsolver, kktsolver.name
+
     if kktsolver is None:
-        if dims and (dims['q'] or dims['s']):
-            kktsolver = 'chol'
-        else:
-            kktsolver = 'chol2'
+        kktsolver = _default_kktsolver(G, dims, qp = True, mixed = MIXED)
     defaultsolvers = ('ldl', 'ldl2', 'chol', 'chol2')
     if isinstance(kktsolver,str) and kktsolver not in defaultsolvers:
         raise ValueError("'%s' is not a valid value for kktsolver" \
             %kktsolver)
+    if MIXED and isinstance(kktsolver,str) and kktsolver == 'chol2':
+        raise ValueError("options['mixed_precision'] requires kktsolver "\
+            "'ldl', 'ldl2' or 'chol'")
 
     # Argument error checking depends on level of customization.
     customkkt = not isinstance(kktsolver,str)
@@ -1926,6 +2253,20 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
         raise ValueEror("use of non-vector type for y requires b")
 
 
+    # Solve the problem with scaled rows and columns of P, G and A, and
+    # map the solution back.
+    if EQUIL and not customkkt:
+        q, G, h, A, b, P, S = misc.equilibrate(q, G, h, dims, A, b, P)
+        if initvals is not None:
+            initvals = misc.unscale_point(S, initvals, inverse = True)
+        if warmstart is not None:
+            warmstart = misc.unscale_point(S, warmstart, inverse = True)
+        sol = coneqp(P, q, G, h, dims, A, b, initvals, kktsolver =
+            kktsolver, warmstart = warmstart, options = dict(options,
+            equilibrate = False))
+        return misc.unscale_point(S, sol)
+
+
     ws3, wz3 = matrix(0.0, (cdim,1 )), matrix(0.0, (cdim,1 ))
     def res(ux, uy, uz, us, vx, vy, vz, vs, W, lmbda):
 
@@ -1969,17 +2310,18 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
     if kktsolver in defaultsolvers:
          if KKTREG is None and b.size[0] > q.size[0]:
              raise ValueError("Rank(A) < p or Rank([P; G; A]) < n")
-         if kktsolver == 'ldl':
-             factor = misc.kkt_ldl(G, dims, A, kktreg = KKTREG)
-         elif kktsolver == 'ldl2':
-             factor = misc.kkt_ldl2(G, dims, A)
-         elif kktsolver == 'chol':
-             factor = misc.kkt_chol(G, dims, A)
+         if prof: prof.set_kkt(kktsolver, q.size[0], b.size[0], cdim)
+         if prebuilt is not None:
+             factor = prebuilt.factor
          else:
-             factor = misc.kkt_chol2(G, dims, A)
+             factor = _kkt_factor(kktsolver, G, dims, A, KKTREG, MIXED)
          def kktsolver(W):
              return factor(W, P)
 
+    if prof:
+        kktsolver = prof.kktsolver(kktsolver)
+        misc = prof.module(misc)
+
     if xnewcopy is None: xnewcopy = matrix
     if xdot is None: xdot = blas.dot
     if xaxpy is None: xaxpy = blas.axpy
@@ -2044,6 +2386,10 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
     x, y = xnewcopy(q), ynewcopy(b)
     s, z = matrix(0.0, (cdim, 1)), matrix(0.0, (cdim, 1))
 
+    if warmstart is not None:
+        warmstart = misc.warm_start(warmstart, dims)
+        if warmstart is not None: initvals = warmstart
+
     if initvals is None:
 
         # Factor
@@ -2157,6 +2503,14 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
     sigs = matrix(0.0, (sum(dims['s']), 1))
     sigz = matrix(0.0, (sum(dims['s']), 1))
 
+    # Workspace of misc.scale() and misc.max_step().
+    work = misc.workspace(dims)
+
+    # Starting vectors of the Lanczos method in max_step().
+    if LANCZOS:
+        eigvs = matrix(0.0, (sum(dims['s']), 1))
+        eigvz = matrix(0.0, (sum(dims['s']), 1))
+
 
     if show_progress:
         print("% 10s% 12s% 10s% 8s% 7s" %("pcost", "dcost", "gap", "pres",
@@ -2166,6 +2520,8 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
 
     for iters in range(MAXITERS + 1):
 
+        if prof: prof.iteration(iters)
+
         # f0 = (1/2)*x'*P*x + q'*x + r and  rx = P*x + q + A'*y + G'*z.
         xcopy(q, rx)
         fP(x, rx, beta = 1.0)
@@ -2202,26 +2558,31 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
             relgap = None
         pres = max(resy/resy0, resz/resz0)
         dres = resx/resx0
+        if prof: prof.mark('residuals')
 
         if show_progress:
             print("%2d: % 8.4e % 8.4e % 4.0e% 7.0e% 7.0e" \
                 %(iters, pcost, dcost, gap, pres, dres))
 
-        if ( pres <= FEASTOL and dres <= FEASTOL and ( gap <= ABSTOL or
-            (relgap is not None and relgap <= RELTOL) )) or \
-            iters == MAXITERS:
+        converged = pres <= FEASTOL and dres <= FEASTOL and ( gap <=
+            ABSTOL or (relgap is not None and relgap <= RELTOL) )
+        if converged: halt = None
+        elif iters == MAXITERS: halt = 'unknown'
+        elif deadline: halt = deadline.check()
+        else: halt = None
+
+        if converged or halt:
             ind = dims['l'] + sum(dims['q'])
             for m in dims['s']:
                 misc.symm(s, m, ind)
                 misc.symm(z, m, ind)
                 ind += m**2
-            ts = misc.max_step(s, dims)
-            tz = misc.max_step(z, dims)
-            if iters == MAXITERS:
+            ts = misc.max_step(s, dims, work = work)
+            tz = misc.max_step(z, dims, work = work)
+            if halt:
                 if show_progress:
-                    print("Terminated (maximum number of iterations "\
-                        "reached).")
-                status = 'unknown'
+                    print(misc.terminated[halt])
+                status = halt
             else:
                 if show_progress:
                     print("Optimal solution found.")
@@ -2263,8 +2624,8 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
                     misc.symm(s, m, ind)
                     misc.symm(z, m, ind)
                     ind += m**2
-                ts = misc.max_step(s, dims)
-                tz = misc.max_step(z, dims)
+                ts = misc.max_step(s, dims, work = work)
+                tz = misc.max_step(z, dims, work = work)
                 if show_progress:
                     print("Terminated (singular KKT matrix).")
                 return { 'x': x,  'y': y,  's': s,  'z': z,
@@ -2305,7 +2666,7 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
             # z := z - W'*s
             #    = bz - W'*(lambda o\ bs)
             blas.copy(s, ws3)
-            misc.scale(ws3, W, trans = 'T')
+            misc.scale(ws3, W, trans = 'T', work = work)
             blas.axpy(ws3, z, alpha = -1.0)
 
             # Solve for ux, uy, uz
@@ -2354,6 +2715,32 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
                 print("    's': %e" %misc.snrm2(ws, dims))
 
 
+        if CORRECTORS:
+            if iters == 0:
+                gx, gy = xnewcopy(q), ynewcopy(b)
+                gz, gs = matrix(0.0, (cdim, 1)), matrix(0.0, (cdim, 1))
+                ws4, wz4 = matrix(0.0, (cdim, 1)), matrix(0.0, (cdim, 1))
+
+            # stepsize() returns the maximum step to the boundary in the
+            # direction (ds, dz), up to 1.
+            def stepsize(ds, dz):
+                blas.copy(ds, ws4)
+                blas.copy(dz, wz4)
+                misc.scale2(lmbda, ws4, dims)
+                misc.scale2(lmbda, wz4, dims)
+                t = max([ 0.0, misc.max_step(ws4, dims, work = work),
+                    misc.max_step(wz4, dims, work = work) ])
+                if t == 0.0: return 1.0
+                else: return min(1.0, 1.0 / t)
+
+            # target(v) returns the change needed to move the product v
+            # into the interval [lo, hi], or to reduce it by hi if it is
+            # larger than 2*hi.
+            def target(v):
+                if v < lo: return lo - v
+                elif v > hi: return max(hi - v, -hi)
+                else: return 0.0
+
         mu = gap / (dims['l'] + len(dims['q']) + sum(dims['s']))
         sigma, eta = 0.0, 0.0
 
@@ -2408,8 +2795,8 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
                         misc.symm(s, m, ind)
                         misc.symm(z, m, ind)
                         ind += m**2
-                    ts = misc.max_step(s, dims)
-                    tz = misc.max_step(z, dims)
+                    ts = misc.max_step(s, dims, work = work)
+                    tz = misc.max_step(z, dims, work = work)
                     if show_progress:
                         print("Terminated (singular KKT matrix).")
                     return { 'x': x,  'y': y,  's': s,  'z': z,
@@ -2427,6 +2814,41 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
                 blas.copy(ds, ws3)
                 misc.sprod(ws3, dz, dims)
 
+            # Gondzio's centrality correctors.  A corrector solves the
+            # Newton equations with zero residuals and lmbda o (dz + ds) =
+            # t, where t moves the products of the 'l' components at the
+            # trial point lmbda + step2 * (ds, dz) into [BETAMIN*sigma*mu,
+            # BETAMAX*sigma*mu], as in conelp().
+
+            if i == 1 and CORRECTORS:
+                lo, hi = BETAMIN * sigma * mu, BETAMAX * sigma * mu
+                step = stepsize(ds, dz)
+                for k in range(CORRECTORS):
+                    if step == 1.0 or not dims['l']: break
+                    step2 = min(1.0, step + GSTEP)
+
+                    xscal(0.0, gx)
+                    yscal(0.0, gy)
+                    blas.scal(0.0, gz)
+                    blas.scal(0.0, gs)
+                    v = base.mul(lmbda[:dims['l']] + step2 * ds[:dims['l']],
+                        lmbda[:dims['l']] + step2 * dz[:dims['l']])
+                    gs[:dims['l']] = matrix([ target(vk) for vk in v ])
+                    try: f4(gx, gy, gz, gs)
+                    except ArithmeticError: break
+
+                    xaxpy(dx, gx)
+                    yaxpy(dy, gy)
+                    blas.axpy(dz, gz)
+                    blas.axpy(ds, gs)
+                    gstep = stepsize(gs, gz)
+                    if gstep < step + 0.1 * GSTEP: break
+                    xcopy(gx, dx)
+                    ycopy(gy, dy)
+                    blas.copy(gz, dz)
+                    blas.copy(gs, ds)
+                    step = gstep
+
 
             # Maximum steps to boundary.
             #
@@ -2436,12 +2858,17 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
 
             misc.scale2(lmbda, ds, dims)
             misc.scale2(lmbda, dz, dims)
-            if i == 0:
-                ts = misc.max_step(ds, dims)
-                tz = misc.max_step(dz, dims)
+            if i == 0 and LANCZOS:
+                ts = misc.max_step(ds, dims, lanczos = LANCZOS, v =
+                    eigvs, work = work)
+                tz = misc.max_step(dz, dims, lanczos = LANCZOS, v =
+                    eigvz, work = work)
+            elif i == 0:
+                ts = misc.max_step(ds, dims, work = work)
+                tz = misc.max_step(dz, dims, work = work)
             else:
-                ts = misc.max_step(ds, dims, sigma = sigs)
-                tz = misc.max_step(dz, dims, sigma = sigz)
+                ts = misc.max_step(ds, dims, sigma = sigs, work = work)
+                tz = misc.max_step(dz, dims, sigma = sigz, work = work)
             t = max([ 0.0, ts, tz ])
             if t == 0:
                 step = 1.0
@@ -2531,7 +2958,7 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
                 incy = m+1)
             ind += m
             ind2 += m*m
-        misc.scale(s, W, trans = 'T')
+        misc.scale(s, W, trans = 'T', work = work)
 
         blas.copy(lmbda, z, n = dims['l'] + sum(dims['q']))
         ind = dims['l'] + sum(dims['q'])
@@ -2542,13 +2969,13 @@ def coneqp(P, q, G = None, h = None, dims = None, A = None, b = None,
                 incy = m+1)
             ind += m
             ind2 += m*m
-        misc.scale(z, W, inverse = 'I')
+        misc.scale(z, W, inverse = 'I', work = work)
 
         gap = blas.dot(lmbda, lmbda)
 
 
 def lp(c, G, h, A = None, b = None, kktsolver = None, solver = None, primalstart = None,
-    dualstart = None, **kwargs):
+    dualstart = None, warmstart = None, **kwargs):
     """
 
     Solves a pair of primal and dual LPs
@@ -2570,10 +2997,13 @@ def lp(c, G, h, A = None, b = None, kktsolver = None, solver = None, primalstart
         matrices with one column.  The default values for A and b are
         empty matrices with zero rows.
 
-        solver is None, 'glpk' or 'mosek'.  The default solver (None)
-        uses the cvxopt conelp() function.  The 'glpk' solver is the
-        simplex LP solver from GLPK.  The 'mosek' solver is the LP solver
-        from MOSEK.
+        solver is None, 'glpk', 'mosek' or 'native'.  The default solver
+        (None) uses the cvxopt conelp() function.  The 'glpk' solver is
+        the simplex LP solver from GLPK.  The 'mosek' solver is the LP
+        solver from MOSEK.  The 'native' solver is a C implementation of
+        the coneqp() algorithm for small dense problems; it converts G
+        and A to dense matrices, does not detect infeasibility, and
+        ignores primalstart, dualstart and warmstart.
 
         The arguments primalstart and dualstart are ignored when solver
         is 'glpk' or 'mosek', and are optional when solver is None.
@@ -2586,6 +3016,11 @@ def lp(c, G, h, A = None, b = None, kktsolver = None, solver = None, primalstart
         be a dense 'd' matrix of length p;  dualstart['z'] must be a
         positive dense 'd' matrix of length m.
 
+        The argument warmstart is ignored when solver is 'glpk' or
+        'mosek'.  When solver is None, it can be a solution dictionary
+        returned by lp() for a problem with the same dimensions, which is
+        used to compute the starting point as described in conelp().
+
         When solver is None, we require n >= 1, Rank(A) = p and
         Rank([G; A]) = n
 
@@ -2766,7 +3201,21 @@ def lp(c, G, h, A = None, b = None, kktsolver = None, solver = None, primalstart
             options['refinement']  positive integer (default: 0)
             options['abstol'] scalar (default: 1e-7)
             options['reltol'] scalar (default: 1e-6)
-            options['feastol'] scalar (default: 1e-7).
+            options['feastol'] scalar (default: 1e-7)
+            options['presolve'] True/False (default: False).
+
+        If options['presolve'] is True, redundant constraints and fixed
+        variables are first removed by cvxopt.presolve.presolve().  If the
+        reduced problem is solved with status 'optimal', the solution is
+        mapped back to the original problem and the dictionary contains
+        an entry 'presolve' with the number of removed rows and columns.
+        This is also done if the status is 'time limit' or 'cancelled';
+        options['time_limit'] includes the time spent in the presolve.
+        Otherwise the original problem is solved, within the same time
+        limit, and primalstart, dualstart and warmstart are used only in
+        that case.  If the presolve finds that the equality constraints
+        are inconsistent, the status is 'primal infeasible' and the
+        certificate is computed without solving the problem.
 
         The control parameter names for GLPK are strings with the name of
         the GLPK parameter, listed in the GLPK documentation.  The MOSEK
@@ -2804,15 +3253,33 @@ def lp(c, G, h, A = None, b = None, kktsolver = None, solver = None, primalstart
     if not isinstance(b,matrix) or b.typecode != 'd' or b.size != (p,1):
         raise TypeError("'b' must be a dense matrix of size (%d,1)" %p)
 
+    if solver == 'native':
+        return _native(None, c, G, h, A, b, options)
+
     if solver == 'glpk':
         try: from cvxopt import glpk
         except ImportError: raise ValueError("invalid option "\
             "(solver = 'glpk'): cvxopt.glpk is not installed")
         opts = options.get('glpk',None)
+
+        # options['time_limit'] is passed to GLPK as 'tm_lim', unless
+        # that is set, and the deadline as the cancellation token.  A
+        # token in the GLPK options is checked by the deadline if
+        # options['cancel'] is not set.
+        deadline = misc.Deadline.from_options(options)
+        if deadline:
+            opts = dict(opts or glpk.options)
+            if deadline.cancel is None:
+                deadline.cancel = opts.get('cancel', None)
+            opts['cancel'] = deadline
+            if deadline.time_limit is not None and 'tm_lim' not in opts:
+                opts['tm_lim'] = int(math.ceil(1000.0 * deadline.time_limit))
         if opts:
             status, x, z, y = glpk.lp(c, G, h, A, b, options = opts)
         else:
             status, x, z, y = glpk.lp(c, G, h, A, b)
+        if deadline and status in ('time limit', 'cancelled'):
+            status = deadline.check() or status
 
         if status == 'optimal':
             resx0 = max(1.0, blas.nrm2(c))
@@ -3006,8 +3473,28 @@ def lp(c, G, h, A = None, b = None, kktsolver = None, solver = None, primalstart
             'residual as dual infeasibility certificate': dinfres,
             'primal slack': pslack, 'dual slack': dslack}
 
+    if options.get('presolve', False):
+        # The time limit includes the presolve, and the deadline is
+        # shared by the solves of the reduced and the original problem.
+        from cvxopt import presolve
+        deadline = misc.Deadline.from_options(options)
+        R = presolve.presolve(c, G, h, A, b)
+        if R['status'] == 'primal infeasible':
+            if options.get('show_progress', True):
+                print("Certificate of primal infeasibility found by "\
+                    "presolve.")
+            return presolve.postsolve(R)
+        if deadline:
+            options = dict(options, time_limit = None, cancel = deadline)
+        sol = conelp(R['c'], R['G'], R['h'], {'l': R['G'].size[0], 'q': [],
+            's': []}, R['A'], R['b'], kktsolver = kktsolver, options =
+            options)
+        if sol['status'] in ('optimal', 'time limit', 'cancelled'):
+            return presolve.postsolve(R, sol)
+
     return conelp(c, G, h, {'l': m, 'q': [], 's': []}, A,  b, primalstart,
-        dualstart, kktsolver = kktsolver, options = options)
+        dualstart, kktsolver = kktsolver, warmstart = warmstart, options =
+        options)
 
 
 def socp(c, Gl = None, hl = None, Gq = None, hq = None, A = None, b = None,
@@ -3602,6 +4089,15 @@ def sdp(c, Gl = None, hl = None, Gs = None, hs = None, A = None, b = None,
         triangular elements are accessed.  The default values of Gs and
         hs are empty lists.
 
+        Alternatively, Gs is a list of N lists of length n with the
+        columns of Gs[k] in factored form: None for a zero column, a 'd'
+        matrix U of size (m[k], r) for the matrix U*U', or a pair (U, V)
+        of such matrices for the symmetric part of U*V' (see
+        misc.LowRank).  The default solver then computes the products
+        with Gs[k] and the Schur complement of the KKT equations from
+        the factors, without forming Gs[k].  This is not supported by
+        the 'dsdp' solver, and kktsolver must be None or 'chol'.
+
         A is a dense or sparse 'd' matrix of size (p,n).  b is a dense 'd'
         matrix of size (p,1).  The default values of A and b are matrices
         with zero rows.
@@ -3828,7 +4324,9 @@ def sdp(c, Gl = None, hl = None, Gs = None, hs = None, A = None, b = None,
             options['refinement'] positive integer (default: 1)
             options['abstol'] scalar (default: 1e-7)
             options['reltol'] scalar (default: 1e-6)
-            options['feastol'] scalar (default: 1e-7).
+            options['feastol'] scalar (default: 1e-7)
+            options['chordal'] True/False (default: False).  See
+                conelp().
 
         The execution of the 'dsdp' solver is controlled by:
 
@@ -3859,15 +4357,29 @@ def sdp(c, Gl = None, hl = None, Gs = None, hs = None, A = None, b = None,
         raise TypeError("'hl' must be a 'd' matrix of size (%d,1)" %ml)
 
     if Gs is None: Gs = []
-    if not isinstance(Gs,list) or [ G for G in Gs if not isinstance(G,(matrix,spmatrix)) \
-      or G.typecode != 'd' or G.size[1] != n ]:
-        raise TypeError("'Gs' must be a list of sparse or dense 'd' "\
-            "matrices with %d columns" %n)
-    ms = [ int(math.sqrt(G.size[0])) for G in Gs ]
-    a = [ k for k in range(len(ms)) if ms[k]**2 != Gs[k].size[0] ]
-    if a: raise TypeError("the squareroot of the number of rows in "\
-        "'Gs[%d]' is not an integer" %k)
     if hs is None: hs = []
+    lowrank = isinstance(Gs,list) and len([ G for G in Gs if
+        isinstance(G,list) ]) > 0
+    if lowrank:
+        # The columns of Gs[k] in factored form (see misc.LowRank).  The
+        # orders of the blocks are given by hs.
+        if [ G for G in Gs if not isinstance(G,list) or len(G) != n ]:
+            raise TypeError("'Gs' must be a list of sparse or dense 'd' "\
+                "matrices, or a list of lists of length %d" %n)
+        ms = [ h.size[0] if isinstance(h,(matrix,spmatrix)) else 0 for h
+            in (hs if isinstance(hs,list) else []) ]
+        if solver == 'dsdp':
+            raise ValueError("solver 'dsdp' does not accept 'Gs' in "\
+                "factored form")
+    else:
+        if not isinstance(Gs,list) or [ G for G in Gs if not isinstance(G,(matrix,spmatrix)) \
+          or G.typecode != 'd' or G.size[1] != n ]:
+            raise TypeError("'Gs' must be a list of sparse or dense 'd' "\
+                "matrices with %d columns" %n)
+        ms = [ int(math.sqrt(G.size[0])) for G in Gs ]
+        a = [ k for k in range(len(ms)) if ms[k]**2 != Gs[k].size[0] ]
+        if a: raise TypeError("the squareroot of the number of rows in "\
+            "'Gs[%d]' is not an integer" %k)
     if not isinstance(hs,list) or len(hs) != len(ms) \
       or [ h for h in hs if not isinstance(h,(matrix,spmatrix)) or h.typecode != 'd' ]:
         raise TypeError("'hs' must be a list of %d dense or sparse "\
@@ -3897,6 +4409,17 @@ def sdp(c, Gl = None, hl = None, Gs = None, hs = None, A = None, b = None,
         if p: raise ValueError("sdp() with the solver = 'dsdp' option "\
             "does not handle problems with equality constraints")
         opts = options.get('dsdp',None)
+
+        # DSDP checks the deadline for options['time_limit'] and
+        # options['cancel'] after each iteration.  A token in the DSDP
+        # options is checked by the deadline if options['cancel'] is not
+        # set.
+        deadline = misc.Deadline.from_options(options)
+        if deadline:
+            opts = dict(opts or dsdp.options)
+            if deadline.cancel is None:
+                deadline.cancel = opts.get('cancel', None)
+            opts['cancel'] = deadline
         if opts:
             dsdpstatus, x, r, zl, zs = dsdp.sdp(c, Gl, hl, Gs, hs, options = opts)
         else:
@@ -3982,6 +4505,8 @@ def sdp(c, Gl = None, hl = None, Gs = None, hs = None, A = None, b = None,
         else:
             if dsdpstatus == 'DSDP_PDFEASIBLE':
                 status = 'optimal'
+            elif dsdpstatus == 'DSDP_CANCELLED':
+                status = (deadline and deadline.check()) or 'cancelled'
             else:
                 status = 'unknown'
             y = matrix(0.0, (0,1))
@@ -4082,17 +4607,19 @@ def sdp(c, Gl = None, hl = None, Gs = None, hs = None, A = None, b = None,
             'primal slack': pslack, 'dual slack': dslack}
 
     h = matrix(0.0, (N,1))
-    if isinstance(Gl,matrix) or [ Gk for Gk in Gs if isinstance(Gk,matrix) ]:
+    if lowrank:
+        G = misc.LowRank(Gl, Gs, ms)
+    elif isinstance(Gl,matrix) or [ Gk for Gk in Gs if isinstance(Gk,matrix) ]:
         G = matrix(0.0, (N, n))
     else:
         G = spmatrix([], [], [], (N, n), 'd')
     h[:ml] = hl
-    G[:ml,:] = Gl
+    if not lowrank: G[:ml,:] = Gl
     ind = ml
     for k in range(len(ms)):
         m = ms[k]
         h[ind : ind + m*m] = hs[k][:]
-        G[ind : ind + m*m, :] = Gs[k]
+        if not lowrank: G[ind : ind + m*m, :] = Gs[k]
         ind += m**2
 
     if primalstart:
@@ -4154,7 +4681,7 @@ def sdp(c, Gl = None, hl = None, Gs = None, hs = None, A = None, b = None,
 
 
 def qp(P, q, G = None, h = None, A = None, b = None, solver = None,
-    kktsolver = None, initvals = None, **kwargs):
+    kktsolver = None, initvals = None, warmstart = None, **kwargs):
 
     """
     Solves a quadratic program
@@ -4180,11 +4707,20 @@ def qp(P, q, G = None, h = None, A = None, b = None, solver = None,
 
         b is a p x 1 dense 'd' matrix or None.
 
-        solver is None or 'mosek'.
+        solver is None, 'mosek' or 'native'.  The 'native' solver is a C
+        implementation of the coneqp() algorithm for small dense
+        problems.  It converts P, G and A to dense matrices, does not
+        detect infeasibility, and ignores kktsolver, initvals and
+        warmstart.
 
         The default values for G, h, A and b are empty matrices with
         zero rows.
 
+        warmstart is None or a solution dictionary returned by qp() for
+        a problem with the same dimensions.  It is used to compute the
+        starting point as described in coneqp(), and is ignored when
+        solver is 'mosek'.
+
 
     Output arguments (default solver).
 
@@ -4325,7 +4861,12 @@ def qp(P, q, G = None, h = None, A = None, b = None, solver = None,
             options['refinement']  positive integer (default: 0)
             options['abstol'] scalar (default: 1e-7)
             options['reltol'] scalar (default: 1e-6)
-            options['feastol'] scalar (default: 1e-7).
+            options['feastol'] scalar (default: 1e-7)
+            options['presolve'] True/False (default: False).
+
+        If options['presolve'] is True, redundant constraints and fixed
+        variables are first removed by cvxopt.presolve.presolve(), as
+        described in lp().
 
         The MOSEK parameters can me modified by adding an entry
         options['mosek'], containing a dictionary with MOSEK
@@ -4340,6 +4881,9 @@ def qp(P, q, G = None, h = None, A = None, b = None, solver = None,
     from cvxopt import base, blas
     from cvxopt.base import matrix, spmatrix
 
+    if solver == 'native':
+        return _native(P, q, G, h, A, b, options)
+
     if solver == 'mosek':
         from cvxopt import misc
         try:
@@ -4482,4 +5026,461 @@ def qp(P, q, G = None, h = None, A = None, b = None, solver = None,
             'residual as primal infeasibility certificate': pinfres,
             'residual as dual infeasibility certificate': dinfres}
 
-    return coneqp(P, q, G, h, None, A,  b, initvals, kktsolver = kktsolver, options = options)
+    if options.get('presolve', False):
+        from cvxopt import misc, presolve
+        deadline = misc.Deadline.from_options(options)
+        R = presolve.presolve(q, G, h, A, b, P)
+        if R['status'] == 'primal infeasible':
+            if options.get('show_progress', True):
+                print("Certificate of primal infeasibility found by "\
+                    "presolve.")
+            return presolve.postsolve(R)
+        if deadline:
+            options = dict(options, time_limit = None, cancel = deadline)
+        sol = coneqp(R['P'], R['c'], R['G'], R['h'], None, R['A'], R['b'],
+            kktsolver = kktsolver, options = options)
+        if sol['status'] in ('optimal', 'time limit', 'cancelled'):
+            return presolve.postsolve(R, sol)
+
+    return coneqp(P, q, G, h, None, A,  b, initvals, kktsolver = kktsolver,
+        warmstart = warmstart, options = options)
+
+
+class Problem(object):
+    """
+    A cone program with fixed G, A and dims that is solved repeatedly
+    for different values of c, h and b.
+
+    prob = Problem(c, G, h, dims = None, A = None, b = None, P = None,
+        kktsolver = None, options = None)
+
+    PURPOSE
+    Defines the linear cone program solved by conelp(c, G, h, dims, A, b)
+    or, if P is not None, the quadratic cone program solved by
+    coneqp(P, c, G, h, dims, A, b).  The KKT solver for G, A, P and dims
+    is created once, so that the factorizations it computes for these
+    matrices (for example, the QR factorization of A' in kktsolver
+    'chol' and the symbolic factorizations in 'chol2') are reused by all
+    calls to prob.solve().
+
+    ARGUMENTS
+    c, G, h, dims, A, b, P  as in conelp() and coneqp().  G, A and P must
+              be dense or sparse 'd' matrices.
+
+    kktsolver None or one of the KKT solvers 'ldl', 'ldl2', 'qr',
+              'chol', 'chol2' of conelp(), or 'ldl', 'ldl2', 'chol',
+              'chol2' of coneqp().  The default is chosen as in conelp()
+              and coneqp().
+
+    options   None or a dictionary of algorithm parameters.  If None,
+              solvers.options is used.  The parameters 'mixed_precision'
+              and 'kktreg' are read when the problem is created.
+
+    sol = prob.solve(c = None, h = None, b = None, warmstart = False)
+
+    Solves the problem after replacing c, h and b with the arguments that
+    are not None, and returns the solution dictionary of conelp() or
+    coneqp().  The new values are kept for later calls.  If warmstart
+    is True, the solution of the previous call is used as a warm start
+    (see conelp()).  warmstart can also be a solution dictionary.
+    """
+
+    def __init__(self, c, G, h, dims = None, A = None, b = None, P = None,
+        kktsolver = None, options = None):
+
+        from cvxopt import matrix, spmatrix
+
+        opts = options
+        if opts is None: opts = globals()['options']
+
+        if not isinstance(c, matrix) or c.typecode != 'd' or c.size[1] != 1:
+            raise TypeError("'c' must be a 'd' matrix with one column")
+        n = c.size[0]
+        for name, M in [('G', G), ('A', A), ('P', P)]:
+            if M is not None and (not isinstance(M, (matrix, spmatrix)) or
+                M.typecode != 'd' or M.size[1] != n):
+                raise TypeError("'%s' must be a 'd' matrix with %d "\
+                    "columns" %(name, n))
+        if P is not None and P.size[0] != n:
+            raise TypeError("'P' must be a 'd' matrix of size (%d, %d)"\
+                %(n, n))
+        if G is None: G = spmatrix([], [], [], (0, n), 'd')
+        if h is None: h = matrix(0.0, (0, 1))
+        if A is None: A = spmatrix([], [], [], (0, n), 'd')
+        if b is None: b = matrix(0.0, (0, 1))
+        if not dims: dims = {'l': G.size[0], 'q': [], 's': []}
+
+        MIXED = opts.get('mixed_precision', False)
+        KKTREG = opts.get('kktreg', None)
+        if kktsolver is None:
+            kktsolver = _default_kktsolver(G, dims, qp = P is not None,
+                mixed = MIXED)
+        defaultsolvers = ('ldl', 'ldl2', 'chol', 'chol2')
+        if P is None: defaultsolvers += ('qr',)
+        if kktsolver not in defaultsolvers:
+            raise ValueError("'%s' is not a valid value for kktsolver" \
+                %kktsolver)
+        if MIXED and kktsolver not in ('ldl', 'ldl2', 'chol'):
+            raise ValueError("options['mixed_precision'] requires "\
+                "kktsolver 'ldl', 'ldl2' or 'chol'")
+
+        cdim_pckd = dims['l'] + sum(dims['q']) + sum([ k*(k+1)//2 for k
+            in dims['s'] ])
+        if KKTREG is None and (A.size[0] > n or (P is None and A.size[0] +
+            cdim_pckd < n)):
+            raise ValueError("Rank(A) < p or Rank([G; A]) < n")
+
+        self.kktsolver = _KKTSolver(kktsolver, G, dims, A, KKTREG, MIXED)
+
+        self.c, self.G, self.h, self.dims = c, G, h, dims
+        self.A, self.b, self.P = A, b, P
+        self.options = options
+        self.sol = None
+
+    def solve(self, c = None, h = None, b = None, warmstart = False):
+
+        if c is not None: self.c = c
+        if h is not None: self.h = h
+        if b is not None: self.b = b
+        if warmstart is True:
+            warmstart = self.sol
+        elif warmstart is False:
+            warmstart = None
+
+        options = self.options
+        if options is None: options = globals()['options']
+        if self.P is None:
+            self.sol = conelp(self.c, self.G, self.h, self.dims, self.A,
+                self.b, kktsolver = self.kktsolver, warmstart = warmstart,
+                options = options)
+        else:
+            self.sol = coneqp(self.P, self.c, self.G, self.h, self.dims,
+                self.A, self.b, kktsolver = self.kktsolver, warmstart =
+                warmstart, options = options)
+        return self.sol
+
+
+def _default_kktsolver(G, dims, qp = False, mixed = False):
+
+    # Name of the default KKT solver of conelp() (qp is False) or
+    # coneqp() (qp is True).
+    from cvxopt import misc
+    from cvxopt.base import spmatrix
+    cone = dims and (dims['q'] or dims['s'])
+    if qp:
+        if mixed or cone: return 'chol'
+        else: return 'chol2'
+    if mixed or isinstance(G, misc.LowRank) or (dims and dims['s'] and
+        type(G) is spmatrix):
+        return 'chol'
+    elif cone:
+        return 'qr'
+    else:
+        return 'chol2'
+
+
+def _kkt_factor(kktsolver, G, dims, A, kktreg, mixed):
+
+    # Factorization routine of the default KKT solver with name kktsolver.
+    from cvxopt import misc
+    if kktsolver == 'ldl':
+        return misc.kkt_ldl(G, dims, A, kktreg = kktreg, single = mixed)
+    elif kktsolver == 'ldl2':
+        return misc.kkt_ldl2(G, dims, A, single = mixed)
+    elif kktsolver == 'qr':
+        return misc.kkt_qr(G, dims, A)
+    elif kktsolver == 'chol':
+        return misc.kkt_chol(G, dims, A, single = mixed)
+    else:
+        return misc.kkt_chol2(G, dims, A)
+
+
+class _KKTSolver(object):
+
+    # The default KKT solver with name kktsolver, with its factorization
+    # routine created once for G, dims and A by Problem.  conelp() and
+    # coneqp() treat it as the named solver (so the options that apply
+    # to default solvers are used), but do not create the routine again.
+    # The problems converted by options['chordal'] and
+    # options['equilibrate'] have a different G and A, and are solved
+    # with a new routine.
+
+    def __init__(self, kktsolver, G, dims, A, kktreg, mixed):
+        self.name = kktsolver
+        self.factor = _kkt_factor(kktsolver, G, dims, A, kktreg, mixed)
+
+
+def _native_options(options):
+
+    # Keyword arguments of misc_solvers.qp() and misc_solvers.qp_batch()
+    # for the solver options.
+    MAXITERS = options.get('maxiters', 100)
+    if not isinstance(MAXITERS,(int,long)) or MAXITERS < 1:
+        raise ValueError("options['maxiters'] must be a positive integer")
+    ABSTOL = options.get('abstol', 1e-7)
+    if not isinstance(ABSTOL,(float,int,long)):
+        raise ValueError("options['abstol'] must be a scalar")
+    RELTOL = options.get('reltol', 1e-6)
+    if not isinstance(RELTOL,(float,int,long)):
+        raise ValueError("options['reltol'] must be a scalar")
+    if RELTOL <= 0.0 and ABSTOL <= 0.0 :
+        raise ValueError("at least one of options['reltol'] and " \
+            "options['abstol'] must be positive")
+    FEASTOL = options.get('feastol', 1e-7)
+    if not isinstance(FEASTOL,(float,int,long)) or FEASTOL <= 0.0:
+        raise ValueError("options['feastol'] must be a positive scalar")
+    KKTREG = options.get('kktreg', None)
+    if KKTREG is None:
+        KKTREG = 0.0
+    elif not isinstance(KKTREG,(float,int,long)) or KKTREG < 0.0:
+        raise ValueError("options['kktreg'] must be a nonnegative scalar")
+    return {'maxiters': MAXITERS, 'abstol': float(ABSTOL), 'reltol':
+        float(RELTOL), 'feastol': float(FEASTOL), 'kktreg': float(KKTREG),
+        'correction': int(bool(options.get('use_correction', True)))}
+
+
+def _native_data(P, q, G, h, A, b):
+
+    # Returns the tuple (q, G, h, A, b, P) of dense 'd' matrices used by
+    # misc_solvers.qp().  P is None for an LP.
+    from cvxopt.base import matrix, spmatrix
+
+    if not isinstance(q, matrix) or q.typecode != 'd' or q.size[1] != 1:
+        raise TypeError("'q' must be a 'd' matrix with one column")
+    n = q.size[0]
+    if n < 1: raise ValueError("number of variables must be at least 1")
+    if P is not None and (not isinstance(P, (matrix, spmatrix)) or
+        P.typecode != 'd' or P.size != (n, n)):
+        raise TypeError("'P' must be a 'd' matrix of size (%d, %d)" %(n, n))
+    if G is None: G = matrix(0.0, (0,n))
+    if not isinstance(G, (matrix, spmatrix)) or G.typecode != 'd' or \
+        G.size[1] != n:
+        raise TypeError("'G' must be a 'd' matrix with %d columns" %n)
+    m = G.size[0]
+    if h is None: h = matrix(0.0, (0,1))
+    if not isinstance(h, matrix) or h.typecode != 'd' or h.size != (m,1):
+        raise TypeError("'h' must be a 'd' matrix of size (%d,1)" %m)
+    if A is None: A = matrix(0.0, (0,n))
+    if not isinstance(A, (matrix, spmatrix)) or A.typecode != 'd' or \
+        A.size[1] != n:
+        raise TypeError("'A' must be a 'd' matrix with %d columns" %n)
+    p = A.size[0]
+    if b is None: b = matrix(0.0, (0,1))
+    if not isinstance(b, matrix) or b.typecode != 'd' or b.size != (p,1):
+        raise TypeError("'b' must be a 'd' matrix of size (%d,1)" %p)
+
+    def dense(M):
+        if isinstance(M, spmatrix): return matrix(M)
+        else: return M
+    if P is not None: P = dense(P)
+    return (q, dense(G), h, dense(A), b, P)
+
+
+def _native_sol(r, lp = False):
+
+    # Solution dictionary for a tuple returned by misc_solvers.qp().
+    status, x, s, y, z, info = r
+    if status == 'singular':
+        raise ValueError("Rank(A) < p or Rank([P; A; G]) < n")
+    sol = dict(info)
+    sol.update({'status': status, 'x': x, 's': s, 'y': y, 'z': z,
+        'primal slack': min(s) if len(s) else 0.0,
+        'dual slack': min(z) if len(z) else 0.0})
+    if lp:
+        sol['residual as primal infeasibility certificate'] = None
+        sol['residual as dual infeasibility certificate'] = None
+    return sol
+
+
+def _native(P, q, G, h, A, b, options):
+
+    # Solves a QP (or an LP if P is None) with misc_solvers.qp().
+    from cvxopt import misc_solvers
+    return _native_sol(misc_solvers.qp(_native_data(P, q, G, h, A, b),
+        **_native_options(options)), P is None)
+
+
+def _solve_batch(task):
+
+    # Solves one problem of a batch.  Defined at module level so that it
+    # can be used in a multiprocessing pool.
+    name, args, kwargs = task
+    return globals()[name](**dict(args, **kwargs))
+
+
+# Pool of worker processes of lp_batch(), qp_batch() and socp_batch().
+# It is created by the first call that needs it and kept for later calls
+# with the same number of processes.
+_pool, _pool_processes = None, 0
+_pool_lock = threading.Lock()
+
+def _close_pool():
+
+    global _pool, _pool_processes
+    if _pool is not None:
+        _pool.close()
+        _pool.join()
+    _pool, _pool_processes = None, 0
+
+
+atexit.register(_close_pool)
+
+
+def _batch_pool(processes):
+
+    global _pool, _pool_processes
+    import multiprocessing
+    if _pool_processes != processes:
+        _close_pool()
+        _pool = multiprocessing.Pool(processes)
+        _pool_processes = processes
+    return _pool
+
+
+def _batch(name, keys, problems, processes, kwargs):
+
+    if not isinstance(processes, (int, long)) or processes < 1:
+        raise ValueError("processes must be a positive integer")
+
+    # The problems are converted to dictionaries of arguments.  An
+    # argument cannot be given both by a problem and as a keyword
+    # argument for all problems.
+    probs = []
+    for prob in problems:
+        if isinstance(prob, dict):
+            unknown = [ k for k in prob if k not in keys ]
+            if unknown:
+                raise TypeError("invalid key '%s' in problem for %s()"
+                    %(unknown[0], name))
+        elif isinstance(prob, (tuple, list)):
+            if len(prob) > len(keys):
+                raise TypeError("%s() takes at most %d positional "\
+                    "arguments" %(name, len(keys)))
+            prob = dict(zip(keys, prob))
+        else:
+            raise TypeError("problems must be dictionaries or tuples")
+        both = [ k for k in keys if k in prob and k in kwargs ]
+        if both:
+            raise ValueError("'%s' is given in a problem and as a "\
+                "keyword argument of %s_batch()" %(both[0], name))
+        probs.append(prob)
+
+    # The options are copied, so that the worker processes use the same
+    # values as the calling process.
+    kwargs = dict(kwargs)
+    kwargs['options'] = dict(kwargs.get('options', globals()['options']))
+
+    # LPs and QPs with solver 'native' are solved in C by a team of
+    # threads, without pickling the problems.
+    args = [ dict(kwargs, **prob) for prob in probs ]
+    if name in ('lp', 'qp') and args and not [ a for a in args if
+        a.get('solver') != 'native' ]:
+        from cvxopt import misc_solvers
+        if name == 'lp':
+            data = [ _native_data(None, a['c'], a['G'], a['h'], a.get('A'),
+                a.get('b')) for a in args ]
+        else:
+            data = [ _native_data(a['P'], a['q'], a.get('G'), a.get('h'),
+                a.get('A'), a.get('b')) for a in args ]
+        return [ _native_sol(r, name == 'lp') for r in
+            misc_solvers.qp_batch(data, processes,
+            **_native_options(kwargs['options'])) ]
+
+    tasks = [ (name, prob, kwargs) for prob in probs ]
+    processes = min(processes, len(tasks))
+    if processes <= 1:
+        return [ _solve_batch(task) for task in tasks ]
+
+    with _pool_lock:
+        return _batch_pool(processes).map(_solve_batch, tasks, chunksize =
+            max(1, len(tasks) // (4 * processes)))
+
+
+def lp_batch(problems, processes = 1, **kwargs):
+    """
+    Solves a list of independent linear programs.
+
+    sols = lp_batch(problems, processes = 1, **kwargs)
+
+    PURPOSE
+    Returns the list of solution dictionaries lp(*prob, **kwargs), or
+    lp(**prob, **kwargs) if prob is a dictionary, for prob in problems.
+    The problems are divided over processes worker processes.
+
+    ARGUMENTS
+    problems  list of tuples with the positional arguments of lp(), or
+              dictionaries with keys 'c', 'G', 'h', 'A', 'b' and the other
+              arguments of lp().
+
+    processes positive integer.  If processes is greater than one, the
+              problems are solved by a pool of worker processes, since
+              the Python code of the solvers does not run in parallel in
+              threads.  The problem data and the solutions are pickled.
+              The pool is kept for later calls with the same number of
+              processes.  If solver is 'native', the problems are solved
+              in C by processes OpenMP threads instead.
+
+    kwargs    keyword arguments of lp() that are the same for all
+              problems, for example solver or options.  If options is
+              not given, a copy of solvers.options is used.  An argument
+              given by a problem (including a positional argument of a
+              tuple) cannot also be given in kwargs.
+    """
+
+    return _batch('lp', ('c', 'G', 'h', 'A', 'b', 'kktsolver', 'solver',
+        'primalstart', 'dualstart', 'warmstart'), problems, processes,
+        kwargs)
+
+
+def qp_batch(problems, processes = 1, **kwargs):
+    """
+    Solves a list of independent quadratic programs.
+
+    sols = qp_batch(problems, processes = 1, **kwargs)
+
+    PURPOSE
+    Returns the list of solution dictionaries qp(*prob, **kwargs), or
+    qp(**prob, **kwargs) if prob is a dictionary, for prob in problems.
+    The problems are divided over processes worker processes.
+
+    ARGUMENTS
+    problems  list of tuples with the positional arguments of qp(), or
+              dictionaries with keys 'P', 'q', 'G', 'h', 'A', 'b' and the
+              other arguments of qp().
+
+    processes positive integer.  See lp_batch().
+
+    kwargs    keyword arguments of qp() that are the same for all
+              problems.  See lp_batch().
+    """
+
+    return _batch('qp', ('P', 'q', 'G', 'h', 'A', 'b', 'solver',
+        'kktsolver', 'initvals', 'warmstart'), problems, processes,
+        kwargs)
+
+
+def socp_batch(problems, processes = 1, **kwargs):
+    """
+    Solves a list of independent second-order cone programs.
+
+    sols = socp_batch(problems, processes = 1, **kwargs)
+
+    PURPOSE
+    Returns the list of solution dictionaries socp(*prob, **kwargs), or
+    socp(**prob, **kwargs) if prob is a dictionary, for prob in problems.
+    The problems are divided over processes worker processes.
+
+    ARGUMENTS
+    problems  list of tuples with the positional arguments of socp(), or
+              dictionaries with keys 'c', 'Gl', 'hl', 'Gq', 'hq', 'A',
+              'b' and the other arguments of socp().
+
+    processes positive integer.  See lp_batch().
+
+    kwargs    keyword arguments of socp() that are the same for all
+              problems.  See lp_batch().
+    """
+
+    return _batch('socp', ('c', 'Gl', 'hl', 'Gq', 'hq', 'A', 'b',
+        'kktsolver', 'solver', 'primalstart', 'dualstart'), problems,
+        processes, kwargs)
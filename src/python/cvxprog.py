@@ -94,6 +94,10 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
             If Df and H are returned as sparse matrices, their sparsity
             patterns must be the same for each call to F(x) or F(x,z). 
 
+        F can also be a PyCapsule with a pointer to a C function that 
+        evaluates f, Df and H into buffers owned by the solver, as 
+        described in cvxopt.h (see misc.NLFunction).
+
         dims is a dictionary with the dimensions of the components of C.  
         It has three fields.
         - dims['l'] = ml, the dimension of the nonnegative orthant C_0.
@@ -373,7 +377,24 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
        options['refinement'] nonnegative integer (default: 1)
        options['abstol'] scalar (default: 1e-7)
        options['reltol'] scalar (default: 1e-6)
-       options['feastol'] scalar (default: 1e-7).
+       options['feastol'] scalar (default: 1e-7)
+       options['profile'] True/False (default: False)
+       options['profile_callback'] function (default: None).  See
+           coneprog.conelp().
+       options['time_limit'] positive scalar (default: None).  See
+           coneprog.conelp().
+       options['cancel'] solvers.CancelToken (default: None).  See
+           coneprog.conelp().
+       options['linesearch_batch'] positive integer (default: 1).  The 
+           number of trial steps of the line search evaluated together.
+           They are evaluated by one call to F.batch(X) if F has that
+           method, with X a list of points, returning the list of values
+           F(x) for x in X.
+       options['linesearch_threads'] positive integer (default: 1).  The
+           number of threads used to evaluate the trial steps if
+           options['linesearch_batch'] is greater than one and F has no
+           batch() method (F must then be thread-safe), or the number of
+           OpenMP threads if F is a PyCapsule.
 
     """
 
@@ -423,6 +444,35 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
     if not isinstance(refinement,(int,long)) or refinement < 0:
         raise ValueError("options['refinement'] must be a nonnegative integer")
 
+    LSBATCH = options.get('linesearch_batch', 1)
+    if not isinstance(LSBATCH,(int,long)) or LSBATCH < 1:
+        raise ValueError("options['linesearch_batch'] must be a positive "\
+            "integer")
+
+    LSTHREADS = options.get('linesearch_threads', 1)
+    if not isinstance(LSTHREADS,(int,long)) or LSTHREADS < 1:
+        raise ValueError("options['linesearch_threads'] must be a "\
+            "positive integer")
+
+    # options['time_limit'] and options['cancel'] are checked once per
+    # iteration.
+    deadline = misc.Deadline.from_options(options)
+
+    # With options['profile'] True, the problem is solved with a Profile
+    # object in options['profile'] that records the timings.
+    prof = options.get('profile', False)
+    if not isinstance(prof, misc.Profile):
+        if prof not in (True, False):
+            raise ValueError("options['profile'] must be True or False")
+        if prof:
+            prof = misc.Profile(options.get('profile_callback', None))
+            sol = cpl(c, F, G, h, dims, A, b, kktsolver, xnewcopy, xdot,
+                xaxpy, xscal, ynewcopy, ydot, yaxpy, yscal, options =
+                dict(options, profile = prof))
+            sol['profile'] = prof.result()
+            return sol
+        prof = None
+
     if kktsolver is None: 
         if dims and (dims['q'] or dims['s']):  
             kktsolver = 'chol'            
@@ -433,8 +483,38 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
         raise ValueError("'%s' is not a valid value for kktsolver" \
             %kktsolver)
 
+    F = misc.nlfunction(F, threads = LSTHREADS)
     try: mnl, x0 = F()   
     except: raise ValueError("function call 'F()' failed")
+
+    # The trial points of the line searches are evaluated by F.trial() if
+    # F has that method (misc.NLFunction), so that the values at x are
+    # not overwritten.
+    Ftrial = getattr(F, 'trial', F)
+
+    # With options['linesearch_batch'] = k > 1, the trial points of the
+    # line searches are evaluated k at a time, for the steps step, 
+    # BETA*step, ..., BETA**(k-1)*step, by one call to F.batch() if F 
+    # has that method, and otherwise by options['linesearch_threads'] 
+    # threads.  trial(step) returns the value of F at x + step*dx, from
+    # the last batch if it contains step.  The line searches test the
+    # same steps in the same order as with k = 1, so the accepted step 
+    # is the largest acceptable step in both cases.  trials is cleared
+    # when x or dx change.
+    Fbatch = getattr(F, 'batch', None)
+    trials = {}
+    def trial(step):
+        if step not in trials:
+            steps = [ step ]
+            for k in range(1, LSBATCH): steps.append(steps[-1] * BETA)
+            X = []
+            for st in steps:
+                X.append(xnewcopy(x));  xaxpy(dx, X[-1], alpha = st)
+            if Fbatch is not None: T = Fbatch(X)
+            else: T = misc.parallel_map(Ftrial, X, LSTHREADS)
+            trials.clear()
+            trials.update(zip(steps, T))
+        return trials[step]
     
     # Argument error checking depends on level of customization.
     customkkt = type(kktsolver) is not str
@@ -524,6 +604,7 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
     # where G = [Df(x); G].
 
     if kktsolver in defaultsolvers:
+         if prof: prof.set_kkt(kktsolver, c.size[0], b.size[0], mnl + cdim)
          if kktsolver == 'ldl': 
              factor = misc.kkt_ldl(G, dims, A, mnl, kktreg = KKTREG)
          elif kktsolver == 'ldl2': 
@@ -536,6 +617,10 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
              f, Df, H = F(x, z)
              return factor(W, H, Df)             
 
+    if prof:
+        kktsolver = prof.kktsolver(kktsolver)
+        misc = prof.module(misc)
+
 
     if xnewcopy is None: xnewcopy = matrix 
     if xdot is None: xdot = blas.dot
@@ -582,6 +667,9 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
     sigs = matrix(0.0, (sum(dims['s']), 1))
     sigz = matrix(0.0, (sum(dims['s']), 1))
 
+    # Workspace of misc.scale() and misc.max_step().
+    work = misc.workspace(dims)
+
     dz2, ds2 = matrix(0.0, (mnl + cdim, 1)), matrix(0.0, (mnl + cdim, 1))
 
     newx, newy = xnewcopy(x),  ynewcopy(y)
@@ -622,6 +710,8 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
     relaxed_iters = 0
     for iters in range(MAXITERS + 1):  
 
+        if prof: prof.iteration(iters)
+
         if refinement or DEBUG:  
             # We need H to compute residuals of KKT equations.
             f, Df, H = F(x, z[:mnl])
@@ -720,28 +810,33 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
         phi = theta1 * gap + theta2 * resx + theta3 * resznl
         pres = pres / pres0
         dres = dres / dres0
+        if prof: prof.mark('residuals')
 
         if show_progress:
             print("%2d: % 8.4e % 8.4e % 4.0e% 7.0e% 7.0e" \
                 %(iters, pcost, dcost, gap, pres, dres))
 
         # Stopping criteria.    
-        if ( pres <= FEASTOL and dres <= FEASTOL and ( gap <= ABSTOL or 
-            (relgap is not None and relgap <= RELTOL) )) or \
-            iters == MAXITERS:
+        converged = pres <= FEASTOL and dres <= FEASTOL and ( gap <=
+            ABSTOL or (relgap is not None and relgap <= RELTOL) )
+        if converged: halt = None
+        elif iters == MAXITERS: halt = 'unknown'
+        elif deadline: halt = deadline.check()
+        else: halt = None
+
+        if converged or halt:
             sl, zl = s[mnl:], z[mnl:]
             ind = dims['l'] + sum(dims['q'])
             for m in dims['s']:
                 misc.symm(sl, m, ind)
                 misc.symm(zl, m, ind)
                 ind += m**2
-            ts = misc.max_step(s, dims, mnl)
-            tz = misc.max_step(z, dims, mnl)
-            if iters == MAXITERS:
+            ts = misc.max_step(s, dims, mnl, work = work)
+            tz = misc.max_step(z, dims, mnl, work = work)
+            if halt:
                 if show_progress:
-                    print("Terminated (maximum number of iterations "\
-                        "reached).")
-                status = 'unknown'
+                    print(misc.terminated[halt])
+                status = halt
             else:
                 if show_progress:
                     print("Optimal solution found.")
@@ -826,8 +921,8 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
                     misc.symm(sl, m, ind)
                     misc.symm(zl, m, ind)
                     ind += m**2
-                ts = misc.max_step(s, dims, mnl)
-                tz = misc.max_step(z, dims, mnl)
+                ts = misc.max_step(s, dims, mnl, work = work)
+                tz = misc.max_step(z, dims, mnl, work = work)
                 if show_progress:
                     print("Terminated (singular KKT matrix).")
                 status = 'unknown'
@@ -872,7 +967,7 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
             # z := z - W'*s 
             #    = bz - W' * (lambda o\ bs)
             blas.copy(s, ws3)
-            misc.scale(ws3, W, trans = 'T')
+            misc.scale(ws3, W, trans = 'T', work = work)
             blas.axpy(ws3, z, alpha = -1.0)
 
             # Solve for ux, uy, uz
@@ -900,7 +995,7 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
             fH(ux, vx, alpha = -1.0, beta = 1.0)
             fA(uy, vx, alpha = -1.0, beta = 1.0, trans = 'T') 
             blas.copy(uz, wz3)
-            misc.scale(wz3, W, inverse = 'I')
+            misc.scale(wz3, W, inverse = 'I', work = work)
             fDf(wz3[:mnl], vx, alpha = -1.0, beta = 1.0, trans = 'T')
             fG(wz3[mnl:], vx, alpha = -1.0, beta = 1.0, trans = 'T') 
 
@@ -913,7 +1008,7 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
             fG(ux, wz2l)
             blas.axpy(wz2l, vz, alpha = -1.0, offsety = mnl)
             blas.copy(us, ws3) 
-            misc.scale(ws3, W, trans = 'T')
+            misc.scale(ws3, W, trans = 'T', work = work)
             blas.axpy(ws3, vz, alpha = -1.0)
 
             # vs -= lmbda o (uz + us)
@@ -1013,8 +1108,8 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
                         misc.symm(sl, m, ind)
                         misc.symm(zl, m, ind)
                         ind += m**2
-                    ts = misc.max_step(s, dims, mnl)
-                    tz = misc.max_step(z, dims, mnl)
+                    ts = misc.max_step(s, dims, mnl, work = work)
+                    tz = misc.max_step(z, dims, mnl, work = work)
                     if show_progress:
                         print("Terminated (singular KKT matrix).")
                     return {'status': 'unknown', 'x': x,  'y': y, 
@@ -1029,9 +1124,9 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
             # line search.
             dsdz = misc.sdot(ds, dz, dims, mnl)
             blas.copy(dz, dz2)
-            misc.scale(dz2, W, inverse = 'I')
+            misc.scale(dz2, W, inverse = 'I', work = work)
             blas.copy(ds, ds2)
-            misc.scale(ds2, W, trans = 'T')
+            misc.scale(ds2, W, trans = 'T', work = work)
 
             # Maximum steps to boundary. 
             # 
@@ -1040,9 +1135,9 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
             # The eigenvalues are stored in sigs, sigz.
 
             misc.scale2(lmbda, ds, dims, mnl)
-            ts = misc.max_step(ds, dims, mnl, sigs)
+            ts = misc.max_step(ds, dims, mnl, sigs, work = work)
             misc.scale2(lmbda, dz, dims, mnl)
-            tz = misc.max_step(dz, dims, mnl, sigz)
+            tz = misc.max_step(dz, dims, mnl, sigz, work = work)
             t = max([ 0.0, ts, tz ])
             if t == 0:
                 step = 1.0
@@ -1051,9 +1146,11 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
 
             # Backtrack until newx is in domain of f.
             backtrack = True
+            trials.clear()
             while backtrack:
                 xcopy(x, newx);  xaxpy(dx, newx, alpha = step)
-                t = F(newx)
+                if LSBATCH > 1: t = trial(step)
+                else: t = Ftrial(newx)
                 if t is None: newf = None
                 else: newf, newDf = t[0], t[1]
                 if newf is not None:
@@ -1129,7 +1226,8 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
                 blas.copy(z, newz);  blas.axpy(dz2, newz, alpha = step) 
                 blas.copy(s, news);  blas.axpy(ds2, news, alpha = step) 
 
-                t = F(newx)
+                if LSBATCH > 1: t = trial(step)
+                else: t = Ftrial(newx)
                 newf, newDf = matrix(t[0], tc = 'd'), t[1]
                 if type(newDf) is matrix or type(Df) is spmatrix:
                     if newDf.typecode != 'd' or \
@@ -1259,6 +1357,7 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
                             dsdz = dsdz0
                             sigma, eta = sigma0, eta0
                             relaxed_iters = -1
+                            trials.clear()
 
                         elif newphi <= phi + ALPHA * step * dphi:
                             # Series of relaxed line searches ends with
@@ -1345,7 +1444,7 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
                 incy = m+1)
             ind += m
             ind2 += m*m
-        misc.scale(s, W, trans = 'T')
+        misc.scale(s, W, trans = 'T', work = work)
 
         blas.copy(lmbda, z, n = mnl + dims['l'] + sum(dims['q']))
         ind = mnl + dims['l'] + sum(dims['q'])
@@ -1356,7 +1455,7 @@ def cpl(c, F, G = None, h = None, dims = None, A = None, b = None,
                 incy = m+1)
             ind += m
             ind2 += m*m
-        misc.scale(z, W, inverse = 'I')
+        misc.scale(z, W, inverse = 'I', work = work)
 
         gap = blas.dot(lmbda, lmbda) 
 
@@ -1422,6 +1521,10 @@ def cp(F, G = None, h = None, dims = None, A = None, b = None,
             If Df and H are returned as sparse matrices, their sparsity
             patterns must be the same for each call to F(x) or F(x,z). 
 
+        F can also be a PyCapsule with a pointer to a C function that 
+        evaluates f, Df and H into buffers owned by the solver, as 
+        described in cvxopt.h (see misc.NLFunction).
+
         dims is a dictionary with the dimensions of the components of C.  
         It has three fields.
         - dims['l'] = ml, the dimension of the nonnegative orthant C_0.
@@ -1645,7 +1748,24 @@ def cp(F, G = None, h = None, dims = None, A = None, b = None,
        options['refinement'] nonnegative integer (default: 1)
        options['abstol'] scalar (default: 1e-7)
        options['reltol'] scalar (default: 1e-6)
-       options['feastol'] scalar (default: 1e-7).
+       options['feastol'] scalar (default: 1e-7)
+       options['profile'] True/False (default: False)
+       options['profile_callback'] function (default: None).  See
+           coneprog.conelp().
+       options['time_limit'] positive scalar (default: None).  See
+           coneprog.conelp().
+       options['cancel'] solvers.CancelToken (default: None).  See
+           coneprog.conelp().
+       options['linesearch_batch'] positive integer (default: 1).  The 
+           number of trial steps of the line search evaluated together.
+           They are evaluated by one call to F.batch(X) if F has that
+           method, with X a list of points, returning the list of values
+           F(x) for x in X.
+       options['linesearch_threads'] positive integer (default: 1).  The
+           number of threads used to evaluate the trial steps if
+           options['linesearch_batch'] is greater than one and F has no
+           batch() method (F must then be thread-safe), or the number of
+           OpenMP threads if F is a PyCapsule.
 
     """
 
@@ -1656,6 +1776,8 @@ def cp(F, G = None, h = None, dims = None, A = None, b = None,
     from cvxopt import base, blas, misc
     from cvxopt.base import matrix, spmatrix 
 
+    F = misc.nlfunction(F, objective = True, threads = options.get(
+        'linesearch_threads', 1))
     mnl, x0 = F()
 
     # Argument error checking depends on level of customization.
@@ -1770,7 +1892,7 @@ def cp(F, G = None, h = None, dims = None, A = None, b = None,
     #     f_e(x,t) = (f0(x) - t, f1(x), ..., fmnl(x)).
     #     
 
-    def F_e(x = None, z = None):
+    def F_e(x = None, z = None, F = F):
 
         if x is None: 
             return mnl+1, [ x0, 0.0 ]
@@ -1822,6 +1944,14 @@ def cp(F, G = None, h = None, dims = None, A = None, b = None,
                         v[1] += beta*v[1]
                 return val, Df_e, H_e
 
+    # The line search of cpl() uses F_e.trial() and F_e.batch() if F 
+    # has these methods.
+    if hasattr(F, 'trial'):
+        F_e.trial = lambda x: F_e(x, F = F.trial)
+    if hasattr(F, 'batch'):
+        F_e.batch = lambda X: [ F_e(x, F = lambda u, v = v: v) for x, v in
+            zip(X, F.batch([ x[0] for x in X ])) ]
+
 
     # Linear inequality constraints.
     #
@@ -2050,7 +2180,14 @@ def gp(K, F, g, G=None, h=None, A=None, b=None, kktsolver=None, **kwargs):
        options['refinement'] nonnegative integer (default: 1)
        options['abstol'] scalar (default: 1e-7)
        options['reltol'] scalar (default: 1e-6)
-       options['feastol'] scalar (default: 1e-7).
+       options['feastol'] scalar (default: 1e-7)
+       options['profile'] True/False (default: False)
+       options['profile_callback'] function (default: None).  See
+           coneprog.conelp().
+       options['time_limit'] positive scalar (default: None).  See
+           coneprog.conelp().
+       options['cancel'] solvers.CancelToken (default: None).  See
+           coneprog.conelp().
     """
 
     options = kwargs.get('options',globals()['options'])
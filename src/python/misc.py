@@ -17,17 +17,25 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-import math
-from cvxopt import base, blas, lapack, cholmod, misc_solvers
-from cvxopt.base import matrix, spmatrix
+import math, time, threading
+from cvxopt import base, blas, lapack, cholmod, cache, misc_solvers
+from cvxopt.base import matrix, spmatrix, spdiag
 __all__ = []
 
+# Timer and peak memory use for Profile.
+_clock = getattr(time, 'perf_counter', time.time)
+try:
+    import resource
+    def _maxrss(): return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+except ImportError:
+    def _maxrss(): return None
+
 use_C = True
 
 if use_C:
   scale = misc_solvers.scale
 else:
-  def scale(x, W, trans = 'N', inverse = 'N'):  
+  def scale(x, W, trans = 'N', inverse = 'N', work = None):  
     """
     Applies Nesterov-Todd scaling or its inverse.
     
@@ -54,6 +62,8 @@ else:
     
     The 'dnl' and 'dnli' entries are optional, and only present when the 
     function is called from the nonlinear solver.
+
+    The workspace argument work is used by the C version only.
     """
 
     ind = 0
@@ -247,16 +257,20 @@ else:
         ind2 += m
 
 
-def compute_scaling(s, z, lmbda, dims, mnl = None):
+if use_C:
+  compute_scaling = misc_solvers.compute_scaling
+else:
+  def compute_scaling(s, z, lmbda, dims, mnl = None, W = None):
     """
     Returns the Nesterov-Todd scaling W at points s and z, and stores the 
     scaled variable in lmbda. 
     
         W * z = W^{-T} * s = lmbda. 
 
+    If the argument W is a dictionary, the scaling is stored in W.
     """
      
-    W = {}
+    if W is None: W = {}
 
     # For the nonlinear block:
     #
@@ -266,6 +280,8 @@ def compute_scaling(s, z, lmbda, dims, mnl = None):
 
     if mnl is None:
         mnl = 0
+        W.pop('dnl', None)
+        W.pop('dnli', None)
     else:
         W['dnl'] = base.sqrt( base.div( s[:mnl], z[:mnl] ))
         W['dnli'] = W['dnl']**-1
@@ -419,7 +435,10 @@ def compute_scaling(s, z, lmbda, dims, mnl = None):
     return W
 
 
-def update_scaling(W, lmbda, s, z):
+if use_C:
+  update_scaling = misc_solvers.update_scaling
+else:
+  def update_scaling(W, lmbda, s, z):
     """
     Updates the Nesterov-Todd scaling matrix W and the scaled variable 
     lmbda so that on exit
@@ -1015,7 +1034,8 @@ else:
 if use_C:
   max_step = misc_solvers.max_step
 else:
-  def max_step(x, dims, mnl = 0, sigma = None):
+  def max_step(x, dims, mnl = 0, sigma = None, lanczos = 0, v = None,
+      work = None):
     """
     Returns min {t | x + t*e >= 0}, where e is defined as follows
     
@@ -1025,6 +1045,10 @@ else:
     
     When called with the argument sigma, also returns the eigenvalues 
     (in sigma) and the eigenvectors (in x) of the 's' components of x.
+
+    The arguments lanczos and v select the Lanczos method for large 's'
+    blocks in the C version, and are ignored here, as is the workspace
+    work.
     """
 
     t = []
@@ -1052,7 +1076,784 @@ else:
     else: return 0.0
 
 
-def kkt_ldl(G, dims, A, mnl = 0, kktreg = None):
+if use_C:
+  workspace = misc_solvers.workspace
+else:
+  def workspace(dims):
+    """
+    Returns a workspace for scale() and max_step(), sized for vectors
+    with the cone dimensions dims.  The Python versions of these
+    functions do not use a workspace, and None is returned.
+    """
+
+    return None
+
+
+if use_C:
+  schur = misc_solvers.schur
+else:
+  def schur(G, W, H, dims):
+    """
+    Adds the 's' blocks of G' * W^{-1} * W^{-T} * G to H.
+
+    G is a sparse 'd' matrix of size (N, n) with
+
+        N = dims['l'] + sum(dims['q']) + sum( k**2 for k in dims['s'] ),
+
+    and only the lower triangular parts of its 's' blocks are 
+    referenced.  On exit the lower triangular part of the 'd' matrix H 
+    of order n is 
+
+        H := H + sum_k Gk' * W_k^{-1} * W_k^{-T} * Gk, 
+
+    where the sum is over the 's' blocks and Gk are the rows of G for 
+    block k.  With V = rti * rti' and F_i the symmetric matrix in column
+    i of Gk, the (j, i) entry of block k is tr(F_j * V * F_i * V).  The C
+    version computes it from the nonzeros of G only.
+    """
+
+    n = G.size[1]
+    ind = dims['l'] + sum(dims['q'])
+    for k, m in enumerate(dims['s']):
+        rti = W['rti'][k]
+        V = rti * rti.T
+        F = []
+        for j in range(n):
+            L = matrix(G[ind : ind + m*m, j], (m, m))
+            for i in range(m): L[:i, i] = 0.0
+            F.append(L + L.T - spmatrix(L[::m+1], range(m), range(m)))
+        for i in range(n):
+            B = V * F[i] * V
+            for j in range(i, n):
+                H[j, i] += blas.dot(F[j], B)
+        ind += m**2
+
+
+class LowRank(object):
+    """
+    Constraint matrix of a cone LP with 's' blocks in factored form.
+
+    G = LowRank(Gl, Gs, ms)
+
+    Gl is a dense or sparse 'd' matrix of size (ml, n) with the rows of G
+    for the 'l' and 'q' constraints.  ms is the list of orders of the 's'
+    blocks, and Gs[k] is a list of length n with the columns of block k:
+    None (a zero column), a 'd' matrix U of size (ms[k], r) for the 
+    matrix U*U', or a tuple (U, V) of two such matrices for the 
+    symmetric part of U*V'.  G has size (ml + sum(m**2 for m in ms), n),
+    and can be passed as the argument G of conelp() with the default KKT
+    solver 'chol', or called as G(x, y, trans = 'N', alpha = 1.0, beta = 
+    0.0) like the function valued G of conelp().  The products with G 
+    and the Schur complement of the KKT equations are computed from the
+    factors, at a cost proportional to the rank r of the factors instead
+    of the order of the blocks.
+    """
+
+    def __init__(self, Gl, Gs, ms):
+        if not isinstance(Gl, (matrix, spmatrix)) or Gl.typecode != 'd':
+            raise TypeError("'Gl' must be a dense or sparse 'd' matrix")
+        n = Gl.size[1]
+        if not isinstance(Gs, list) or len(Gs) != len(ms) or [ Gk for Gk
+            in Gs if not isinstance(Gk, list) or len(Gk) != n ]:
+            raise TypeError("'Gs' must be a list of %d lists of length %d"
+                %(len(ms), n))
+        self.Gl, self.ms = Gl, list(ms)
+        self.size = (Gl.size[0] + sum([ m**2 for m in ms ]), n)
+
+        # For block k, the factors of the columns side by side in U[k] and
+        # V[k] (None if V = U), and the n x r matrix S[k] with S[j, i] = 1
+        # if column i of the factors belongs to column j of G.
+        self.U, self.V, self.S = [], [], []
+        for Gk, m in zip(Gs, ms):
+            U, V, J = [], [], []
+            for j, F in enumerate(Gk):
+                if F is None: continue
+                Uj, Vj = F if isinstance(F, tuple) else (F, F)
+                if not isinstance(Uj, matrix) or not isinstance(Vj, matrix) \
+                    or Uj.typecode != 'd' or Vj.typecode != 'd' or \
+                    Uj.size[0] != m or Uj.size != Vj.size:
+                    raise TypeError("the factors of the columns of an 's' "\
+                        "block of order %d must be 'd' matrices with %d "\
+                        "rows" %(m, m))
+                U.append(Uj)
+                V.append(Vj)
+                J += Uj.size[1] * [j]
+            r = len(J)
+            self.U.append(matrix([ [Uj] for Uj in U ]) if r else
+                matrix(0.0, (m, 0)))
+            self.V.append(None if all([ Uj is Vj for Uj, Vj in zip(U, V) ])
+                else matrix([ [Vj] for Vj in V ]))
+            self.S.append(spmatrix(1.0, J, range(r), (n, r)))
+
+    def __call__(self, x, y, trans = 'N', alpha = 1.0, beta = 0.0):
+        """
+        y := alpha*G*x + beta*y (trans is 'N') or alpha*G'*x + beta*y 
+        (trans is 'T').  The 's' blocks are in unpacked 'L' storage.
+        """
+
+        ml = self.Gl.size[0]
+        if trans == 'N':
+            blas.scal(beta, y, n = self.size[0])
+            if ml: base.gemv(self.Gl, x, y, alpha = alpha, beta = 1.0)
+        else:
+            blas.scal(beta, y, n = self.size[1])
+            if ml: base.gemv(self.Gl, x, y, alpha = alpha, beta = 1.0, 
+                trans = 'T')
+        ind = ml
+        for m, U, V, S in zip(self.ms, self.U, self.V, self.S):
+            if V is None: V = U
+            if trans == 'N':
+
+                # mat(y_k) += alpha * sym(U * diag(S'*x) * V').
+                T = U * spdiag(S.T * x)
+                M = T * V.T
+                blas.axpy(M + M.T, y, alpha = 0.5 * alpha, offsety = ind)
+
+            else:
+
+                # y += alpha * S * diag(V' * mat(x_k) * U).
+                X = matrix(x[ind : ind + m*m], (m, m))
+                for i in range(m): X[i, i+1:] = X[i+1:, i].T
+                w = matrix(1.0, (1, m)) * base.mul(X * U, V)
+                base.gemv(S, w.T, y, alpha = alpha, beta = 1.0)
+            ind += m**2
+
+    def schur(self, W, H):
+        """
+        Adds the 's' blocks of G' * W^{-1} * W^{-T} * G to H.
+
+        With Q = rti * rti' and F_i = sym(U_i * V_i'), the (i, j) entry
+        of block k is
+
+            tr(F_i * Q * F_j * Q) 
+                = 1/2 * sum( X_ij .* X_ji' + Y_ij .* Z_ij )
+
+        where X = V'*Q*U, Y = U'*Q*U and Z = V'*Q*V, and X_ij is the 
+        submatrix for the factors of columns i and j.  If V = U, this is
+        sum(Y_ij .* Y_ij).
+        """
+
+        for k, (U, V, S) in enumerate(zip(self.U, self.V, self.S)):
+            if not U.size[1]: continue
+            rti = W['rti'][k]
+            P = rti.T * U
+            Y = P.T * P
+            if V is None: 
+                T = base.mul(Y, Y)
+            else:
+                R = rti.T * V
+                X = R.T * P
+                T = 0.5 * (base.mul(X, X.T) + base.mul(Y, R.T * R))
+            H += S * T * S.T
+
+
+def warm_start(sol, dims, mu = 1e-3):
+    """
+    Returns a starting point built from a solution sol returned by
+    conelp() or coneqp() for a problem with the same dimensions, or
+    None if sol does not include a primal and a dual solution.
+
+    The starting point is a dictionary with keys 'x', 's', 'y', 'z'.
+    x and y are the values in sol.  s and z are copies of sol['s'] and
+    sol['z'], shifted along e into the interior of the cone by amounts
+    of the order of sqrt(muw), where muw is the maximum of s'*z / d and
+    mu * ||s|| * ||z|| / d, and d = ml + N + sum(ms) is the degree of
+    the cone.  This keeps the point close to sol, but away from the
+    boundary of the cone.
+    """
+
+    if sol.get('status') not in ('optimal', 'unknown') or \
+        [ k for k in ('x', 's', 'y', 'z') if sol.get(k) is None ]:
+        return None
+
+    cdim = dims['l'] + sum(dims['q']) + sum([ k**2 for k in dims['s'] ])
+    if sol['s'].size != (cdim, 1) or sol['z'].size != (cdim, 1):
+        raise ValueError("sol['s'] and sol['z'] must have length %d"
+            %cdim)
+    degree = max(1, dims['l'] + len(dims['q']) + sum(dims['s']))
+
+    s, z = +sol['s'], +sol['z']
+    nrms, nrmz = max(snrm2(s, dims), 1.0), max(snrm2(z, dims), 1.0)
+    muw = max(sdot(s, z, dims) / degree, mu * nrms * nrmz / degree)
+
+    # Shift s by a*sqrt(muw*rho) and z by a*sqrt(muw/rho), with
+    # rho = ||s|| / ||z||, in addition to the shift needed to make them
+    # nonnegative.
+    rho = nrms / nrmz
+    for u, a in [ (s, math.sqrt(muw * rho)), (z, math.sqrt(muw / rho)) ]:
+        a += max(max_step(u, dims), 0.0)
+        u[:dims['l']] += a
+        ind = dims['l']
+        for m in dims['q']:
+            u[ind] += a
+            ind += m
+        for m in dims['s']:
+            u[ind : ind + m*m : m+1] += a
+            ind += m**2
+
+    return {'x': sol['x'], 's': s, 'y': sol['y'], 'z': z}
+
+
+def equilibrate(c, G, h, dims, A, b, P = None, iters = 10):
+    """
+    Scales the rows and columns of the data of a cone program.
+
+    (c, G, h, A, b, P, S) = equilibrate(c, G, h, dims, A, b, P = None,
+        iters = 10)
+
+    Returns the data of the equivalent problem with
+
+        G := D*G*E,  h := D*h,  A := Dy*A*E,  b := Dy*b,  c := E*c,
+        P := E*P*E,
+
+    where D, Dy, E are positive diagonal matrices, and a dictionary S
+    with the diagonals in S['d'], S['dy'], S['e'].  The scaling is
+    computed by iters steps of Ruiz's method, which divides each row and
+    column of [P; G; A] by the square root of its 2-norm.  The rows of
+    the 'l' block of G and the rows of A are scaled individually.  Each
+    'q' and 's' block of G is scaled by a single factor, so that D maps
+    the cone onto itself.  G and A must be dense or sparse matrices, and
+    only the lower triangular part of P is referenced.
+
+    The solutions of the two problems are related by
+
+        x = E*x_s,  s = D^{-1}*s_s,  y = Dy*y_s,  z = D*z_s
+
+    (see unscale_point()).  These relations also hold for certificates
+    of infeasibility, and the objective values are the same.
+    """
+
+    n, cdim, p = c.size[0], G.size[0], A.size[0]
+
+    # M has the squares of the entries of [G; A], Q the squares of the
+    # entries of the symmetric matrix P.
+    M = base.sparse([G, A])
+    M = spmatrix(base.mul(M.V, M.V), M.I, M.J, M.size)
+    if P is not None:
+        Ps = base.sparse(P)
+        L = [ (v*v, i, j) for v, i, j in zip(Ps.V, Ps.I, Ps.J) if i >= j ]
+        Q = spmatrix([ v for v, i, j in L ], [ i for v, i, j in L ],
+            [ j for v, i, j in L ], (n,n)) + spmatrix([ v for v, i, j in L
+            if i > j ], [ j for v, i, j in L if i > j ], [ i for v, i, j in
+            L if i > j ], (n,n))
+
+    blocks = [ (dims['l'] + sum(dims['q'][:k]), m) for k, m in
+        enumerate(dims['q']) ]
+    ind = dims['l'] + sum(dims['q'])
+    for m in dims['s']:
+        blocks.append((ind, m*m))
+        ind += m*m
+
+    def rsqrt(u):
+        # u := u^(-1/4), with zeros replaced by ones.
+        for k in range(len(u)):
+            u[k] = u[k]**-0.25 if u[k] > 0.0 else 1.0
+
+    d, e = matrix(1.0, (cdim + p, 1)), matrix(1.0, (n,1))
+    for it in range(iters):
+
+        # Squared row norms of diag(d) * M * diag(e), with the largest
+        # value in each cone block used for the whole block.
+        e2 = base.mul(e, e)
+        r = base.mul(base.mul(d, d), M*e2)
+        for k, m in blocks:
+            r[k:k+m] = max(r[k:k+m])
+        rsqrt(r)
+        d = base.mul(d, r)
+
+        # Squared column norms of [E*P*E; D*M*E].
+        d2 = base.mul(d, d)
+        r = M.T * d2
+        if P is not None: r += Q * e2
+        r = base.mul(e2, r)
+        rsqrt(r)
+        e = base.mul(e, r)
+
+    S = {'d': d[:cdim], 'dy': d[cdim:], 'e': e, 'dims': dims}
+    E = base.spdiag(e)
+    if cdim: G = base.spdiag(S['d']) * G * E
+    if p: A = base.spdiag(S['dy']) * A * E
+    if P is not None: P = E * P * E
+    return (base.mul(e, c), G, base.mul(S['d'], h), A, base.mul(S['dy'],
+        b), P, S)
+
+
+def unscale_point(S, sol, inverse = False):
+    """
+    Maps the variables of a problem scaled by equilibrate() to the
+    original problem.
+
+    S is the dictionary returned by equilibrate() and sol a dictionary
+    with (some of) the keys 'x', 's', 'y', 'z', for example a solution
+    dictionary returned by conelp() or coneqp().  Returns a copy of sol
+    with the vectors that are not None replaced by
+
+        x := E*x,  s := D^{-1}*s,  y := Dy*y,  z := D*z,
+
+    and, if inverse is True, by the values for the inverse mapping.  If
+    sol has entries 'primal slack' or 'dual slack' that are not None,
+    they are recomputed for the new s and z.
+    """
+
+    sol = dict(sol)
+    for key, u, scaled in [ ('x', S['e'], True), ('s', S['d'], False),
+        ('y', S['dy'], True), ('z', S['d'], True) ]:
+        if sol.get(key) is None: continue
+        if scaled != inverse:
+            sol[key] = base.mul(u, sol[key])
+        else:
+            sol[key] = base.div(sol[key], u)
+    for key, v in [ ('primal slack', 's'), ('dual slack', 'z') ]:
+        if sol.get(key) is not None and sol.get(v) is not None:
+            sol[key] = -max_step(sol[v], S['dims'])
+    return sol
+
+
+class Profile(object):
+    """
+    Records the time spent in the phases of an interior-point method.
+
+    prof = Profile(callback = None)
+
+    Used by conelp(), coneqp() and cpl() if options['profile'] is True.
+    The solvers call prof.iteration(k) at the start of iteration k, and
+    time the KKT solver and the scaling and step length functions by
+    replacing them with prof.kktsolver(kktsolver) and prof.module(misc).
+    The phases are
+
+    - 'factor': calls f = kktsolver(W),
+    - 'solve': calls to the functions f returned by kktsolver,
+    - 'scaling': compute_scaling() and update_scaling(),
+    - 'step': max_step(),
+    - 'residuals': the residuals and stopping criteria, i.e., the time
+      from the start of the iteration to prof.mark('residuals').
+
+    If callback is not None, callback(record) is called at the end of
+    each iteration with the dictionary described in result().
+    """
+
+    phases = ('factor', 'solve', 'scaling', 'step', 'residuals')
+
+    def __init__(self, callback = None):
+        if callback is not None and not callable(callback):
+            raise ValueError("options['profile_callback'] must be a "\
+                "function")
+        self.callback = callback
+        self.total = dict.fromkeys(self.phases, 0.0)
+        self.records = []
+        self.current = None
+        self.factorizations, self.solves = 0, 0
+        self.estimates = {'factor nnz': None, 'factor flops': None}
+        self.start = self.lap = _clock()
+
+    def set_kkt(self, kktsolver, n, p, cdim):
+        """
+        Sets the estimated number of nonzeros and flops of one
+        factorization by the default KKT solver kktsolver, for n
+        variables, p equality constraints and a cone of dimension cdim.
+        The estimates assume dense matrices, and are None for 'chol2'.
+        """
+
+        N = {'ldl': n + p + cdim, 'ldl2': n + p, 'chol': n, 'qr': n}.get(
+            kktsolver)
+        if N is None: return
+        nnz = N*(N+1) // 2
+        flops = N**3 // 3
+        if kktsolver in ('ldl2', 'chol'):
+            flops += cdim * n**2
+        if kktsolver == 'chol':
+            nnz += p*(p+1) // 2
+            flops += 2 * n * p**2
+        elif kktsolver == 'qr':
+            nnz = cdim * n + p * n
+            flops = 2 * (cdim + p) * n**2
+        self.estimates = {'factor nnz': nnz, 'factor flops': flops}
+
+    def add(self, phase, t):
+        self.total[phase] += t
+        if self.current is not None: self.current[phase] += t
+
+    def iteration(self, k):
+        """ Ends the current iteration and starts iteration k. """
+
+        self.close()
+        self.current = dict.fromkeys(self.phases, 0.0)
+        self.current['iteration'] = k
+        self.current['factorizations'], self.current['solves'] = 0, 0
+        self.lap = self.t0 = _clock()
+
+    def mark(self, phase):
+        """ Adds the time since the last mark to phase. """
+
+        t = _clock()
+        self.add(phase, t - self.lap)
+        self.lap = t
+
+    def close(self):
+        if self.current is None: return
+        record, self.current = self.current, None
+        record['time'] = _clock() - self.t0
+        record['memory'] = _maxrss()
+        self.records.append(record)
+        if self.callback is not None: self.callback(record)
+
+    def timed(self, phase, f):
+        """ Returns a function that calls f and times the call. """
+
+        def g(*args, **kwargs):
+            t = _clock()
+            try: return f(*args, **kwargs)
+            finally: self.add(phase, _clock() - t)
+        return g
+
+    def kktsolver(self, kktsolver):
+        """ Returns kktsolver with timed factorizations and solves. """
+
+        def factor(*args):
+            t = _clock()
+            f = kktsolver(*args)
+            self.add('factor', _clock() - t)
+            self.factorizations += 1
+            if self.current is not None: self.current['factorizations'] += 1
+            def solve(*args, **kwargs):
+                t = _clock()
+                try: return f(*args, **kwargs)
+                finally:
+                    self.add('solve', _clock() - t)
+                    self.solves += 1
+                    if self.current is not None:
+                        self.current['solves'] += 1
+            return solve
+        return factor
+
+    def module(self, module):
+        """
+        Returns an object with the attributes of module, with the
+        functions compute_scaling(), update_scaling() and max_step()
+        timed.
+        """
+
+        prof = self
+        class Timed(object):
+            def __getattr__(self, name):
+                f = getattr(module, name)
+                phase = {'compute_scaling': 'scaling', 'update_scaling':
+                    'scaling', 'max_step': 'step'}.get(name)
+                if phase: f = prof.timed(phase, f)
+                setattr(self, name, f)
+                return f
+        return Timed()
+
+    def result(self):
+        """
+        Ends the last iteration and returns a dictionary with keys
+
+        - 'time': the total time since the profile was created,
+        - 'total': a dictionary with the total time in each phase,
+        - 'factorizations', 'solves': the number of factorizations and
+          solves,
+        - 'factor nnz', 'factor flops': the estimates set by set_kkt(),
+        - 'iterations': a list with a dictionary for each iteration, with
+          the time in each phase, the keys 'iteration', 'time',
+          'factorizations', 'solves', and 'memory', the peak resident
+          set size of the process at the end of the iteration, as
+          reported by resource.getrusage() (None if not available).
+        """
+
+        self.close()
+        return dict(self.estimates, time = _clock() - self.start, total =
+            dict(self.total), factorizations = self.factorizations,
+            solves = self.solves, iterations = self.records)
+
+
+class CancelToken(object):
+    """
+    Thread-safe flag for cancelling a solver from another thread.
+
+    token = CancelToken()
+
+    If token is passed to a solver as options['cancel'], the solver
+    checks token.cancelled() once per iteration and returns the current
+    iterate with status 'cancelled' after token.cancel() is called.
+    """
+
+    def __init__(self):
+        self._event = threading.Event()
+
+    def cancel(self):
+        self._event.set()
+
+    def cancelled(self):
+        return self._event.is_set()
+
+    def reset(self):
+        self._event.clear()
+
+
+class Deadline(object):
+    """
+    Termination test for options['time_limit'] and options['cancel'].
+
+    deadline = Deadline(time_limit = None, cancel = None)
+
+    time_limit is a wall-clock limit in seconds, measured from the
+    creation of the object, and cancel an object with a method
+    cancelled(), e.g., a CancelToken.  deadline.check() returns
+    'cancelled', 'time limit' or None.  deadline.cancelled() returns
+    True if check() is not None, so a Deadline can be used as a
+    cancellation token by the GLPK and DSDP interfaces, and as
+    options['cancel'] of another solver.  In the last case the reason
+    of the outer deadline is also reported by the inner one.
+    """
+
+    def __init__(self, time_limit = None, cancel = None):
+        self.time_limit, self.cancel = time_limit, cancel
+        self.start = _clock()
+        self.reason = None
+
+    @classmethod
+    def from_options(cls, options):
+        """
+        Returns a Deadline for options['time_limit'] and
+        options['cancel'], or None if neither is set.
+        """
+
+        time_limit = options.get('time_limit', None)
+        if time_limit is not None and (not isinstance(time_limit,
+            (int, float)) or isinstance(time_limit, bool) or time_limit
+            <= 0.0):
+            raise ValueError("options['time_limit'] must be a positive "\
+                "scalar")
+        cancel = options.get('cancel', None)
+        if cancel is not None and not callable(getattr(cancel,
+            'cancelled', None)):
+            raise ValueError("options['cancel'] must be a CancelToken")
+        if time_limit is None and cancel is None: return None
+        return cls(time_limit, cancel)
+
+    def remaining(self):
+        """
+        Returns the remaining time in seconds, or None if there is no
+        time limit.
+        """
+
+        if self.time_limit is None: return None
+        return max(self.time_limit - (_clock() - self.start), 0.0)
+
+    def check(self):
+        if self.reason is None:
+            if self.cancel is not None and self.cancel.cancelled():
+                self.reason = getattr(self.cancel, 'reason', None) or \
+                    'cancelled'
+            elif self.time_limit is not None and _clock() - self.start >= \
+                self.time_limit:
+                self.reason = 'time limit'
+        return self.reason
+
+    def cancelled(self):
+        return self.check() is not None
+
+
+class NLFunction(object):
+    """
+    Nonlinear functions of cp() and cpl() implemented in C.
+
+    F = NLFunction(capsule, objective = False, threads = 1)
+
+    capsule is a PyCapsule with a pointer to a cvxopt_nlfunction (see
+    cvxopt.h) with m functions.  F can be called as the argument F of
+    cpl() (objective is False) or cp() (objective is True): F() returns
+    (mnl, x0) with mnl = m or m - 1, F(x) returns (f, Df) or None if x
+    is not in the domain, and F(x, z) returns (f, Df, H).  The function
+    is evaluated by misc_solvers.nlfunction(), and f, Df, H are the
+    same dense 'd' matrices in each call, overwritten by the next call.
+    F.trial(x) is F(x) with a second pair of matrices f, Df, used by
+    cpl() for the trial points of the line search.  F.batch(X) returns
+    the list [ F.trial(x) for x in X ], evaluated by 
+    misc_solvers.nlfunction_batch() with threads OpenMP threads and a 
+    pair of matrices f, Df for each point.  cp() and cpl() wrap a 
+    PyCapsule argument F in an NLFunction.
+    """
+
+    def __init__(self, capsule, objective = False, threads = 1):
+        self.capsule = capsule
+        self.threads = threads
+        self.fb, self.Dfb = [], []
+        self.m, self.n, self.x0 = misc_solvers.nlfunction(capsule)
+        self.mnl = self.m - 1 if objective else self.m
+        if self.mnl < 0:
+            raise ValueError("F must have at least one function")
+        self.f = matrix(0.0, (self.m, 1))
+        self.Df = matrix(0.0, (self.m, self.n))
+        self.H = matrix(0.0, (self.n, self.n))
+        self.ft = matrix(0.0, (self.m, 1))
+        self.Dft = matrix(0.0, (self.m, self.n))
+
+    def __call__(self, x = None, z = None):
+        if x is None:
+            return self.mnl, matrix(self.x0)
+        if not misc_solvers.nlfunction(self.capsule, x, z, self.f,
+            self.Df, self.H):
+            return None
+        if z is None:
+            return self.f, self.Df
+        return self.f, self.Df, self.H
+
+    def trial(self, x):
+        if not misc_solvers.nlfunction(self.capsule, x, None, self.ft,
+            self.Dft):
+            return None
+        return self.ft, self.Dft
+
+    def batch(self, X):
+        while len(self.fb) < len(X):
+            self.fb.append(matrix(0.0, (self.m, 1)))
+            self.Dfb.append(matrix(0.0, (self.m, self.n)))
+        indom = misc_solvers.nlfunction_batch(self.capsule, X, self.fb,
+            self.Dfb, nthreads = self.threads)
+        return [ (self.fb[i], self.Dfb[i]) if indom[i] else None for i in
+            range(len(X)) ]
+
+
+def nlfunction(F, objective = False, threads = 1):
+    """
+    Returns NLFunction(F, objective, threads) if F is a PyCapsule, and F
+    otherwise.
+    """
+
+    if type(F).__name__ == 'PyCapsule':
+        return NLFunction(F, objective, threads)
+    return F
+
+
+def parallel_map(f, X, threads):
+    """
+    Returns [ f(x) for x in X ], with the calls divided over at most
+    threads threads.  f must be thread-safe if threads is greater than
+    one.  An exception raised by f is raised again after all threads
+    have finished.
+    """
+
+    if threads <= 1 or len(X) <= 1:
+        return [ f(x) for x in X ]
+    res, err = [ None ] * len(X), []
+    def work(i):
+        for j in range(i, len(X), threads):
+            try: res[j] = f(X[j])
+            except Exception as e: err.append(e)
+    workers = [ threading.Thread(target = work, args = (i,)) for i in
+        range(1, min(threads, len(X))) ]
+    for t in workers: t.start()
+    work(0)
+    for t in workers: t.join()
+    if err: raise err[0]
+    return res
+
+
+# Messages printed by the solvers when they terminate with the status
+# 'unknown' after the maximum number of iterations, or with a status
+# returned by Deadline.check().
+terminated = {
+    'unknown': "Terminated (maximum number of iterations reached).",
+    'time limit': "Terminated (time limit reached).",
+    'cancelled': "Terminated (cancelled)." }
+
+
+def sfactor(K, F, ipiv = None, n = None, offsetA = 0):
+    """
+    Mixed precision factorization of a symmetric matrix.
+
+    Factors the n x n matrix stored in the lower triangle of K (at offset
+    offsetA, with leading dimension K.size[0]) in single precision, 
+    using an LDL^T factorization if ipiv is given and a Cholesky 
+    factorization otherwise, and returns a function solve(x, offsetx = 0)
+    that overwrites x with the solution of K*u = x.  The solution is 
+    refined in double precision against the original matrix K, which is 
+    not modified.
+
+    If the single precision factorization fails, the right-hand side 
+    cannot be rounded to single precision, or the refinement does not 
+    converge, K is factored in double precision in place and 
+    F['single'] is set to False, so that later calls with the same F
+    use double precision directly.
+    """
+
+    if n is None: n = K.size[0]
+    b = matrix(0.0, (n,1))
+    r = matrix(0.0, (n,1))
+    Fs = None
+
+    def dfactor():
+        F['single'] = False
+        if ipiv is None: lapack.potrf(K, n = n, offsetA = offsetA)
+        else: lapack.sytrf(K, ipiv, n = n)
+
+    def dsolve(x, offsetx):
+        if ipiv is None: 
+            lapack.potrs(K, x, n = n, offsetA = offsetA, offsetB = offsetx)
+        else: 
+            lapack.sytrs(K, ipiv, x, n = n, offsetA = offsetA, offsetB = 
+                offsetx)
+
+    if F.get('single', True):
+        try:
+            if ipiv is None: Fs = lapack.spotrf(K, n = n, offsetA = offsetA)
+            else: Fs = lapack.ssytrf(K, n = n, offsetA = offsetA)
+        except (ArithmeticError, OverflowError): 
+            pass
+    if Fs is None: 
+        dfactor()
+    else:
+        # Stopping criterion of LAPACK dsposv, in the 2-norm and with the 
+        # largest norm of the columns of the lower triangle of K as 
+        # estimate of the norm of K.
+        anrm = max([ blas.nrm2(K, n = n-j, offset = offsetA + 
+            j*(K.size[0]+1)) for j in range(n) ] + [0.0])
+        tol = anrm * 2.0**-53 * math.sqrt(n)
+        if ipiv is None: ssolve = lapack.spotrs
+        else: ssolve = lapack.ssytrs
+
+    def solve(x, offsetx = 0):
+
+        if not n: return
+        if Fs is None or not F['single']: 
+            dsolve(x, offsetx)
+            return
+
+        blas.copy(x, b, offsetx = offsetx, n = n)
+        try:
+            ssolve(Fs, x, offsetB = offsetx)
+            rprev = None
+            for i in range(30):
+
+                # r := b - K*x 
+                blas.copy(b, r)
+                blas.symv(K, x, r, alpha = -1.0, beta = 1.0, n = n, 
+                    offsetA = offsetA, offsetx = offsetx)
+                rnrm = blas.nrm2(r)
+                if rnrm <= blas.nrm2(x, n = n, offset = offsetx) * tol: 
+                    return
+                if rprev is not None and rnrm > 0.5 * rprev: break
+                rprev = rnrm
+
+                # x := x + K^{-1} * r 
+                ssolve(Fs, r)
+                blas.axpy(r, x, n = n, offsety = offsetx)
+
+        # The right-hand side or a residual cannot be rounded to single
+        # precision.
+        except OverflowError:
+            pass
+
+        # Refinement stalled.  Switch to double precision.
+        dfactor()
+        blas.copy(b, x, n = n, offsety = offsetx)
+        dsolve(x, offsetx)
+
+    return solve
+
+
+def kkt_ldl(G, dims, A, mnl = 0, kktreg = None, single = False):
     """
     Solution of KKT equations by a dense LDL factorization of the 
     3 x 3 system.
@@ -1072,6 +1873,9 @@ def kkt_ldl(G, dims, A, mnl = 0, kktreg = None):
     
     H is n x n,  A is p x n, Df is mnl x n, G is N x n where
     N = dims['l'] + sum(dims['q']) + sum( k**2 for k in dims['s'] ).
+
+    If single is True, the factorization is computed in single precision
+    and the solutions are refined in double precision (see sfactor()).
     """
     
     p, n = A.size
@@ -1081,6 +1885,7 @@ def kkt_ldl(G, dims, A, mnl = 0, kktreg = None):
     ipiv = matrix(0, (ldK, 1))
     u = matrix(0.0, (ldK, 1))
     g = matrix(0.0, (mnl + G.size[0], 1))
+    F = {'single': single}
 
     def factor(W, H = None, Df = None):
 
@@ -1096,7 +1901,8 @@ def kkt_ldl(G, dims, A, mnl = 0, kktreg = None):
         if kktreg:
             K[0 : (ldK+1)*n : ldK+1]  += kktreg  # Reg. term, 1x1 block (positive)
             K[(ldK+1)*n :: ldK+1]  -= kktreg     # Reg. term, 2x2 block (negative)
-        lapack.sytrf(K, ipiv)
+        if single: Ksolve = sfactor(K, F, ipiv)
+        else: lapack.sytrf(K, ipiv)
 
         def solve(x, y, z):
 
@@ -1115,7 +1921,8 @@ def kkt_ldl(G, dims, A, mnl = 0, kktreg = None):
             blas.copy(y, u, offsety = n)
             scale(z, W, trans = 'T', inverse = 'I') 
             pack(z, u, dims, mnl, offsety = n + p)
-            lapack.sytrs(K, ipiv, u)
+            if single: Ksolve(u)
+            else: lapack.sytrs(K, ipiv, u)
             blas.copy(u, x, n = n)
             blas.copy(u, y, offsetx = n, n = p)
             unpack(u, z, dims, mnl, offsetx = n + p)
@@ -1125,7 +1932,7 @@ def kkt_ldl(G, dims, A, mnl = 0, kktreg = None):
     return factor
 
 
-def kkt_ldl2(G, dims, A, mnl = 0):
+def kkt_ldl2(G, dims, A, mnl = 0, single = False):
     """
     Solution of KKT equations by a dense LDL factorization of the 2 x 2 
     system.
@@ -1145,6 +1952,9 @@ def kkt_ldl2(G, dims, A, mnl = 0):
     
     H is n x n,  A is p x n, Df is mnl x n, G is N x n where
     N = dims['l'] + sum(dims['q']) + sum( k**2 for k in dims['s'] ).
+
+    If single is True, the factorization is computed in single precision
+    and the solutions are refined in double precision (see sfactor()).
     """
 
     p, n = A.size
@@ -1153,6 +1963,7 @@ def kkt_ldl2(G, dims, A, mnl = 0):
     if p: ipiv = matrix(0, (ldK, 1))
     g = matrix(0.0, (mnl + G.size[0], 1))
     u = matrix(0.0, (ldK, 1))
+    F = {'single': single}
 
     def factor(W, H = None, Df = None):
 
@@ -1169,7 +1980,8 @@ def kkt_ldl2(G, dims, A, mnl = 0):
             sgemv(G, g, K, dims, trans = 'T', beta = 1.0, n = n-k,
                 offsetA = G.size[0]*k, offsetx = mnl, offsety = 
                 (ldK + 1)*k)
-        if p: lapack.sytrf(K, ipiv)
+        if single: Ksolve = sfactor(K, F, ipiv if p else None)
+        elif p: lapack.sytrf(K, ipiv)
         else: lapack.potrf(K)
 
         def solve(x, y, z):
@@ -1197,7 +2009,8 @@ def kkt_ldl2(G, dims, A, mnl = 0):
             sgemv(G, g, u, dims, trans = 'T', offsetx = mnl, beta = beta)
             blas.axpy(x, u)
             blas.copy(y, u, offsety = n)
-            if p: lapack.sytrs(K, ipiv, u)
+            if single: Ksolve(u)
+            elif p: lapack.sytrs(K, ipiv, u)
             else: lapack.potrs(K, u)
             blas.copy(u, x, n = n)
             blas.copy(u, y, offsetx = n, n = p)
@@ -1210,7 +2023,7 @@ def kkt_ldl2(G, dims, A, mnl = 0):
     return factor
 
 
-def kkt_chol(G, dims, A, mnl = 0):
+def kkt_chol(G, dims, A, mnl = 0, single = False):
     """
     Solution of KKT equations by reduction to a 2 x 2 system, a QR 
     factorization to eliminate the equality constraints, and a dense 
@@ -1233,6 +2046,17 @@ def kkt_chol(G, dims, A, mnl = 0):
     
     H is n x n,  A is p x n, Df is mnl x n, G is N x n where
     N = dims['l'] + sum(dims['q']) + sum( k**2 for k in dims['s'] ).
+
+    If single is True, the Cholesky factorization is computed in single 
+    precision and the solutions are refined in double precision (see 
+    sfactor()).
+
+    If G is a sparse matrix with 's' blocks, W^{-T} * G is only formed 
+    for the nonlinear, 'l' and 'q' rows.  The contribution of the 's' 
+    blocks to K is computed by schur() from the nonzeros of G, and G is
+    applied by sgemv() in the solve step.  The same holds if G is a 
+    LowRank matrix (with mnl = 0), for which the 's' blocks of K are 
+    computed by G.schur() and G is applied by G().
     """
 
     p, n = A.size
@@ -1249,10 +2073,21 @@ def kkt_chol(G, dims, A, mnl = 0):
     tauA = matrix(0.0, (p,1))
     lapack.geqrf(QA, tauA)
 
-    Gs = matrix(0.0, (cdim, n))
+    lowrank = isinstance(G, LowRank)
+    sparseG = lowrank or (type(G) is spmatrix and len(dims['s']) > 0)
+    if sparseG:
+        mlq = mnl + dims['l'] + sum(dims['q'])
+        if lowrank and (mnl or G.ms != list(dims['s'])):
+            raise ValueError("incompatible dimensions of G and dims")
+        Glq = matrix(G.Gl) if lowrank else matrix(G[:mlq-mnl, :])
+        Gs = matrix(0.0, (mlq, n))
+        u = matrix(0.0, (cdim, 1))
+    else:
+        Gs = matrix(0.0, (cdim, n))
     K = matrix(0.0, (n,n)) 
     bzp = matrix(0.0, (cdim_pckd, 1))
     yy = matrix(0.0, (p,1))
+    F = {'single': single}
 
     def factor(W, H = None, Df = None):
 
@@ -1264,22 +2099,41 @@ def kkt_chol(G, dims, A, mnl = 0):
         #
         #     Q_2' * (H + GG^T * W^{-1} * W^{-T} * GG) * Q2.
 
-        # Gs = W^{-T} * GG in packed storage.
-        if mnl: 
-            Gs[:mnl, :] = Df
-        Gs[mnl:, :] = G
-        scale(Gs, W, trans = 'T', inverse = 'I')
-        pack2(Gs, dims, mnl)
+        if sparseG:
+
+            # Gs = W^{-T} * GG for the nonlinear, 'l' and 'q' rows, and 
+            # K = Gs' * Gs + (the 's' blocks of GG' * W^{-1} * W^{-T} * GG).
+            if mnl: 
+                Gs[:mnl, :] = Df
+            Gs[mnl:, :] = Glq
+            Wlq = dict([ (key, W[key]) for key in W if key not in ('r', 
+                'rti') ], r = [], rti = [])
+            scale(Gs, Wlq, trans = 'T', inverse = 'I')
+            blas.syrk(Gs, K, k = mlq, trans = 'T')
+            if lowrank: G.schur(W, K)
+            else: schur(G, W, K, dims)
+
+        else:
+
+            # Gs = W^{-T} * GG in packed storage.
+            if mnl: 
+                Gs[:mnl, :] = Df
+            Gs[mnl:, :] = G
+            scale(Gs, W, trans = 'T', inverse = 'I')
+            pack2(Gs, dims, mnl)
+
+            # K = Gs' * Gs.
+            blas.syrk(Gs, K, k = cdim_pckd, trans = 'T')
 
-        # K = [Q1, Q2]' * (H + Gs' * Gs) * [Q1, Q2].
-        blas.syrk(Gs, K, k = cdim_pckd, trans = 'T')
+        # K = [Q1, Q2]' * (H + K) * [Q1, Q2].
         if H is not None: K[:,:] += H
         symm(K, n)
         lapack.ormqr(QA, tauA, K, side = 'L', trans = 'T')
         lapack.ormqr(QA, tauA, K, side = 'R')
 
         # Cholesky factorization of 2,2 block of K.
-        lapack.potrf(K, n = n-p, offsetA = p*(n+1))
+        if single: Ksolve = sfactor(K, F, n = n-p, offsetA = p*(n+1))
+        else: lapack.potrf(K, n = n-p, offsetA = p*(n+1))
 
         def solve(x, y, z):
 
@@ -1302,13 +2156,33 @@ def kkt_chol(G, dims, A, mnl = 0):
             # 
             #     W*uz = W^{-T} * ( GG*ux - bz ).
 
-            # bzp := W^{-T} * bz in packed storage 
-            scale(z, W, trans = 'T', inverse = 'I')
-            pack(z, bzp, dims, mnl)
+            if sparseG:
+
+                # z := W^{-T} * bz,  u := W^{-1} * W^{-T} * bz
+                scale(z, W, trans = 'T', inverse = 'I')
+                blas.copy(z, u)
+                scale(u, W, inverse = 'I')
+
+                # x := x + GG' * u
+                #    = bx + GG' * W^{-1} * W^{-T} * bz
+                if lowrank: G(u, x, trans = 'T', beta = 1.0)
+                else:
+                    if mnl: base.gemv(Df, u, x, beta = 1.0, trans = 'T')
+                    sgemv(G, u, x, dims, trans = 'T', beta = 1.0, offsetx
+                        = mnl)
+
+            else:
 
-            # x := [Q1, Q2]' * (x + Gs' * bzp)
-            #    = [Q1, Q2]' * (bx + Gs' * W^{-T} * bz)
-            blas.gemv(Gs, bzp, x, beta = 1.0, trans = 'T', m = cdim_pckd)
+                # bzp := W^{-T} * bz in packed storage 
+                scale(z, W, trans = 'T', inverse = 'I')
+                pack(z, bzp, dims, mnl)
+
+                # x := x + Gs' * bzp
+                #    = bx + Gs' * W^{-T} * bz
+                blas.gemv(Gs, bzp, x, beta = 1.0, trans = 'T', m = 
+                    cdim_pckd)
+
+            # x := [Q1, Q2]' * x
             lapack.ormqr(QA, tauA, x, side = 'L', trans = 'T')
 
             # y := x[:p] 
@@ -1324,7 +2198,9 @@ def kkt_chol(G, dims, A, mnl = 0):
             #        = K22^{-1} * (Q2' * (bx + Gs' * W^{-T} * bz) - K21*v)
             blas.gemv(K, x, x, alpha = -1.0, beta = 1.0, m = n-p, n = p,
                 offsetA = p, offsety = p)
-            lapack.potrs(K, x, n = n-p, offsetA = p*(n+1), offsetB = p)
+            if single: Ksolve(x, offsetx = p)
+            else: lapack.potrs(K, x, n = n-p, offsetA = p*(n+1), 
+                offsetB = p)
 
             # y := y - [K11, K12] * x
             #    = Q1' * (bx + Gs' * W^{-T} * bz) - K11*v - K12*w
@@ -1338,11 +2214,26 @@ def kkt_chol(G, dims, A, mnl = 0):
             # x := [Q1, Q2] * x
             lapack.ormqr(QA, tauA, x, side = 'L')
 
-            # bzp := Gs * x - bzp.
-            #      = W^{-T} * ( GG*ux - bz ) in packed storage.
-            # Unpack and copy to z.
-            blas.gemv(Gs, x, bzp, alpha = 1.0, beta = -1.0, m = cdim_pckd)
-            unpack(bzp, z, dims, mnl)
+            if sparseG:
+
+                # z := W^{-T} * GG * ux - z
+                #    = W^{-T} * ( GG*ux - bz )
+                if lowrank: G(x, u)
+                else:
+                    if mnl: base.gemv(Df, x, u)
+                    sgemv(G, x, u, dims, offsety = mnl)
+                scale(u, W, trans = 'T', inverse = 'I')
+                blas.axpy(z, u, alpha = -1.0)
+                blas.copy(u, z)
+
+            else:
+
+                # bzp := Gs * x - bzp.
+                #      = W^{-T} * ( GG*ux - bz ) in packed storage.
+                # Unpack and copy to z.
+                blas.gemv(Gs, x, bzp, alpha = 1.0, beta = -1.0, m = 
+                    cdim_pckd)
+                unpack(bzp, z, dims, mnl)
 
         return solve
 
@@ -1428,7 +2319,7 @@ def kkt_chol2(G, dims, A, mnl = 0):
                 if type(F['S']) is matrix: 
                     lapack.potrf(F['S']) 
                 else:
-                    F['Sf'] = cholmod.symbolic(F['S'])
+                    F['Sf'] = cache.symbolic(F['S'])
                     cholmod.numeric(F['S'], F['Sf'])
             except ArithmeticError:
                 F['singular'] = True 
@@ -1443,7 +2334,7 @@ def kkt_chol2(G, dims, A, mnl = 0):
                 if type(F['S']) is matrix: 
                     lapack.potrf(F['S']) 
                 else:
-                    F['Sf'] = cholmod.symbolic(F['S'])
+                    F['Sf'] = cache.symbolic(F['S'])
                     cholmod.numeric(F['S'], F['Sf'])
             F['firstcall'] = False
 
@@ -1483,7 +2374,7 @@ def kkt_chol2(G, dims, A, mnl = 0):
                 Asct = cholmod.spsolve(F['Sf'], A.T, sys = 7)
                 Asct = cholmod.spsolve(F['Sf'], Asct, sys = 4)
                 base.syrk(Asct, F['K'], trans = 'T')
-                Kf = cholmod.symbolic(F['K'])
+                Kf = cache.symbolic(F['K'])
                 cholmod.numeric(F['K'], Kf)
 
         def solve(x, y, z):
@@ -0,0 +1,494 @@
+"""
+Presolve and postsolve for linear and quadratic programs.
+
+presolve:   removes redundant constraints and fixed variables.
+postsolve:  maps a solution of the reduced problem to the original
+            problem.
+options:    dictionary with the tolerances used by presolve.
+
+The problems have the form
+
+    minimize    (1/2)*x'*P*x + c'*x
+    subject to  G*x <= h
+                A*x = b
+
+with P = None for an LP.  presolve() applies the following reductions
+until none of them applies:
+
+- removal of empty rows of G and A,
+- removal of inequalities that are dominated by other bounds on the same
+  variable, and of duplicate inequalities,
+- elimination of variables fixed by an equality with one nonzero, or by
+  equal upper and lower bounds,
+- elimination of variables that do not appear in the constraints,
+- removal of linearly dependent equalities.
+
+Reductions that would reveal infeasibility or unboundedness are not
+applied, so that these problems are detected by the interior-point
+solver.  The exceptions are inconsistent equalities (an empty row of A
+with a nonzero right-hand side, or a linear combination of other rows
+with a different right-hand side), which the solver can not handle
+because A does not have full rank.  presolve() then stops and sets
+R['status'] to 'primal infeasible', and postsolve() returns a
+certificate of primal infeasibility.
+"""
+
+# Copyright 2012-2020 M. Andersen and L. Vandenberghe.
+# Copyright 2010-2011 L. Vandenberghe.
+# Copyright 2004-2009 J. Dahl and L. Vandenberghe.
+#
+# This file is part of CVXOPT.
+#
+# CVXOPT is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# CVXOPT is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import random
+from cvxopt import blas, lapack, misc
+from cvxopt.base import matrix, spmatrix, sparse
+
+options = {'feastol': 1e-9, 'ranktol': 1e-9}
+
+__all__ = ['presolve', 'postsolve', 'options']
+
+
+def _ccs(M, m, n):
+    """
+    Returns the nonzero entries of the m by n matrix M, and of its
+    transpose, in compressed column storage, as tuples (ptr, ind, val)
+    with ptr a list.  M can be None, dense or sparse.
+    """
+
+    if M is None or not m or not n:
+        return ([0] * (n+1), [], []), ([0] * (m+1), [], [])
+    M = sparse(M)
+    Mc, Mr = M.CCS, M.T.CCS
+    return (list(Mc[0]), Mc[1], Mc[2]), (list(Mr[0]), Mr[1], Mr[2])
+
+
+def _entries(S, k):
+    """
+    Returns the indices and values of the nonzeros in column k of a
+    matrix S returned by _ccs().
+    """
+
+    ptr, ind, val = S
+    return zip(ind[ptr[k] : ptr[k+1]], val[ptr[k] : ptr[k+1]])
+
+
+def presolve(c, G, h, A = None, b = None, P = None):
+    """
+    Reduces a linear or quadratic program.
+
+    R = presolve(c, G, h, A = None, b = None, P = None)
+
+    PURPOSE
+    Removes redundant rows and columns from the LP or QP
+
+        minimize    (1/2)*x'*P*x + c'*x
+        subject to  G*x <= h
+                    A*x = b.
+
+    Returns a dictionary R with the data of the reduced problem in
+    R['c'], R['G'], R['h'], R['A'], R['b'], R['P'] (None if P is None),
+    the number of removed constraints and variables in R['rows removed']
+    and R['columns removed'], and the information needed by postsolve().
+    The objective of the reduced problem differs from the original
+    objective by the constant R['constant'].  R['status'] is None, or
+    'primal infeasible' if the equality constraints are inconsistent.
+
+    ARGUMENTS
+    c         'd' matrix of size (n,1)
+
+    G         dense or sparse 'd' matrix of size (m,n), or None
+
+    h         'd' matrix of size (m,1), or None
+
+    A         dense or sparse 'd' matrix of size (p,n), or None
+
+    b         'd' matrix of size (p,1), or None
+
+    P         dense or sparse 'd' matrix of size (n,n), or None.  Only
+              the lower triangular part of P is referenced.
+    """
+
+    feastol = options.get('feastol', 1e-9)
+    ranktol = options.get('ranktol', 1e-9)
+
+    n = c.size[0]
+    m = G.size[0] if G is not None else 0
+    p = A.size[0] if A is not None else 0
+    Gcols, Grows = _ccs(G, m, n)
+    Acols, Arows = _ccs(A, p, n)
+
+    # Pcols contains the nonzeros in the columns of the symmetric matrix.
+    if type(P) is matrix:
+        Ps = matrix(P)
+        misc.symm(Ps, n)
+        Pcols = _ccs(Ps, n, n)[0]
+    elif P is not None:
+        Ps = sparse(P)
+        I, J, V = [], [], []
+        for v, i, j in zip(Ps.V, Ps.I, Ps.J):
+            if i > j:
+                I += [i, j]
+                J += [j, i]
+                V += [v, v]
+            elif i == j:
+                I.append(i)
+                J.append(j)
+                V.append(v)
+        Pcols = _ccs(spmatrix(V, I, J, (n,n)), n, n)[0]
+    else:
+        Pcols = _ccs(None, n, n)[0]
+
+    q = list(c)
+    hh = list(h) if m else []
+    bb = list(b) if p else []
+    btol = feastol * max([1.0] + [ abs(v) for v in bb ])
+    actG, actA, actx = set(range(m)), set(range(p)), set(range(n))
+    xfix, constant, steps = {}, 0.0, []
+
+    # The number of nonzeros of the rows in the remaining columns, and of
+    # the columns in the remaining rows.
+    rowsG = [ Grows[0][i+1] - Grows[0][i] for i in range(m) ]
+    rowsA = [ Arows[0][i+1] - Arows[0][i] for i in range(p) ]
+    colsG = [ Gcols[0][j+1] - Gcols[0][j] for j in range(n) ]
+    colsA = [ Acols[0][j+1] - Acols[0][j] for j in range(n) ]
+
+    # Random vectors for grouping the inequalities in the search for
+    # duplicates.
+    rng = random.Random(n)
+    rnd = [ [ rng.uniform(1.0, 2.0) for j in range(n) ] for k in range(2) ]
+
+    def fix(j, xj):
+        # Substitutes x_j = xj in the objective and the constraints.
+        actx.discard(j)
+        xfix[j] = xj
+        for i, v in _entries(Gcols, j):
+            rowsG[i] -= 1
+            if i in actG: hh[i] -= v * xj
+        for i, v in _entries(Acols, j):
+            rowsA[i] -= 1
+            if i in actA: bb[i] -= v * xj
+        pjj = 0.0
+        for k, v in _entries(Pcols, j):
+            if k == j: pjj = v
+            elif k in actx: q[k] += v * xj
+        return q[j] * xj + 0.5 * pjj * xj**2
+
+    def dropG(i):
+        actG.discard(i)
+        for j, v in _entries(Grows, i): colsG[j] -= 1
+
+    def dropA(i):
+        actA.discard(i)
+        for j, v in _entries(Arows, i): colsA[j] -= 1
+
+    # certificate is set to a dictionary {i: y_i} if the equalities are
+    # inconsistent.  The y_i are the multipliers of the remaining
+    # equalities in a certificate of primal infeasibility.
+    certificate = None
+    changed = True
+    while changed and certificate is None:
+        changed = False
+
+        # Equalities with zero or one nonzero.
+        for i in sorted(actA):
+            if rowsA[i] > 1: continue
+            row = [ (j, v) for j, v in _entries(Arows, i) if j in actx ]
+            if not row:
+                if abs(bb[i]) > btol:
+                    certificate = {i: -1.0 if bb[i] > 0.0 else 1.0}
+                    break
+                dropA(i)
+                steps.append(('y', i))
+                changed = True
+            elif len(actx) > 1:
+                j, v = row[0]
+                dropA(i)
+                constant += fix(j, bb[i] / v)
+                steps.append(('fixed by equality', j, i, v))
+                changed = True
+        if certificate is not None: break
+
+        # Inequalities with zero or one nonzero.  bounds[j] has the
+        # tightest upper and lower bounds on x_j, as tuples (bound, row,
+        # coefficient).
+        bounds = {}
+        for i in sorted(actG):
+            if rowsG[i] > 1: continue
+            row = [ (j, v) for j, v in _entries(Grows, i) if j in actx ]
+            if not row:
+                if hh[i] >= -feastol:
+                    dropG(i)
+                    steps.append(('z', i))
+                    changed = True
+                continue
+            j, v = row[0]
+            key = 'u' if v > 0 else 'l'
+            bnd = (hh[i] / v, i, v)
+            old = bounds.setdefault(j, {}).get(key)
+            if old is None:
+                bounds[j][key] = bnd
+                continue
+            if (key == 'u' and bnd[0] < old[0]) or (key == 'l' and
+                bnd[0] > old[0]):
+                bounds[j][key], bnd = bnd, old
+            dropG(bnd[1])
+            steps.append(('z', bnd[1]))
+            changed = True
+
+        # Variables with equal upper and lower bounds.
+        for j, bnd in bounds.items():
+            if 'u' not in bnd or 'l' not in bnd or len(actx) == 1: continue
+            (u, iu, gu), (l, il, gl) = bnd['u'], bnd['l']
+            if abs(u - l) <= feastol * max(1.0, abs(u)):
+                dropG(iu)
+                dropG(il)
+                constant += fix(j, 0.5 * (u + l))
+                steps.append(('fixed by bounds', j, iu, gu, il, gl))
+                changed = True
+
+        # Variables that do not appear in the constraints and are not
+        # coupled to other variables in the objective.
+        for j in sorted(actx):
+            if len(actx) == 1: break
+            if colsG[j] or colsA[j] or [ k for k, v in _entries(Pcols, j)
+                if k in actx and k != j ]:
+                continue
+            pjj = dict(_entries(Pcols, j)).get(j, 0.0)
+            if pjj > 0.0:
+                constant += fix(j, -q[j] / pjj)
+            elif abs(q[j]) <= feastol:
+                constant += fix(j, 0.0)
+            else:
+                continue
+            steps.append(('x', j))
+            changed = True
+
+        if changed: continue
+
+        # Duplicate inequalities.  Rows that are positive multiples of
+        # each other have the same normalized products with two random
+        # vectors.  The rows with equal products are grouped by their
+        # normalized nonzeros.
+        groups = {}
+        if len(actG) > 1:
+            W = G * matrix([ [ r[j] if j in actx else 0.0 for j in
+                range(n) ] for r in rnd ])
+            for i in sorted(actG):
+                if rowsG[i] < 2: continue
+                scale = max(abs(W[i,0]), abs(W[i,1]))
+                if scale == 0.0: continue
+                key = (rowsG[i], round(W[i,0] / scale, 9), round(W[i,1] /
+                    scale, 9))
+                groups.setdefault(key, []).append(i)
+        for group in groups.values():
+            if len(group) == 1: continue
+            rows = {}
+            for i in group:
+                row = [ (j, v) for j, v in _entries(Grows, i) if j in
+                    actx ]
+                scale = max([ abs(v) for j, v in row ])
+                key = tuple([ (j, round(v / scale, 12)) for j, v in row ])
+                if key in rows:
+                    k, sk = rows[key]
+                    if hh[i] / scale < hh[k] / sk:
+                        rows[key] = (i, scale)
+                        i = k
+                    dropG(i)
+                    steps.append(('z', i))
+                    changed = True
+                else:
+                    rows[key] = (i, scale)
+
+        # Linearly dependent equalities, from a QR factorization with
+        # column pivoting of A'.
+        ar, xr = sorted(actA), sorted(actx)
+        if len(ar) > 1:
+            At = matrix(A[ar, xr].T)
+            jpvt, tau = matrix(0, (len(ar), 1)), matrix(0.0, (min(At.size),
+                1))
+            lapack.geqp3(At, jpvt, tau)
+            r = 0
+            while r < min(At.size) and abs(At[r, r]) > ranktol * \
+                abs(At[0, 0]):
+                r += 1
+            if 0 < r < len(ar):
+                # The dependent columns of A'[:, jpvt-1] satisfy
+                # A'[:, dep] = A'[:, ind] * L with L = R11^-1 * R12.
+                L = At[:r, r:]
+                lapack.trtrs(At[:r, :r], L, uplo = 'U')
+                ind = [ ar[jpvt[k] - 1] for k in range(r) ]
+                bi = matrix([ bb[i] for i in ind ])
+                for k in range(r, len(ar)):
+                    i = ar[jpvt[k] - 1]
+                    res = bb[i] - blas.dot(L[:, k - r], bi)
+                    if abs(res) <= btol:
+                        dropA(i)
+                        steps.append(('y', i))
+                        changed = True
+                    else:
+                        # y_i = -sign(res) and y_ind = sign(res) * L[:,k-r]
+                        # give A'*y = 0 and b'*y = -|res|.
+                        sgn = 1.0 if res > 0.0 else -1.0
+                        certificate = dict([ (ind[t], sgn * L[t, k - r])
+                            for t in range(r) ])
+                        certificate[i] = -sgn
+                        break
+
+    Gr, Ar, xr = sorted(actG), sorted(actA), sorted(actx)
+    R = {'c': matrix([ q[j] for j in xr ], tc = 'd'),
+        'h': matrix([ hh[i] for i in Gr ], tc = 'd'),
+        'b': matrix([ bb[i] for i in Ar ], tc = 'd'),
+        'status': None if certificate is None else 'primal infeasible',
+        'rows removed': m - len(Gr) + p - len(Ar),
+        'columns removed': n - len(xr),
+        'constant': constant,
+        'steps': steps, 'fixed': xfix, 'rows G': Gr, 'rows A': Ar,
+        'columns': xr, 'certificate': certificate,
+        'data': (c, G, h, A, b, P)}
+    if G is None:
+        R['G'] = spmatrix([], [], [], (0, len(xr)), 'd')
+    elif len(Gr) == m and len(xr) == n:
+        R['G'] = G
+    else:
+        R['G'] = G[Gr, xr]
+    if A is None:
+        R['A'] = spmatrix([], [], [], (0, len(xr)), 'd')
+    elif len(Ar) == p and len(xr) == n:
+        R['A'] = A
+    else:
+        R['A'] = A[Ar, xr]
+    if P is None or len(xr) == n:
+        R['P'] = P
+    else:
+        R['P'] = P[xr, xr]
+    return R
+
+
+def _multipliers(R, x, y, z):
+    """
+    Computes in place the multipliers in y and z of the constraints that
+    fix a variable, from the dual equality for that variable,
+
+        c + P*x + G'*z + A'*y = 0,
+
+    or G'*z + A'*y = 0 if x is None.  The steps of presolve() are
+    processed in reverse order.
+    """
+
+    c, G, h, A, b, P = R['data']
+    n = c.size[0]
+    m = G.size[0] if G is not None else 0
+    p = A.size[0] if A is not None else 0
+
+    def reduced_cost(j):
+        # Returns (c + P*x + G'*z + A'*y)_j.
+        r = 0.0
+        if x is not None:
+            r += c[j]
+            if P is not None:
+                r += sum([ P[max(j,k), min(j,k)] * x[k] for k in
+                    range(n) ])
+        if m: r += (G[:, j].T * z)[0]
+        if p: r += (A[:, j].T * y)[0]
+        return r
+
+    for step in reversed(R['steps']):
+        if step[0] == 'fixed by equality':
+            j, i, v = step[1:]
+            y[i] = -reduced_cost(j) / v
+        elif step[0] == 'fixed by bounds':
+            j, iu, gu, il, gl = step[1:]
+            r = reduced_cost(j)
+            if r <= 0.0: z[iu] = -r / gu
+            else: z[il] = -r / gl
+
+
+def postsolve(R, sol = None):
+    """
+    Maps a solution of the reduced problem to the original problem.
+
+    sol = postsolve(R, sol = None)
+
+    PURPOSE
+    R is the dictionary returned by presolve() and sol is a solution
+    dictionary with status 'optimal', 'time limit' or 'cancelled'
+    returned by conelp() or coneqp() for the reduced problem.  Returns
+    a copy of sol in which 'x', 's', 'y', 'z' are mapped to a primal
+    and dual point of the original problem (a solution if the status
+    is 'optimal'), the primal and dual objectives include
+    R['constant'], and the primal and dual slacks are those of the
+    original problem.  The key 'presolve' is added with a dictionary
+    with the number of removed rows and columns.
+
+    If R['status'] is 'primal infeasible', sol is not used, and the
+    dictionary returned has status 'primal infeasible' and a certificate
+    of primal infeasibility in 'y' and 'z', as returned by conelp().
+    """
+
+    c, G, h, A, b, P = R['data']
+    n = c.size[0]
+    m = G.size[0] if G is not None else 0
+    p = A.size[0] if A is not None else 0
+    z = matrix(0.0, (m,1))
+    y = matrix(0.0, (p,1))
+    presolve = {'rows removed': R['rows removed'], 'columns removed':
+        R['columns removed']}
+
+    if R['status'] == 'primal infeasible':
+        # G'*z + A'*y = 0, z >= 0, and h'*z + b'*y = -1.
+        for i, v in R['certificate'].items(): y[i] = v
+        _multipliers(R, None, y, z)
+        t = -(blas.dot(h, z) if m else 0.0) - blas.dot(b, y)
+        blas.scal(1.0 / t, y)
+        if m: blas.scal(1.0 / t, z)
+        res = A.T * y
+        if m: res += G.T * z
+        return {'x': None, 'y': y, 's': None, 'z': z,
+            'status': 'primal infeasible',
+            'gap': None,
+            'relative gap': None,
+            'primal objective': None,
+            'dual objective': 1.0,
+            'primal infeasibility': None,
+            'dual infeasibility': None,
+            'primal slack': None,
+            'dual slack': min(z) if m else 0.0,
+            'residual as primal infeasibility certificate':
+                blas.nrm2(res) / max(1.0, blas.nrm2(c)),
+            'residual as dual infeasibility certificate': None,
+            'iterations': 0,
+            'presolve': presolve}
+
+    x = matrix(0.0, (n,1))
+    x[R['columns']] = sol['x']
+    for j, v in R['fixed'].items(): x[j] = v
+    z[R['rows G']] = sol['z']
+    y[R['rows A']] = sol['y']
+
+    # The multipliers of the removed constraints are zero, except for the
+    # constraints that fix a variable.
+    _multipliers(R, x, y, z)
+
+    s = h - G * x if m else matrix(0.0, (0,1))
+
+    sol = dict(sol)
+    sol['x'], sol['s'], sol['y'], sol['z'] = x, s, y, z
+    for key in ['primal objective', 'dual objective']:
+        if sol.get(key) is not None: sol[key] += R['constant']
+    sol['primal slack'] = min(s) if m else 0.0
+    sol['dual slack'] = min(z) if m else 0.0
+    sol['presolve'] = presolve
+    return sol
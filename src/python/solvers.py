@@ -7,9 +7,15 @@ cp:       solves nonlinear convex problem.
 cpl:      solves nonlinear convex problems with linear objectives.
 gp:       solves geometric programs.
 lp:       solves linear programs.
+lp_batch: solves a list of linear programs.
 qp:       solves quadratic programs.
+qp_batch: solves a list of quadratic programs.
 sdp:      solves semidefinite programs.
 socp:     solves second-order cone programs.
+socp_batch: solves a list of second-order cone programs.
+Problem:  cone program with fixed constraint matrices for repeated
+          solves.
+CancelToken: thread-safe token for options['cancel'].
 options:  dictionary with customizable algorithm parameters.
 """
 
@@ -34,8 +40,11 @@ options:  dictionary with customizable algorithm parameters.
 
 import cvxopt
 from cvxopt.cvxprog import cp, cpl, gp 
-from cvxopt.coneprog import conelp, lp, sdp, socp, coneqp, qp
+from cvxopt.coneprog import conelp, lp, sdp, socp, coneqp, qp, Problem, \
+    lp_batch, qp_batch, socp_batch
+from cvxopt.misc import CancelToken
 options = {}
 cvxopt.cvxprog.options = options
 cvxopt.coneprog.options = options
-__all__ = ['conelp', 'coneqp', 'lp', 'socp', 'sdp', 'qp', 'cp', 'cpl', 'gp']
+__all__ = ['conelp', 'coneqp', 'lp', 'socp', 'sdp', 'qp', 'cp', 'cpl', 'gp',
+    'Problem', 'lp_batch', 'qp_batch', 'socp_batch', 'CancelToken']
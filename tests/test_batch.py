@@ -0,0 +1,76 @@
+import unittest
+from cvxopt import matrix, normal, uniform, setseed, solvers, coneprog
+
+class TestBatch(unittest.TestCase):
+
+    def setUp(self):
+        self.options = {'show_progress': False}
+        setseed(1)
+        self.qps = []
+        for k in range(8):
+            n, m = 5, 10
+            P = normal(n,n)
+            G = normal(m,n)
+            self.qps.append({'P': P*P.T, 'q': normal(n,1), 'G': G,
+                'h': G*uniform(n,1) + uniform(m,1)})
+
+    def test_qp(self):
+        ref = [ solvers.qp(options = self.options, **prob)
+            for prob in self.qps ]
+        for processes in [1, 3, 3]:
+            sols = solvers.qp_batch(self.qps, processes = processes,
+                options = self.options)
+            self.assertEqual(len(sols), len(self.qps))
+            for sol, r in zip(sols, ref):
+                self.assertEqual(sol['status'], 'optimal')
+                self.assertAlmostEqual(sol['primal objective'],
+                    r['primal objective'], places = 6)
+            if processes > 1: pool = coneprog._pool
+
+        # The pool of the first call is used by the second.
+        self.assertTrue(coneprog._pool is pool)
+        self.assertEqual(coneprog._pool_processes, 3)
+
+    def test_lp(self):
+        c = matrix([-4., -5.])
+        G = matrix([[2., 1., -1., 0.], [1., 2., 0., -1.]])
+        probs = [ (c, G, matrix([t, 3., 0., 0.])) for t in [3., 4., 5.] ]
+        sols = solvers.lp_batch(probs, processes = 2, options =
+            self.options)
+        for sol, t in zip(sols, [3., 4., 5.]):
+            ref = solvers.lp(c, G, matrix([t, 3., 0., 0.]), options =
+                self.options)
+            self.assertAlmostEqual(sol['primal objective'],
+                ref['primal objective'], places = 6)
+
+    def test_socp(self):
+        c = matrix([-2., 1., 5.])
+        G = [ matrix( [[12., 13., 12.], [6., -3., -12.], [-5., -5., 6.]] ),
+            matrix( [[3., 3., -1., 1.], [-6., -6., -9., 19.], [10., -2.,
+            -2., -3.]] ) ]
+        h = [ matrix( [-12., -3., -2.] ), matrix( [27., 0., 3., -42.] ) ]
+        sols = solvers.socp_batch([ {'c': c, 'Gq': G, 'hq': h} ]*2,
+            options = self.options)
+        self.assertEqual([ sol['status'] for sol in sols ], ['optimal']*2)
+
+    def test_errors(self):
+        with self.assertRaises(ValueError):
+            solvers.qp_batch(self.qps, processes = 0)
+        with self.assertRaises(TypeError):
+            solvers.qp_batch([ {'Q': None} ])
+        with self.assertRaises(TypeError):
+            solvers.qp_batch([ (None,)*11 ])
+
+        # An argument given by a problem and as a keyword argument.
+        c = matrix([-4., -5.])
+        G = matrix([[2., 1., -1., 0.], [1., 2., 0., -1.]])
+        h = matrix([3., 3., 0., 0.])
+        with self.assertRaises(ValueError):
+            solvers.lp_batch([ (c, G, h, None, None, None, 'native') ],
+                solver = 'native')
+        with self.assertRaises(ValueError):
+            solvers.qp_batch([ dict(self.qps[0], solver = 'native') ],
+                solver = 'native')
+
+if __name__ == '__main__':
+    unittest.main()
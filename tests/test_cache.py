@@ -0,0 +1,124 @@
+import unittest
+from cvxopt import matrix, spmatrix, normal, setseed
+
+class TestCache(unittest.TestCase):
+
+    def setUp(self):
+        from cvxopt import cache
+        cache.clear()
+
+    def test_cholmod(self):
+        from cvxopt import cache, cholmod
+        setseed(1)
+        n = 10
+        I = list(range(n)) + list(range(1,n))
+        J = list(range(n)) + list(range(n-1))
+        for k in range(3):
+            B = spmatrix(normal(2*n-1,1)/10 + 4.0, I, J)
+            F = cache.symbolic(B)
+            cholmod.numeric(B, F)
+            x = matrix(1.0, (n,1))
+            cholmod.solve(F, x)
+            F2 = cholmod.symbolic(B)
+            cholmod.numeric(B, F2)
+            y = matrix(1.0, (n,1))
+            cholmod.solve(F2, y)
+            self.assertTrue(max(abs(x-y)) < 1e-10)
+        info = cache.info()
+        self.assertEqual(info['misses'], 1)
+        self.assertEqual(info['hits'], 2)
+        cache.symbolic(spmatrix(1.0, range(n), range(n)))
+        self.assertEqual(cache.info()['misses'], 2)
+        self.assertEqual(cache.info()['size'], 2)
+
+    def test_maxsize(self):
+        from cvxopt import cache
+        maxsize = cache.options['maxsize']
+        try:
+            cache.options['maxsize'] = 1
+            for n in [2, 3, 2]:
+                cache.symbolic(spmatrix(1.0, range(n), range(n)))
+            self.assertEqual(cache.info()['misses'], 3)
+            self.assertEqual(cache.info()['size'], 1)
+            cache.options['maxsize'] = 0
+            cache.symbolic(spmatrix(1.0, range(2), range(2)))
+            self.assertEqual(cache.info()['size'], 1)
+        finally:
+            cache.options['maxsize'] = maxsize
+
+    def test_pickle(self):
+        import pickle
+        from cvxopt import base, cache, cholmod, umfpack
+        setseed(2)
+        n = 8
+        A = spmatrix(normal(n,1) + 10.0, range(n), range(n)) + \
+            spmatrix(1.0, range(1,n), range(n-1), (n,n))
+        b = normal(n,1)
+        roundtrip = lambda F: pickle.loads(pickle.dumps(cache.Factor(F))).F
+        Fs = roundtrip(umfpack.symbolic(A))
+        Fn = roundtrip(umfpack.numeric(A, Fs))
+        x = +b
+        umfpack.solve(A, Fn, x)
+        self.assertTrue(max(abs(A*x - b)) < 1e-10)
+        S = A*A.T
+        try:
+            for supernodal in [2, 0]:
+                cholmod.options['supernodal'] = supernodal
+                F = roundtrip(cholmod.symbolic(S))
+                cholmod.numeric(S, F)
+                F = roundtrip(F)
+                x = +b
+                cholmod.solve(F, x)
+                self.assertTrue(max(abs(S*x - b)) < 1e-10)
+        finally:
+            del cholmod.options['supernodal']
+
+        # Only factorizations are pickled, and other capsules are not.
+        self.assertRaises(TypeError, pickle.dumps, cache.Factor(A))
+        self.assertRaises(TypeError, pickle.dumps, base._C_API)
+
+    def test_load(self):
+        import os, struct, tempfile
+        from cvxopt import cholmod
+        n = 6
+        A = spmatrix(4.0, range(n), range(n)) + spmatrix(1.0, range(1,n),
+            range(n-1), (n,n))
+        F = cholmod.symbolic(A)
+        cholmod.numeric(A, F)
+        fd, filename = tempfile.mkstemp()
+        os.close(fd)
+        try:
+            cholmod.save(F, filename)
+            with open(filename, 'rb') as f: data = f.read()
+
+            # Truncated files and files with a corrupted size or 
+            # permutation are rejected.
+            w, h = struct.calcsize('n'), len("CVXOPT CHOLMOD 1")
+            p = h + 15*w + 1
+            for bad in [data[:-1], data + b'\0', data[:h + 2*w] + 
+                b'\xff' * w + data[h + 3*w:], data[:p] + b'\0' * (n*w)
+                + data[p + n*w:]]:
+                with open(filename, 'wb') as f: f.write(bad)
+                self.assertRaises(ValueError, cholmod.load, filename)
+        finally:
+            os.remove(filename)
+
+    def test_path(self):
+        import os, shutil, tempfile
+        from cvxopt import cache
+        path = tempfile.mkdtemp()
+        try:
+            cache.options['path'] = path
+            A = spmatrix(1.0, range(4), range(4))
+            cache.symbolic(A)
+            self.assertEqual(len(os.listdir(path)), 1)
+            cache.clear()
+            cache.symbolic(A)
+            self.assertEqual(cache.info()['misses'], 1)
+            self.assertEqual(len(os.listdir(path)), 1)
+        finally:
+            cache.options['path'] = None
+            shutil.rmtree(path)
+
+if __name__ == '__main__':
+    unittest.main()
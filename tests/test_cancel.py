@@ -0,0 +1,167 @@
+import unittest, threading
+from cvxopt import matrix, spdiag, normal, uniform, setseed, solvers, misc
+
+class TestCancel(unittest.TestCase):
+
+    def setUp(self):
+        self.options = {'show_progress': False}
+
+    def cancelling_kktsolver(self, G, token, count, P = None):
+        # Cancels the token after count factorizations.
+        dims = {'l': G.size[0], 'q': [], 's': []}
+        factor = misc.kkt_ldl(G, dims, matrix(0.0, (0, G.size[1])))
+        calls = [0]
+        def kktsolver(W):
+            calls[0] += 1
+            if calls[0] == count: token.cancel()
+            if P is None: return factor(W)
+            else: return factor(W, P)
+        return kktsolver
+
+    def test_time_limit(self):
+        setseed(1)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        P = normal(n,n)
+        options = dict(self.options, time_limit = 1e-9)
+        sol = solvers.lp(c, G, h, options = options)
+        self.assertEqual(sol['status'], 'time limit')
+        self.assertEqual(sol['iterations'], 0)
+        self.assertTrue(sol['x'] is not None)
+        sol = solvers.qp(P*P.T, c, G, h, options = options)
+        self.assertEqual(sol['status'], 'time limit')
+
+        # A large limit does not change the solution.
+        ref = solvers.lp(c, G, h, options = self.options)
+        sol = solvers.lp(c, G, h, options = dict(self.options, time_limit =
+            1e3))
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertEqual(sol['iterations'], ref['iterations'])
+
+    def test_nested(self):
+        # A deadline used as the cancellation token of another one
+        # reports its own reason.
+        outer = misc.Deadline(time_limit = 1e-9)
+        inner = misc.Deadline(cancel = outer)
+        self.assertEqual(inner.check(), 'time limit')
+        token = solvers.CancelToken()
+        token.cancel()
+        self.assertEqual(misc.Deadline(cancel = misc.Deadline(cancel =
+            token)).check(), 'cancelled')
+
+    def test_cancel_lp(self):
+        setseed(2)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        token = solvers.CancelToken()
+        options = dict(self.options, cancel = token)
+        sol = solvers.lp(c, G, h, kktsolver = self.cancelling_kktsolver(G,
+            token, 4), options = options)
+        self.assertEqual(sol['status'], 'cancelled')
+        self.assertTrue(0 < sol['iterations'] < 5)
+        self.assertTrue(sol['primal slack'] > 0.0)
+        self.assertTrue(token.cancelled())
+
+        token.reset()
+        sol = solvers.lp(c, G, h, options = options)
+        self.assertEqual(sol['status'], 'optimal')
+
+    def test_cancel_qp(self):
+        setseed(3)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        P = normal(n,n)
+        P = P*P.T
+        token = solvers.CancelToken()
+        sol = solvers.qp(P, normal(n,1), G, h, kktsolver =
+            self.cancelling_kktsolver(G, token, 3, P), options =
+            dict(self.options, cancel = token))
+        self.assertEqual(sol['status'], 'cancelled')
+        self.assertTrue(0 < sol['iterations'] < 4)
+
+    def test_cancel_cp(self):
+        setseed(4)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        token = solvers.CancelToken()
+        def F(x = None, z = None):
+            if x is None: return 0, matrix(0.0, (n,1))
+            f = sum((x - 1.0)**2)
+            Df = 2.0 * (x - 1.0).T
+            if z is None: return f, Df
+            token.cancel()
+            return f, Df, z[0] * spdiag(matrix(2.0, (n,1)))
+        sol = solvers.cp(F, G, h, options = dict(self.options, cancel =
+            token))
+        self.assertEqual(sol['status'], 'cancelled')
+        self.assertTrue(sol['x'] is not None)
+
+    def test_cancel_dsdp(self):
+        # A token in options['dsdp'] or dsdp.options, with or without 
+        # options['time_limit'].
+        try:
+            from cvxopt import dsdp
+        except ImportError:
+            self.skipTest("DSDP not available")
+        c = matrix([1.,-1.,1.])
+        Gs = [ matrix([[-7., -11., -11., 3.], [ 7., -18., -18., 8.],
+            [-2., -8., -8., 1.]]) ]
+        hs = [ matrix([[33., -9.], [-9., 26.]]) ]
+        token = solvers.CancelToken()
+        token.cancel()
+        for time_limit in [None, 1e3]:
+            options = dict(self.options, time_limit = time_limit, dsdp = 
+                {'cancel': token})
+            sol = solvers.sdp(c, Gs = Gs, hs = hs, solver = 'dsdp', options 
+                = options)
+            self.assertEqual(sol['status'], 'cancelled')
+        dsdpoptions = dsdp.options
+        try:
+            dsdp.options = {'cancel': token}
+            sol = solvers.sdp(c, Gs = Gs, hs = hs, solver = 'dsdp', options 
+                = self.options)
+            self.assertEqual(sol['status'], 'cancelled')
+        finally:
+            dsdp.options = dsdpoptions
+
+    def test_thread(self):
+        # Cancelled from another thread while the solver waits in the
+        # KKT solver.
+        setseed(5)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        token = solvers.CancelToken()
+        started, result = threading.Event(), {}
+        dims = {'l': m, 'q': [], 's': []}
+        factor = misc.kkt_ldl(G, dims, matrix(0.0, (0, n)))
+        def kktsolver(W):
+            started.set()
+            token._event.wait(5.0)
+            return factor(W)
+        def solve():
+            result['sol'] = solvers.lp(c, G, h, kktsolver = kktsolver,
+                options = dict(self.options, cancel = token))
+        worker = threading.Thread(target = solve)
+        worker.start()
+        started.wait(5.0)
+        token.cancel()
+        worker.join(10.0)
+        self.assertEqual(result['sol']['status'], 'cancelled')
+
+    def test_invalid(self):
+        c, G, h = matrix([1.0]), matrix([-1.0]), matrix([0.0])
+        self.assertRaises(ValueError, solvers.lp, c, G, h, options =
+            {'time_limit': -1.0})
+        self.assertRaises(ValueError, solvers.lp, c, G, h, options =
+            {'cancel': True})
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,89 @@
+import unittest
+from cvxopt import matrix, spmatrix, sparse, normal, setseed
+
+class TestCholmod(unittest.TestCase):
+
+    def setUp(self):
+        setseed(1)
+        n, m = 30, 60
+        # A = B*B' + I with B sparse.
+        I = [ i % n for i in range(3*m) ]
+        J = [ i // 3 for i in range(3*m) ]
+        self.B = spmatrix(normal(3*m,1), I, J, (n,m))
+        self.A = self.B*self.B.T + spmatrix(1.0, range(n), range(n))
+        self.b = normal(n,1)
+        self.n = n
+
+    def factor_solve(self, A, b):
+        from cvxopt import cholmod
+        F = cholmod.symbolic(A)
+        cholmod.numeric(A, F)
+        x = +b
+        cholmod.solve(F, x)
+        return x
+
+    def assertSameSolution(self, F, A):
+        from cvxopt import cholmod
+        x = +self.b
+        cholmod.solve(F, x)
+        y = self.factor_solve(A, self.b)
+        self.assertTrue(max(abs(x - y)) < 1e-8 * max(abs(y)))
+
+    def test_updown(self):
+        from cvxopt import cholmod
+        A, n = self.A, self.n
+        F = cholmod.symbolic(A)
+        cholmod.numeric(A, F)
+        C = spmatrix(normal(6,1), [0, 5, 7, 2, 5, 29], [0, 0, 0, 1, 1, 1],
+            (n,2))
+        cholmod.updown(F, C)
+        self.assertSameSolution(F, A + C*C.T)
+        cholmod.updown(F, C, update = False)
+        self.assertSameSolution(F, A)
+        cholmod.updown(F, self.B[:, :4], update = False)
+        self.assertSameSolution(F, A - self.B[:, :4] * self.B[:, :4].T)
+
+    def test_rowdel_rowadd(self):
+        from cvxopt import cholmod
+        A, n, k = self.A, self.n, 4
+        F = cholmod.symbolic(A)
+        cholmod.numeric(A, F)
+        cholmod.rowdel(F, k)
+        Ad = +A
+        Ad[k, :] = 0.0
+        Ad[:, k] = 0.0
+        Ad[k, k] = 1.0
+        self.assertSameSolution(F, Ad)
+        R = A[:, k]
+        R[k] += 1.0
+        cholmod.rowadd(F, k, R)
+        Aa = +A
+        Aa[k, k] += 1.0
+        self.assertSameSolution(F, Aa)
+        with self.assertRaises(IndexError):
+            cholmod.rowdel(F, n)
+
+    def test_solve_block(self):
+        from cvxopt import cholmod
+        A, n = self.A, self.n
+        F = cholmod.symbolic(A)
+        cholmod.numeric(A, F)
+        B = normal(n+2, 3)
+        X = +B
+        cholmod.solve(F, X, nrhs = 3, ldB = n+2, offsetB = 1)
+        for k in range(3):
+            self.assertTrue(max(abs(X[1:n+1, k] - self.factor_solve(A,
+                B[1:n+1, k]))) < 1e-8 * max(abs(X[1:n+1, k])))
+            self.assertEqual(X[0, k], B[0, k])
+            self.assertEqual(X[n+1, k], B[n+1, k])
+
+        # The solution and workspaces kept between calls are resized
+        # when the number of columns changes.
+        for nrhs in [1, 5, 2]:
+            B = normal(n, nrhs)
+            X = +B
+            cholmod.solve(F, X)
+            self.assertTrue(max(abs(A*X - B)) < 1e-8 * max(abs(B)))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,93 @@
+import unittest
+from cvxopt import matrix, spmatrix, normal, setseed, solvers, blas, lapack
+from cvxopt import chordal
+
+class TestChordal(unittest.TestCase):
+
+    def setUp(self):
+        setseed(5)
+        self.options = {'show_progress': False}
+
+    def band(self, n, w):
+        # A random symmetric matrix with bandwidth w.
+        B = normal(n, w+1)
+        M = matrix(spmatrix([ B[j, i-j] for j in range(n) for i in
+            range(j, min(n, j+w+1)) ], [ i for j in range(n) for i in
+            range(j, min(n, j+w+1)) ], [ j for j in range(n) for i in
+            range(j, min(n, j+w+1)) ], (n, n)))
+        return M + M.T
+
+    def test_cliques(self):
+        # A cycle of length 6 and an isolated vertex.
+        edges = [ (k, (k+1) % 6) for k in range(6) ]
+        order, snodes, cl, parent = chordal.cliques(7, edges)
+        self.assertEqual(sorted(order), list(range(7)))
+        self.assertEqual(sorted(sum(snodes, [])), list(range(7)))
+        for i, j in edges:
+            self.assertTrue(any([ i in C and j in C for C in cl ]))
+        self.assertTrue(all([ len(C) <= 3 for C in cl ]))
+        self.assertEqual(parent.count(None), 2)
+
+        # Merging all cliques gives a single clique per component.
+        snodes, cl, parent = chordal.merge(snodes, cl, parent, tsize = 10)
+        self.assertEqual(sorted([ len(C) for C in cl ]), [1, 6])
+        self.assertEqual(parent, [None, None])
+
+    def test_completion(self):
+        n = 12
+        order, snodes, cl, parent = chordal.cliques(n, [ (i, j) for i in
+            range(n) for j in range(max(0, i-2), i) ])
+        A = normal(n, n)
+        Z = A * A.T
+        X = matrix(Z)
+        chordal.completion(X, order, cl)
+        for C in cl:
+            self.assertTrue(max(abs(X[C, C] - Z[C, C])) < 1e-10)
+        w = matrix(0.0, (n, 1))
+        lapack.syevd(matrix(X), w)
+        self.assertTrue(min(w) > 0.0)
+
+        # The inverse of the completion has the pattern of the graph.
+        Xi = matrix(X)
+        lapack.potrf(Xi)
+        lapack.potri(Xi)
+        self.assertTrue(max(abs(Xi[5:, 0])) < 1e-8 * max(abs(Xi)))
+
+    def test_sdp(self):
+        n, m = 60, 4
+        F = [ self.band(n, 2) for k in range(m) ]
+        G = matrix([ [ Fk[:] ] for Fk in F ])
+        h = matrix(0.0, (n, n))
+        h[::n+1] = 10.0
+        Z = self.band(n, 2)
+        Z[::n+1] = 2.0 * n
+        c = matrix([ -blas.dot(Fk[:], Z[:]) for Fk in F ])
+        ref = solvers.sdp(c, Gs = [G], hs = [h], options = self.options)
+        sol = solvers.sdp(c, Gs = [G], hs = [h], options = dict(self.options,
+            chordal = True))
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(len(sol['chordal'][0]) > 1)
+        self.assertTrue(abs(sol['primal objective'] -
+            ref['primal objective']) < 1e-5 * abs(ref['primal objective']))
+        self.assertTrue(blas.nrm2(sol['x'] - ref['x']) < 1e-3 * (1.0 +
+            blas.nrm2(ref['x'])))
+
+        # s = h - G*x, z is positive semidefinite and G'*z + c = 0.
+        x, s, z = sol['x'], sol['ss'][0], sol['zs'][0]
+        self.assertTrue(max(abs(s - h + matrix(G * x, (n, n)))) < 1e-6)
+        w = matrix(0.0, (n, 1))
+        lapack.syevd(matrix(z), w)
+        self.assertTrue(min(w) > -1e-8)
+        self.assertTrue(blas.nrm2(G.T * z[:] + c) < 1e-5 * (1.0 +
+            blas.nrm2(c)))
+
+        # Dense blocks are not converted.
+        G2 = matrix([ [ (Fk + 1.0)[:] ] for Fk in F ])
+        R = chordal.convert(c, G2, h[:], {'l': 0, 'q': [], 's': [n]})
+        self.assertEqual(R['blocks converted'], 0)
+        self.assertTrue(R['G'] is G2)
+        self.assertRaises(ValueError, solvers.sdp, c, Gs = [G], hs = [h],
+            options = {'chordal': 'yes'})
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,70 @@
+import unittest
+from cvxopt import matrix, normal, uniform, setseed, solvers, misc
+
+class TestCorrectors(unittest.TestCase):
+
+    def options(self, k):
+        return {'show_progress': False, 'centrality_correctors': k}
+
+    def counted(self, G, P):
+        # Returns a KKT solver for the QP that counts the factorizations.
+        dims = {'l': G.size[0], 'q': [], 's': []}
+        factor = misc.kkt_chol(G, dims, matrix(0.0, (0, G.size[1])))
+        count = [0]
+        def kktsolver(W):
+            count[0] += 1
+            return factor(W, P)
+        return kktsolver, count
+
+    def test_lp(self):
+        setseed(1)
+        m, n = 200, 60
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        ref = solvers.lp(c, G, h, options = self.options(0))
+        sol = solvers.lp(c, G, h, options = self.options(3))
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(sol['iterations'] < ref['iterations'])
+        self.assertAlmostEqual(sol['primal objective'],
+            ref['primal objective'], places = 5)
+
+    def test_qp(self):
+        setseed(7)
+        m, n = 200, 60
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        q = normal(n,1)
+        P = normal(n,n)
+        P = P*P.T
+        kktsolver, nref = self.counted(G, P)
+        ref = solvers.qp(P, q, G, h, kktsolver = kktsolver, options =
+            self.options(0))
+        kktsolver, nsol = self.counted(G, P)
+        sol = solvers.qp(P, q, G, h, kktsolver = kktsolver, options =
+            self.options(3))
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(nsol[0] < nref[0])
+        self.assertAlmostEqual(sol['primal objective'],
+            ref['primal objective'], places = 4)
+
+    def test_conelp(self):
+        c = matrix([-6., -4., -5.])
+        G = matrix([[ 16., 7.,  24.,  -8.,   8.,  -1.,  0., -1.,  0.,  0.,
+            7., -5.,   1.,  -5.,   1.,  -7.,   1.,   -7.,  -4.],
+            [-14., 2.,   7., -13., -18.,   3.,  0.,  0., -1.,  0.,   3.,
+            13.,  -6.,  13.,  12., -10.,  -6.,  -10., -28.],
+            [  5., 0., -15.,  12.,  -6.,  17.,  0.,  0.,  0., -1.,   9.,
+            6.,  -6.,   6.,  -7.,  -7.,  -6.,   -7., -11.]])
+        h = matrix( [ -3., 5.,  12.,  -2., -14., -13., 10.,  0.,  0.,  0.,
+            68., -30., -19., -30.,  99.,  23., -19.,   23.,  10.] )
+        dims = {'l': 2, 'q': [4, 4], 's': [3]}
+        sol = solvers.conelp(c, G, h, dims, options = self.options(2))
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertAlmostEqual(sol['primal objective'], -10.9485494, 
+            places = 5)
+        with self.assertRaises(ValueError):
+            solvers.conelp(c, G, h, dims, options = self.options(-1))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,109 @@
+import unittest, math
+from cvxopt import matrix, spdiag, normal, uniform, setseed, solvers, blas
+from cvxopt import exp, mul, misc
+
+class TestEquilibrate(unittest.TestCase):
+
+    def setUp(self):
+        self.options = {'show_progress': False}
+        self.equil = {'show_progress': False, 'equilibrate': True}
+
+    def scalings(self, m, n, k):
+        # Random row and column scalings between 10^-k and 10^k.
+        return exp(k*math.log(10)*(2*uniform(m,1) - 1)), \
+            exp(k*math.log(10)*(2*uniform(n,1) - 1))
+
+    def test_lp(self):
+        setseed(2)
+        m, n = 60, 20
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        Dr, Dc = self.scalings(m, n, 3)
+        c, G, h = mul(Dc, c), spdiag(Dr)*G*spdiag(Dc), mul(Dr, h)
+        ref = solvers.lp(c, G, h, options = self.options)
+        sol = solvers.lp(c, G, h, options = self.equil)
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(sol['iterations'] < ref['iterations'])
+        self.assertAlmostEqual(sol['primal objective'],
+            ref['primal objective'], places = 5)
+        x, s, z = sol['x'], sol['s'], sol['z']
+        self.assertTrue(blas.nrm2(G*x + s - h) < 1e-6*blas.nrm2(h))
+        self.assertTrue(blas.nrm2(G.T*z + c) < 1e-6*blas.nrm2(c))
+        self.assertTrue(min(s) > 0.0 and min(z) > 0.0)
+        self.assertAlmostEqual(sol['primal slack'], min(s))
+
+    def test_conelp(self):
+        c = matrix([-6., -4., -5.])
+        G = matrix([[ 16., 7.,  24.,  -8.,   8.,  -1.,  0., -1.,  0.,  0.,
+            7., -5.,   1.,  -5.,   1.,  -7.,   1.,   -7.,  -4.],
+            [-14., 2.,   7., -13., -18.,   3.,  0.,  0., -1.,  0.,   3.,
+            13.,  -6.,  13.,  12., -10.,  -6.,  -10., -28.],
+            [  5., 0., -15.,  12.,  -6.,  17.,  0.,  0.,  0., -1.,   9.,
+            6.,  -6.,   6.,  -7.,  -7.,  -6.,   -7., -11.]])
+        h = matrix( [ -3., 5.,  12.,  -2., -14., -13., 10.,  0.,  0.,  0.,
+            68., -30., -19., -30.,  99.,  23., -19.,   23.,  10.] )
+        dims = {'l': 2, 'q': [4, 4], 's': [3]}
+
+        # Scale the cone blocks uniformly, so that the problem is
+        # equivalent to the original one.
+        Dr = matrix([1e3, 1e-2] + [1e-3]*4 + [1e2]*4 + [1e-2]*9)
+        Dc = matrix([1e2, 1.0, 1e-3])
+        c, G, h = mul(Dc, c), spdiag(Dr)*G*spdiag(Dc), mul(Dr, h)
+        ref = solvers.conelp(c, G, h, dims, options = self.options)
+        sol = solvers.conelp(c, G, h, dims, options = self.equil)
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(sol['iterations'] < ref['iterations'])
+        self.assertAlmostEqual(sol['primal objective'],
+            ref['primal objective'], places = 5)
+        x, s, z = sol['x'], sol['s'], sol['z']
+        self.assertTrue(blas.nrm2(G*x + s - h) < 1e-6*blas.nrm2(h))
+        self.assertTrue(blas.nrm2(G.T*z + c) < 1e-6*blas.nrm2(c))
+        self.assertTrue(misc.max_step(s, dims) < 0.0)
+        self.assertTrue(misc.max_step(z, dims) < 0.0)
+
+        # The scaling is constant on the 'q' and 's' blocks.
+        S = misc.equilibrate(c, G, h, dims, matrix(0.0, (0,3)),
+            matrix(0.0, (0,1)))[-1]
+        for k, m in [(2, 4), (6, 4), (10, 9)]:
+            self.assertEqual(max(S['d'][k:k+m]), min(S['d'][k:k+m]))
+
+    def test_qp(self):
+        setseed(1)
+        m, n = 50, 15
+        P = normal(n,n)
+        P = P*P.T
+        q = normal(n,1)
+        G = normal(m,n)
+        x0 = uniform(n,1)
+        h = G*x0 + uniform(m,1)
+        A = normal(3,n)
+        b = A*x0
+        Dr, Dc = self.scalings(m, n, 3)
+        P, q = spdiag(Dc)*P*spdiag(Dc), mul(Dc, q)
+        G, h, A = spdiag(Dr)*G*spdiag(Dc), mul(Dr, h), A*spdiag(Dc)
+        ref = solvers.qp(P, q, G, h, A, b, options = self.options)
+        sol = solvers.qp(P, q, G, h, A, b, options = self.equil)
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(sol['iterations'] < ref['iterations'])
+        self.assertAlmostEqual(sol['primal objective'],
+            ref['primal objective'], places = 4)
+        x, y, z = sol['x'], sol['y'], sol['z']
+        self.assertTrue(blas.nrm2(A*x - b) < 1e-6)
+        self.assertTrue(blas.nrm2(P*x + G.T*z + A.T*y + q) < 1e-5 *
+            blas.nrm2(q))
+
+    def test_infeasible(self):
+        c = matrix([1.0, 1.0])
+        G = spdiag(matrix([1e3, 1e-2, 1.0])) * matrix([[1.0, -1.0, 0.0],
+            [0.0, 0.0, -1.0]])
+        h = matrix([1e3, -2e-2, 0.0])
+        sol = solvers.lp(c, G, h, options = self.equil)
+        self.assertEqual(sol['status'], 'primal infeasible')
+        z = sol['z']
+        self.assertAlmostEqual(blas.dot(h, z), -1.0)
+        self.assertTrue(blas.nrm2(G.T*z) < 1e-6)
+        self.assertTrue(min(z) >= 0.0)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,63 @@
+import unittest
+from cvxopt import matrix, normal, setseed, blas, solvers, misc
+
+class TestLanczos(unittest.TestCase):
+
+    def setUp(self):
+        setseed(4)
+
+    def symmetric(self, n):
+        A = normal(n, n)
+        return (A + A.T) / (2.0 * n)**0.5
+
+    def test_max_step(self):
+        dims = {'l': 2, 'q': [3], 's': [3, 40, 60]}
+        x = matrix([normal(5, 1)] + [ self.symmetric(n)[:] for n in
+            dims['s'] ])
+        ref = misc.max_step(x, dims)
+        v = matrix(0.0, (sum(dims['s']), 1))
+        for k in range(3):
+            t = misc.max_step(x, dims, lanczos = 10, v = v)
+            self.assertTrue(abs(t - ref) <= 1e-7 * max(1.0, abs(ref)))
+        self.assertEqual(list(v[:3]), [0.0, 0.0, 0.0])
+
+        # The segments of v are eigenvectors of the blocks of order 10 or
+        # more.
+        ind, ind2 = 5 + 9, 3
+        for n in dims['s'][1:]:
+            X, u = matrix(x[ind : ind + n*n], (n, n)), v[ind2 : ind2 + n]
+            lmin = -misc.max_step(X[:], {'l': 0, 'q': [], 's': [n]})
+            self.assertTrue(abs(blas.nrm2(u) - 1.0) < 1e-8)
+            self.assertTrue(blas.nrm2(X*u - lmin*u) < 1e-6)
+            ind, ind2 = ind + n*n, ind2 + n
+
+        # Without starting vectors and with sigma.
+        t = misc.max_step(x, dims, lanczos = 10)
+        self.assertTrue(abs(t - ref) <= 1e-7 * max(1.0, abs(ref)))
+        sigma = matrix(0.0, (sum(dims['s']), 1))
+        self.assertEqual(misc.max_step(matrix(x), dims, sigma = sigma,
+            lanczos = 10), misc.max_step(matrix(x), dims, sigma = sigma))
+        self.assertRaises(TypeError, misc.max_step, x, dims, lanczos = 10,
+            v = matrix(0.0, (10, 1)))
+
+    def test_sdp(self):
+        n, m = 30, 5
+        F = [ self.symmetric(n) for k in range(m) ]
+        G = matrix([ [ Fk[:] ] for Fk in F ])
+        S, Z = normal(n, n), normal(n, n)
+        h = S * S.T - sum([ Fk * x for Fk, x in zip(F, normal(m, 1)) ],
+            matrix(0.0, (n, n)))
+        c = matrix([ -blas.dot(Fk[:], (Z * Z.T)[:]) for Fk in F ])
+        ref = solvers.sdp(c, Gs = [G], hs = [h], options = {'show_progress':
+            False})
+        sol = solvers.sdp(c, Gs = [G], hs = [h], options = {'show_progress':
+            False, 'lanczos': 20})
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertEqual(sol['iterations'], ref['iterations'])
+        self.assertTrue(abs(sol['primal objective'] -
+            ref['primal objective']) < 1e-6 * abs(ref['primal objective']))
+        self.assertRaises(ValueError, solvers.sdp, c, Gs = [G], hs = [h],
+            options = {'lanczos': -1})
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,104 @@
+import unittest
+from cvxopt import matrix, spmatrix, sparse, normal, setseed, solvers, \
+    blas, misc
+
+class TestLowRank(unittest.TestCase):
+
+    def setUp(self):
+        setseed(6)
+        self.options = {'show_progress': False}
+        self.n, self.ms = 6, [5, 8]
+        n = self.n
+
+        # Rank-one, rank-two, non-symmetric and zero columns.
+        self.Gs = [ [ normal(5, 1), normal(5, 2), None, (normal(5, 1),
+            normal(5, 1)), normal(5, 1), None ], [ normal(8, 1) if j % 2
+            else (normal(8, 2), normal(8, 2)) for j in range(n) ] ]
+        self.Gl = normal(3, n)
+
+    def dense(self):
+        # G with the columns of the 's' blocks formed explicitly.
+        G = [ self.Gl ]
+        for Gk, m in zip(self.Gs, self.ms):
+            B = matrix(0.0, (m*m, self.n))
+            for j, F in enumerate(Gk):
+                if F is None: continue
+                U, V = F if isinstance(F, tuple) else (F, F)
+                B[:, j] = (0.5 * (U * V.T + V * U.T))[:]
+            G.append(B)
+        return matrix(G)
+
+    def test_products(self):
+        G = misc.LowRank(self.Gl, self.Gs, self.ms)
+        Gd = self.dense()
+        dims = {'l': 3, 'q': [], 's': self.ms}
+        self.assertEqual(G.size, Gd.size)
+        x = normal(self.n, 1)
+        y1, y2 = normal(G.size[0], 1), matrix(0.0, (G.size[0], 1))
+        misc.sgemv(Gd, x, y2, dims, alpha = 2.0)
+        blas.axpy(y1, y2, alpha = 0.5)
+        G(x, y1, alpha = 2.0, beta = 0.5)
+        self.assertTrue(max(abs(y1 - y2)) < 1e-12 * max(abs(y2)))
+
+        z = normal(G.size[0], 1)
+        y1, y2 = normal(self.n, 1), matrix(0.0, (self.n, 1))
+        misc.sgemv(Gd, z, y2, dims, trans = 'T', alpha = -1.0)
+        blas.axpy(y1, y2, alpha = 2.0)
+        G(z, y1, trans = 'T', alpha = -1.0, beta = 2.0)
+        self.assertTrue(max(abs(y1 - y2)) < 1e-12 * max(abs(y2)))
+
+        # The Schur complement, against the dense product for a random
+        # scaling of the 's' blocks.
+        W = {'rti': [ normal(m, m) for m in self.ms ]}
+        H1, H2 = matrix(0.0, (self.n, self.n)), matrix(0.0, (self.n,
+            self.n))
+        G.schur(W, H1)
+        ind = 3
+        for m, rti in zip(self.ms, W['rti']):
+            for j in range(self.n):
+                F = matrix(Gd[ind : ind + m*m, j], (m, m))
+                Fs = rti.T * F * rti
+                for i in range(self.n):
+                    E = matrix(Gd[ind : ind + m*m, i], (m, m))
+                    H2[i, j] += blas.dot((rti.T * E * rti)[:], Fs[:])
+            ind += m*m
+        self.assertTrue(max(abs(H1 - H2)) < 1e-10 * max(abs(H2)))
+
+        self.assertRaises(TypeError, misc.LowRank, self.Gl, self.Gs[:1],
+            self.ms)
+        self.assertRaises(TypeError, misc.LowRank, self.Gl, [ self.Gs[0],
+            [ normal(7, 1) ] * self.n ], self.ms)
+
+    def test_sdp(self):
+        # sum_j x_j * F_j + s = h with h positive definite, and c = -G'*z
+        # for a positive definite z, so that the problem has a solution.
+        n = self.n
+        hs = [ matrix(0.0, (m, m)) for m in self.ms ]
+        for m, h in zip(self.ms, hs): h[::m+1] = 1.0
+        hl = matrix(1.0, (3, 1))
+        Gd = self.dense()
+        c = matrix(0.0, (n, 1))
+        misc.sgemv(Gd, matrix([ hl ] + [ h[:] for h in hs ]), c, {'l': 3,
+            'q': [], 's': self.ms}, trans = 'T', alpha = -1.0)
+        ref = solvers.sdp(c, Gl = self.Gl, hl = hl, Gs = [ Gd[3:28, :],
+            Gd[28:, :] ], hs = hs, options = self.options)
+        sol = solvers.sdp(c, Gl = self.Gl, hl = hl, Gs = self.Gs, hs = hs,
+            options = self.options)
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(abs(sol['primal objective'] -
+            ref['primal objective']) < 1e-6 * (1.0 +
+            abs(ref['primal objective'])))
+        self.assertTrue(blas.nrm2(sol['x'] - ref['x']) < 1e-4 * (1.0 +
+            blas.nrm2(ref['x'])))
+        for k in range(2):
+            self.assertEqual(sol['zs'][k].size, (self.ms[k], self.ms[k]))
+
+        self.assertRaises(ValueError, solvers.sdp, c, Gl = self.Gl, hl =
+            hl, Gs = self.Gs, hs = hs, kktsolver = 'qr')
+        self.assertRaises(ValueError, solvers.sdp, c, Gs = self.Gs, hs =
+            hs, solver = 'dsdp')
+        self.assertRaises(TypeError, solvers.sdp, c, Gs = [ self.Gs[0][:3]
+            ], hs = hs[:1])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,88 @@
+import unittest
+from cvxopt import matrix, normal, uniform, setseed, lapack, solvers
+from cvxopt import blas, misc
+
+class TestMixedPrecision(unittest.TestCase):
+
+    def assertAlmostEqualLists(self,L1,L2,places=7):
+        self.assertEqual(len(L1),len(L2))
+        for u,v in zip(L1,L2): self.assertAlmostEqual(u,v,places)
+
+    def test_single_factor(self):
+        setseed(1)
+        n = 20
+        A = normal(n,n)
+        A = A*A.T + n*matrix([[float(i==j) for i in range(n)] for j in range(n)])
+        b = normal(n,2)
+        Ac = +A
+        x = +b
+        F = lapack.spotrf(A)
+        lapack.spotrs(F, x)
+        self.assertAlmostEqualLists(list(A), list(Ac))
+        self.assertAlmostEqualLists(list(A*x), list(b), places=3)
+        x = +b
+        F = lapack.ssytrf(A - 2*n)
+        lapack.ssytrs(F, x)
+        self.assertAlmostEqualLists(list((A - 2*n)*x), list(b), places=3)
+        with self.assertRaises(TypeError):
+            lapack.spotrs(F, x)
+        with self.assertRaises(OverflowError):
+            lapack.spotrf(1e40*A)
+
+        # B is not modified if it cannot be rounded to single precision.
+        F = lapack.spotrf(A)
+        x = 1e40*b
+        with self.assertRaises(OverflowError):
+            lapack.spotrs(F, x)
+        self.assertEqual(list(x), list(1e40*b))
+
+    def test_sfactor_overflow(self):
+        # A right-hand side that overflows in single precision is solved
+        # in double precision.
+        setseed(4)
+        n = 10
+        A = normal(n,n)
+        A = A*A.T + n*matrix([[float(i==j) for i in range(n)] for j in range(n)])
+        K, F = +A, {'single': True}
+        solve = misc.sfactor(K, F)
+        x = 1e40*normal(n,1)
+        b = +x
+        solve(x)
+        self.assertFalse(F['single'])
+        self.assertTrue(blas.nrm2(A*x - b) <= 1e-10*blas.nrm2(b))
+
+    def test_lp(self):
+        setseed(2)
+        m, n = 60, 30
+        A = normal(m,n)
+        b = A*uniform(n,1) + uniform(m,1)
+        c = -A.T*uniform(m,1)
+        for kktsolver in ['ldl', 'ldl2', 'chol']:
+            sol1 = solvers.lp(c, A, b, kktsolver = kktsolver, options =
+                {'show_progress': False})
+            sol2 = solvers.lp(c, A, b, kktsolver = kktsolver, options =
+                {'show_progress': False, 'mixed_precision': True})
+            self.assertEqual(sol2['status'], 'optimal')
+            self.assertAlmostEqual(sol1['primal objective'],
+                sol2['primal objective'], places=5)
+        with self.assertRaises(ValueError):
+            solvers.lp(c, A, b, kktsolver = 'qr', options =
+                {'mixed_precision': True})
+
+    def test_qp(self):
+        setseed(3)
+        m, n = 40, 20
+        P = normal(n,n)
+        P = P*P.T
+        q = normal(n,1)
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        sol1 = solvers.qp(P, q, G, h, options = {'show_progress': False})
+        sol2 = solvers.qp(P, q, G, h, options = {'show_progress': False,
+            'mixed_precision': True})
+        self.assertEqual(sol2['status'], 'optimal')
+        self.assertAlmostEqualLists(list(sol1['x']), list(sol2['x']),
+            places=4)
+
+if __name__ == '__main__':
+    unittest.main()
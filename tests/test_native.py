@@ -0,0 +1,102 @@
+import unittest, os
+from cvxopt import matrix, sparse, normal, uniform, setseed, solvers
+from cvxopt import blas, misc_solvers
+from cvxopt.modeling import op
+
+class TestNative(unittest.TestCase):
+
+    def setUp(self):
+        self.options = {'show_progress': False}
+        setseed(1)
+        m, n, p = 40, 12, 3
+        P = normal(n,n)
+        self.P = P*P.T
+        self.q = normal(n,1)
+        self.G = normal(m,n)
+        x0 = uniform(n,1)
+        self.h = self.G*x0 + uniform(m,1)
+        self.A = normal(p,n)
+        self.b = self.A*x0
+        self.c = -self.G.T*uniform(m,1)
+
+    def check(self, sol, ref):
+        self.assertEqual(sol['status'], 'optimal')
+        for key in ['primal objective', 'dual objective']:
+            self.assertAlmostEqual(sol[key], ref[key], places = 5)
+        for key in ['x', 'y', 'z']:
+            self.assertTrue(blas.nrm2(sol[key] - ref[key]) < 1e-4)
+        self.assertTrue(min(sol['s']) > 0.0 and min(sol['z']) > 0.0)
+        self.assertEqual(sol['primal slack'], min(sol['s']))
+
+    def test_qp(self):
+        ref = solvers.qp(self.P, self.q, self.G, self.h, self.A, self.b,
+            options = self.options)
+        sol = solvers.qp(self.P, self.q, self.G, self.h, self.A, self.b,
+            solver = 'native', options = self.options)
+        self.check(sol, ref)
+        self.assertEqual(sol['iterations'], ref['iterations'])
+
+        # Sparse data are converted to dense matrices.
+        sol = solvers.qp(sparse(self.P), self.q, sparse(self.G), self.h,
+            sparse(self.A), self.b, solver = 'native', options =
+            self.options)
+        self.check(sol, ref)
+
+    def test_lp(self):
+        ref = solvers.lp(self.c, self.G, self.h, self.A, self.b,
+            options = self.options)
+        sol = solvers.lp(self.c, self.G, self.h, self.A, self.b,
+            solver = 'native', options = self.options)
+        self.check(sol, ref)
+        self.assertTrue(sol['residual as primal infeasibility '\
+            'certificate'] is None)
+
+    def test_boeing2(self):
+        lp = op()
+        lp.fromfile(os.path.join(os.path.dirname(__file__), "boeing2.mps"))
+        lp.solve(solver = 'native', options = self.options)
+        self.assertEqual(lp.status, 'optimal')
+        self.assertAlmostEqual(lp.objective.value()[0], -315.0187,
+            places = 3)
+
+    def test_unconstrained(self):
+        sol = solvers.qp(self.P, self.q, solver = 'native')
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertTrue(blas.nrm2(self.P*sol['x'] + self.q) < 1e-8)
+
+    def test_maxiters(self):
+        options = dict(self.options, maxiters = 2)
+        sol = solvers.qp(self.P, self.q, self.G, self.h, solver = 'native',
+            options = options)
+        self.assertEqual(sol['status'], 'unknown')
+        self.assertEqual(sol['iterations'], 2)
+
+    def test_singular(self):
+        G = matrix(0.0, (1, self.c.size[0]))
+        self.assertRaises(ValueError, solvers.lp, self.c, G, matrix(1.0),
+            solver = 'native')
+
+    def test_batch(self):
+        probs = [ (self.P, self.q, self.G, self.h + 0.1*k, self.A, self.b)
+            for k in range(6) ]
+        sols = solvers.qp_batch(probs, processes = 3, solver = 'native',
+            options = self.options)
+        for prob, sol in zip(probs, sols):
+            ref = solvers.qp(*prob, options = self.options)
+            self.check(sol, ref)
+
+        probs = [ {'c': self.c, 'G': self.G, 'h': self.h + 0.1*k}
+            for k in range(3) ]
+        sols = solvers.lp_batch(probs, processes = 2, solver = 'native',
+            options = self.options)
+        self.assertEqual([ sol['status'] for sol in sols ], ['optimal']*3)
+
+    def test_invalid(self):
+        prob = (self.q, self.G, self.h, self.A, self.b, self.P)
+        self.assertRaises(TypeError, misc_solvers.qp, list(prob))
+        self.assertRaises(TypeError, misc_solvers.qp_batch, [prob,
+            list(prob)])
+        self.assertRaises(TypeError, misc_solvers.qp_batch, [prob, 1.0])
+
+if __name__ == '__main__':
+    unittest.main()
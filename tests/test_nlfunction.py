@@ -0,0 +1,212 @@
+import unittest, ctypes
+from cvxopt import matrix, spdiag, log, normal, uniform, setseed, misc, \
+    solvers
+
+# struct cvxopt_nlfunction in cvxopt.h.
+EVAL = ctypes.CFUNCTYPE(ctypes.c_int, ctypes.POINTER(ctypes.c_double),
+    ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double),
+    ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double),
+    ctypes.c_void_p)
+
+class NLFunction(ctypes.Structure):
+    _fields_ = [('m', ctypes.c_int), ('n', ctypes.c_int), ('x0',
+        ctypes.POINTER(ctypes.c_double)), ('eval', EVAL), ('params',
+        ctypes.c_void_p)]
+
+def capsule(m, n, x0, eval):
+    # Returns a PyCapsule for the C function eval, and the objects that
+    # must be kept alive while it is used.
+    new = ctypes.pythonapi.PyCapsule_New
+    new.restype = ctypes.py_object
+    new.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_void_p]
+    cx0 = (ctypes.c_double * n)(*x0) if x0 is not None else None
+    s = NLFunction(m, n, cx0, EVAL(eval), None)
+    return new(ctypes.addressof(s), b"cvxopt.nlfunction", None), (s, cx0)
+
+def acent_eval(n, calls):
+    # f0(x) = -sum(log(x)), with H = diag(z[0] / x.^2) in the lower
+    # triangle only.
+    def eval(x, z, f, Df, H, params):
+        calls.append(bool(z))
+        if min(x[i] for i in range(n)) <= 0.0: return 1
+        f[0] = -sum(log(matrix([ x[i] for i in range(n) ])))
+        for i in range(n): Df[i] = -1.0 / x[i]
+        if z:
+            for j in range(n):
+                for i in range(j, n):
+                    H[i + j*n] = z[0] / x[i]**2 if i == j else 0.0
+                for i in range(j):
+                    H[i + j*n] = 1e10
+        return 0
+    return eval
+
+class TestNLFunction(unittest.TestCase):
+
+    def setUp(self):
+        setseed(5)
+        self.m, self.n = 3, 6
+        self.A = normal(self.m, self.n)
+        self.b = self.A * uniform(self.n, 1, 0.5, 1.5)
+
+    def F(self, x = None, z = None):
+        if x is None: return 0, matrix(1.0, (self.n, 1))
+        if min(x) <= 0.0: return None
+        f = -sum(log(x))
+        Df = -(x**-1).T
+        if z is None: return matrix(f), Df
+        return matrix(f), Df, spdiag(z[0] * x**-2)
+
+    def test_nlfunction(self):
+        calls = []
+        cap, keep = capsule(1, self.n, [1.0] * self.n, acent_eval(self.n,
+            calls))
+        F = misc.NLFunction(cap)
+        mnl, x0 = F()
+        self.assertEqual((mnl, list(x0)), (1, [1.0] * self.n))
+        self.assertEqual(misc.NLFunction(cap, objective = True)()[0], 0)
+        x = uniform(self.n, 1, 0.5, 1.5)
+        f, Df = F(x)
+        self.assertTrue(f is F.f and Df is F.Df)
+        self.assertAlmostEqual(f[0], self.F(x)[0][0])
+        z = matrix([2.0])
+        f, Df, H = F(x, z)
+        self.assertTrue(max(abs(H - matrix(self.F(x, z)[2]))) < 1e-12)
+        self.assertEqual(calls, [False, True])
+        ft, Dft = F.trial(2.0 * x)
+        self.assertTrue(ft is F.ft and Dft is F.Dft and Df is F.Df)
+        self.assertAlmostEqual(f[0], self.F(x)[0][0])
+        x[0] = -1.0
+        self.assertTrue(F(x) is None and F.trial(x) is None)
+
+        self.assertRaises(TypeError, F, matrix(1.0, (self.n + 1, 1)))
+        self.assertRaises(TypeError, misc.NLFunction, self.F)
+        F0 = self.F
+        self.assertTrue(misc.nlfunction(F0) is F0)
+
+        # Return values other than 0 and 1 are errors.
+        cap2, keep2 = capsule(1, self.n, None, lambda x, z, f, Df, H, p: 2)
+        F2 = misc.NLFunction(cap2)
+        self.assertEqual(list(F2()[1]), [0.0] * self.n)
+        self.assertRaises(ValueError, F2, x)
+
+    def test_cp(self):
+        # Analytic centering of {x | A*x = b, x > 0}.
+        opts = {'show_progress': False}
+        cap, keep = capsule(1, self.n, [1.0] * self.n, acent_eval(self.n,
+            []))
+        for kktsolver in [None, 'ldl']:
+            sol1 = solvers.cp(cap, A = self.A, b = self.b, kktsolver =
+                kktsolver, options = opts)
+            sol2 = solvers.cp(self.F, A = self.A, b = self.b, kktsolver =
+                kktsolver, options = opts)
+            self.assertEqual(sol1['status'], 'optimal')
+            self.assertTrue(max(abs(sol1['x'] - sol2['x'])) < 1e-8)
+
+    def test_cpl(self):
+        # minimize c'*x subject to -sum(log(x)) <= 1, A*x = b.
+        def eval(x, z, f, Df, H, params):
+            e = acent_eval(self.n, [])(x, z, f, Df, H, params)
+            f[0] -= 1.0
+            return e
+        cap, keep = capsule(1, self.n, [1.0] * self.n, eval)
+        def F(x = None, z = None):
+            if x is None: return 1, self.F()[1]
+            r = self.F(x, z)
+            if r is None: return None
+            r[0][0] -= 1.0
+            return r
+        c = uniform(self.n, 1)
+        opts = {'show_progress': False}
+        sol1 = solvers.cpl(c, cap, options = opts)
+        sol2 = solvers.cpl(c, F, options = opts)
+        self.assertEqual(sol1['status'], 'optimal')
+        self.assertTrue(max(abs(sol1['x'] - sol2['x'])) < 1e-8)
+
+        # The iterates are the same (the line search does not overwrite
+        # the derivatives at x).
+        self.assertAlmostEqual(sol1['primal infeasibility'],
+            sol2['primal infeasibility'], places = 14)
+
+class TestLineSearchBatch(unittest.TestCase):
+
+    def setUp(self):
+        t = TestNLFunction('test_cpl')
+        t.setUp()
+        self.n, self.F0 = t.n, t.F
+        self.c = uniform(self.n, 1)
+        self.calls = []
+
+    def F(self, x = None, z = None):
+        # -sum(log(x)) - 1 <= 0.
+        if x is None: return 1, self.F0()[1]
+        self.calls.append(1)
+        r = self.F0(x, z)
+        if r is None: return None
+        r[0][0] -= 1.0
+        return r
+
+    def solve(self, F, **opts):
+        opts['show_progress'] = False
+        return solvers.cpl(self.c, F, options = opts)
+
+    def assertSame(self, sol1, sol2):
+        self.assertEqual(sol1['status'], 'optimal')
+        self.assertEqual(list(sol1['x']), list(sol2['x']))
+        self.assertEqual(sol1['primal infeasibility'],
+            sol2['primal infeasibility'])
+
+    def test_batch(self):
+        # The iterates are the same as without batches, with batches of
+        # trial points evaluated serially, by threads, by F.batch() and
+        # by misc_solvers.nlfunction_batch().
+        sol = self.solve(self.F)
+        serial = len(self.calls)
+        for k, threads in [(3, 1), (3, 2), (8, 4)]:
+            self.assertSame(self.solve(self.F, linesearch_batch = k,
+                linesearch_threads = threads), sol)
+
+        batches = []
+        def F(x = None, z = None):
+            return self.F(x, z)
+        F.batch = lambda X: batches.append(len(X)) or [ self.F(x) for x
+            in X ]
+        del self.calls[:]
+        self.assertSame(self.solve(F, linesearch_batch = 4), sol)
+        self.assertTrue(set(batches) == set([4]))
+        self.assertTrue(len(self.calls) - sum(batches) + len(batches) <
+            serial)
+
+        def eval(x, z, f, Df, H, params):
+            e = acent_eval(self.n, [])(x, z, f, Df, H, params)
+            f[0] -= 1.0
+            return e
+        cap, keep = capsule(1, self.n, [1.0] * self.n, eval)
+        sol = self.solve(cap)
+        for threads in [1, 3]:
+            self.assertSame(self.solve(cap, linesearch_batch = 3,
+                linesearch_threads = threads), sol)
+
+    def test_cp(self):
+        t = TestNLFunction('test_cp')
+        t.setUp()
+        opts = {'show_progress': False}
+        sol1 = solvers.cp(t.F, A = t.A, b = t.b, options = opts)
+        opts['linesearch_batch'] = 3
+        sol2 = solvers.cp(t.F, A = t.A, b = t.b, options = opts)
+        self.assertEqual(list(sol1['x']), list(sol2['x']))
+        cap, keep = capsule(1, t.n, [1.0] * t.n, acent_eval(t.n, []))
+        sol3 = solvers.cp(cap, A = t.A, b = t.b, options = opts)
+        self.assertTrue(max(abs(sol3['x'] - sol1['x'])) < 1e-8)
+
+    def test_parallel_map(self):
+        X = list(range(10))
+        for threads in [1, 3, 20]:
+            self.assertEqual(misc.parallel_map(lambda x: x**2, X, threads),
+                [ x**2 for x in X ])
+        self.assertRaises(ZeroDivisionError, misc.parallel_map, lambda x:
+            1 // x, X, 4)
+        for opt in ['linesearch_batch', 'linesearch_threads']:
+            self.assertRaises(ValueError, self.solve, self.F, **{opt: 0})
+
+if __name__ == '__main__':
+    unittest.main()
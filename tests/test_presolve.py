@@ -0,0 +1,156 @@
+import unittest
+from cvxopt import matrix, spmatrix, sparse, normal, setseed, solvers, blas
+from cvxopt import presolve
+
+class TestPresolve(unittest.TestCase):
+
+    def setUp(self):
+        self.options = {'show_progress': False}
+        setseed(3)
+        n, m = 8, 12
+        G0 = normal(m,n)
+        x0 = normal(n,1)
+        h0 = G0*x0 + 1.0
+
+        # Bounds -10 <= x <= 10, except x[3] = 2.
+        Gb = spmatrix([1.0]*n + [-1.0]*n, range(2*n), list(range(n))*2)
+        hb = matrix(10.0, (2*n,1))
+        hb[3], hb[n+3] = 2.0, -2.0
+
+        # Two duplicate inequalities and a dominated bound on x[0].
+        self.G = matrix(sparse([sparse(G0), Gb, sparse(matrix([2*G0[0,:],
+            G0[1,:]])), spmatrix(1.0, [0], [0], (1,n))]))
+        self.h = matrix([h0, hb, matrix([2*h0[0], h0[1]+1.0]),
+            matrix(100.0)])
+
+        # An equality that fixes x[5] and a linearly dependent equality.
+        A0 = normal(2,n)
+        self.A = matrix(sparse([sparse(A0), spmatrix(1.0, [0], [5], (1,n)),
+            sparse(A0[0,:] + A0[1,:])]))
+        self.b = matrix([A0*x0, x0[5], sum(A0*x0)])
+        self.c = normal(n,1)
+        P = normal(n,n)
+        self.P = P*P.T
+        self.P[:,3] = 0.0
+        self.P[3,:] = 0.0
+
+    def check(self, sol, ref, P = None):
+        G, h, A, b, c = self.G, self.h, self.A, self.b, self.c
+        x, s, y, z = sol['x'], sol['s'], sol['y'], sol['z']
+        self.assertEqual(sol['status'], 'optimal')
+        self.assertEqual(sol['presolve'], {'rows removed': 9,
+            'columns removed': 2})
+        self.assertAlmostEqual(sol['primal objective'],
+            ref['primal objective'], places = 5)
+        self.assertAlmostEqual(sol['dual objective'],
+            ref['dual objective'], places = 5)
+        self.assertTrue(blas.nrm2(G*x + s - h) < 1e-6)
+        self.assertTrue(blas.nrm2(A*x - b) < 1e-6)
+        self.assertTrue(min(s) > -1e-8 and min(z) > -1e-8)
+        r = G.T*z + A.T*y + c
+        if P is not None: r += P*x
+        self.assertTrue(blas.nrm2(r) < 1e-6)
+        self.assertTrue(blas.dot(s,z) < 1e-5)
+
+    def test_lp(self):
+        ref = solvers.lp(self.c, self.G, self.h, self.A[:3,:], self.b[:3],
+            options = self.options)
+        options = dict(self.options, presolve = True)
+        sol = solvers.lp(self.c, self.G, self.h, self.A, self.b, options =
+            options)
+        self.check(sol, ref)
+
+    def test_qp(self):
+        ref = solvers.qp(self.P, self.c, self.G, self.h, self.A[:3,:],
+            self.b[:3], options = self.options)
+        options = dict(self.options, presolve = True)
+        sol = solvers.qp(self.P, self.c, self.G, self.h, self.A, self.b,
+            options = options)
+        self.check(sol, ref, self.P)
+
+    def test_reduced(self):
+        R = presolve.presolve(self.c, self.G, self.h, self.A, self.b)
+        self.assertEqual(R['G'].size, (self.G.size[0] - 7, 6))
+        self.assertEqual(R['A'].size, (2, 6))
+        self.assertEqual(R['c'].size, (6,1))
+        self.assertTrue(R['P'] is None)
+
+    def test_time_limit(self):
+        # The time limit includes the presolve, and the last iterate of
+        # the reduced problem is returned without solving the original
+        # problem.
+        options = dict(self.options, presolve = True, time_limit = 1e-9)
+        sol = solvers.lp(self.c, self.G, self.h, self.A, self.b, options =
+            options)
+        self.assertEqual(sol['status'], 'time limit')
+        self.assertEqual(sol['iterations'], 0)
+        self.assertEqual(sol['presolve'], {'rows removed': 9,
+            'columns removed': 2})
+        self.assertEqual(sol['x'].size, self.c.size)
+        sol = solvers.qp(self.P, self.c, self.G, self.h, self.A, self.b,
+            options = options)
+        self.assertEqual(sol['status'], 'time limit')
+        self.assertTrue('presolve' in sol)
+
+        token = solvers.CancelToken()
+        token.cancel()
+        sol = solvers.lp(self.c, self.G, self.h, self.A, self.b, options =
+            dict(self.options, presolve = True, cancel = token))
+        self.assertEqual(sol['status'], 'cancelled')
+        self.assertTrue('presolve' in sol)
+
+        # A large limit does not change the solution.
+        ref = solvers.lp(self.c, self.G, self.h, self.A[:3,:], self.b[:3],
+            options = self.options)
+        sol = solvers.lp(self.c, self.G, self.h, self.A, self.b, options =
+            dict(options, time_limit = 1e3))
+        self.check(sol, ref)
+
+    def test_infeasible(self):
+        # Conflicting bounds are left to the solver.
+        c = matrix([1.0, 1.0])
+        G = matrix([[1.0, -1.0, 0.0], [0.0, 0.0, -1.0]])
+        h = matrix([1.0, -2.0, 0.0])
+        sol = solvers.lp(c, G, h, options = dict(self.options, presolve =
+            True))
+        self.assertEqual(sol['status'], 'primal infeasible')
+        self.assertFalse('presolve' in sol)
+
+    def test_inconsistent(self):
+        # An equality that is empty after x[0] is fixed by the first one,
+        # and a dependent equality with a different right-hand side.
+        G = spmatrix(-1.0, range(3), range(3))
+        h = matrix(0.0, (3,1))
+        c = matrix(1.0, (3,1))
+        for A, b in [ (matrix([[1.0, 1.0], [0.0, 0.0], [0.0, 0.0]]),
+            matrix([1.0, 3.0])), (matrix([[1.0, 0.0, 1.0], [1.0, 1.0,
+            2.0], [0.0, 1.0, 1.0]]), matrix([1.0, 1.0, 3.0])) ]:
+            R = presolve.presolve(c, G, h, A, b)
+            self.assertEqual(R['status'], 'primal infeasible')
+            for solver in [solvers.lp, lambda *args, **kwargs:
+                solvers.qp(spmatrix([], [], [], (3,3)), *args, **kwargs)]:
+                sol = solver(c, G, h, A, b, options = dict(self.options,
+                    presolve = True))
+                self.assertEqual(sol['status'], 'primal infeasible')
+                y, z = sol['y'], sol['z']
+                self.assertTrue(min(z) >= 0.0)
+                self.assertTrue(blas.nrm2(G.T*z + A.T*y) < 1e-10)
+                self.assertAlmostEqual(blas.dot(h, z) + blas.dot(b, y),
+                    -1.0)
+
+    def test_sparse(self):
+        # The reductions do not depend on the storage of G and A.
+        ref = solvers.lp(self.c, self.G, self.h, self.A[:3,:], self.b[:3],
+            options = self.options)
+        for M in [matrix, sparse]:
+            R = presolve.presolve(self.c, M(self.G), self.h, M(self.A),
+                self.b)
+            self.assertTrue(R['status'] is None)
+            self.assertEqual((R['rows removed'], R['columns removed']),
+                (9, 2))
+            sol = solvers.lp(self.c, M(self.G), self.h, M(self.A), self.b,
+                options = dict(self.options, presolve = True))
+            self.check(sol, ref)
+
+if __name__ == '__main__':
+    unittest.main()
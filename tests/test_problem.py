@@ -0,0 +1,91 @@
+import unittest
+from cvxopt import matrix, normal, uniform, setseed, solvers, misc
+
+class TestProblem(unittest.TestCase):
+
+    def setUp(self):
+        self.options = {'show_progress': False}
+
+    def assertAlmostEqualLists(self,L1,L2,places=7):
+        self.assertEqual(len(L1),len(L2))
+        for u,v in zip(L1,L2): self.assertAlmostEqual(u,v,places)
+
+    def test_lp(self):
+        setseed(1)
+        m, n, p = 60, 20, 5
+        G = normal(m,n)
+        A = normal(p,n)
+        x0 = uniform(n,1)
+        h = G*x0 + uniform(m,1)
+        b = A*x0
+        c = -G.T*uniform(m,1) + A.T*normal(p,1)
+
+        # The KKT solver factory is created once.
+        calls = []
+        kkt_chol = misc.kkt_chol
+        def counted(*args, **kwargs):
+            calls.append(1)
+            return kkt_chol(*args, **kwargs)
+        misc.kkt_chol = counted
+        try:
+            prob = solvers.Problem(c, G, h, A = A, b = b, kktsolver =
+                'chol', options = self.options)
+            for k in range(3):
+                h2, b2 = h + 1e-2*uniform(m,1), b + 1e-2*normal(p,1)
+                sol1 = prob.solve(h = h2, b = b2, warmstart = k > 0)
+                sol2 = solvers.lp(c, G, h2, A, b2, kktsolver = 'chol',
+                    options = self.options)
+                self.assertEqual(sol1['status'], 'optimal')
+                self.assertAlmostEqualLists(list(sol1['x']),
+                    list(sol2['x']), places = 5)
+        finally:
+            misc.kkt_chol = kkt_chol
+        self.assertEqual(len(calls), 4)
+
+    def test_qp(self):
+        setseed(2)
+        m, n = 40, 20
+        P = normal(n,n)
+        P = P*P.T
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        prob = solvers.Problem(normal(n,1), G, h, P = P, options =
+            self.options)
+        for k in range(3):
+            q = normal(n,1)
+            sol1 = prob.solve(c = q)
+            sol2 = solvers.qp(P, q, G, h, options = self.options)
+            self.assertEqual(sol1['status'], 'optimal')
+            self.assertAlmostEqualLists(list(sol1['x']), list(sol2['x']),
+                places = 5)
+        with self.assertRaises(ValueError):
+            solvers.Problem(q, G, h, P = P, kktsolver = 'qr')
+
+    def test_options(self):
+        # Options that apply to the default KKT solvers are used.
+        setseed(3)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        calls = []
+        equilibrate = misc.equilibrate
+        def counted(*args, **kwargs):
+            calls.append(1)
+            return equilibrate(*args, **kwargs)
+        misc.equilibrate = counted
+        try:
+            opts = dict(self.options, equilibrate = True)
+            for P in [None, matrix(0.0, (n,n))]:
+                prob = solvers.Problem(c, G, h, P = P, options = opts)
+                sol1 = prob.solve()
+                sol2 = solvers.lp(c, G, h, options = self.options)
+                self.assertEqual(sol1['status'], 'optimal')
+                self.assertAlmostEqualLists(list(sol1['x']),
+                    list(sol2['x']), places = 5)
+        finally:
+            misc.equilibrate = equilibrate
+        self.assertEqual(len(calls), 2)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,79 @@
+import unittest
+from cvxopt import matrix, spdiag, normal, uniform, setseed, solvers
+
+class TestProfile(unittest.TestCase):
+
+    def setUp(self):
+        self.records = []
+        self.options = {'show_progress': False, 'profile': True,
+            'profile_callback': self.records.append}
+
+    def check(self, sol):
+        prof = sol['profile']
+        self.assertEqual(len(prof['iterations']), sol['iterations'] + 1)
+        self.assertEqual(self.records, prof['iterations'])
+        self.assertEqual([ r['iteration'] for r in prof['iterations'] ],
+            list(range(sol['iterations'] + 1)))
+        # The totals include the computation of the starting point.
+        for phase in ['factor', 'solve', 'scaling', 'step', 'residuals']:
+            self.assertTrue(prof['total'][phase] >= sum([ r[phase] for r
+                in prof['iterations'] ]))
+            self.assertTrue(prof['total'][phase] > 0.0)
+        self.assertTrue(sum(prof['total'].values()) <= prof['time'])
+        self.assertEqual(prof['factorizations'], sum([ r['factorizations']
+            for r in prof['iterations'] ]) + 1)
+        self.assertTrue(prof['solves'] > prof['factorizations'])
+
+    def test_lp(self):
+        setseed(1)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        c = -G.T*uniform(m,1)
+        sol = solvers.lp(c, G, h, options = self.options)
+        self.assertEqual(sol['status'], 'optimal')
+        self.check(sol)
+        ref = solvers.lp(c, G, h, options = {'show_progress': False})
+        self.assertFalse('profile' in ref)
+        self.assertEqual(sol['iterations'], ref['iterations'])
+
+    def test_qp(self):
+        setseed(2)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        P = normal(n,n)
+        sol = solvers.qp(P*P.T, normal(n,1), G, h, kktsolver = 'ldl',
+            options = self.options)
+        self.assertEqual(sol['status'], 'optimal')
+        self.check(sol)
+        self.assertEqual(sol['profile']['factor nnz'], (n+m)*(n+m+1) // 2)
+
+    def test_cp(self):
+        setseed(3)
+        m, n = 30, 10
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        def F(x = None, z = None):
+            if x is None: return 0, matrix(0.0, (n,1))
+            f = sum((x - 1.0)**2)
+            Df = 2.0 * (x - 1.0).T
+            if z is None: return f, Df
+            return f, Df, z[0] * spdiag(matrix(2.0, (n,1)))
+        sol = solvers.cp(F, G, h, options = self.options)
+        self.assertEqual(sol['status'], 'optimal')
+        prof = sol['profile']
+        self.assertEqual(self.records, prof['iterations'])
+        self.assertTrue(prof['factorizations'] >= len(prof['iterations'])
+            - 1)
+        self.assertTrue(prof['total']['factor'] > 0.0)
+
+    def test_invalid(self):
+        c, G, h = matrix([1.0]), matrix([-1.0]), matrix([0.0])
+        self.assertRaises(ValueError, solvers.lp, c, G, h, options =
+            {'profile': 2})
+        self.assertRaises(ValueError, solvers.lp, c, G, h, options =
+            {'profile': True, 'profile_callback': 1.0})
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,242 @@
+import unittest, copy
+from cvxopt import matrix, sparse, normal, uniform, setseed, \
+    blas, lapack, misc, solvers
+
+def python_misc():
+    # A copy of cvxopt.misc that uses the Python versions of the functions
+    # implemented in misc_solvers.
+    path = misc.__file__
+    if path.endswith('.pyc'): path = path[:-1]
+    src = open(path).read().replace('use_C = True', 'use_C = False', 1)
+    ns = {'__name__': 'misc_python'}
+    exec(compile(src, path, 'exec'), ns)
+    return ns
+
+class TestScaling(unittest.TestCase):
+
+    def setUp(self):
+        setseed(1)
+        self.mnl = 2
+        self.dims = {'l': 3, 'q': [4, 1, 3], 's': [3, 1, 4]}
+        self.py = python_misc()
+
+    def point(self, factor = False, dims = None, mnl = None):
+        # Returns a random vector in the interior of the cone.  If factor
+        # is True, the 's' components are Cholesky factors.
+        if dims is None: dims, mnl = self.dims, self.mnl
+        x = [ uniform(mnl + dims['l'], 1, 0.5, 2.0) ]
+        for m in dims['q']:
+            xk = normal(m, 1)
+            xk[0] = blas.nrm2(xk, n = m-1, offset = 1) + uniform(1, 1)[0] \
+                + 0.1
+            x.append(xk)
+        for m in dims['s']:
+            A = normal(m, m)
+            X = A * A.T + matrix([ 1.0 if i == j else 0.0 for j in
+                range(m) for i in range(m) ], (m, m))
+            if factor:
+                lapack.potrf(X)
+                for j in range(m): X[:j, j] = 0.0
+            x.append(X[:])
+        return matrix([ xk for xk in x ])
+
+    def assertSame(self, W1, W2):
+        self.assertEqual(sorted(W1.keys()), sorted(W2.keys()))
+        for key in ['dnl', 'dnli', 'd', 'di']:
+            if key in W1: self.assertEqual(list(W1[key]), list(W2[key]))
+        self.assertEqual(W1['beta'], W2['beta'])
+        for key in ['v', 'r', 'rti']:
+            self.assertEqual(len(W1[key]), len(W2[key]))
+            for A, B in zip(W1[key], W2[key]):
+                self.assertEqual(A.size, B.size)
+                self.assertEqual(list(A), list(B))
+
+    def test_compute_scaling(self):
+        s, z = self.point(), self.point()
+        m = self.mnl + self.dims['l'] + sum(self.dims['q']) + \
+            sum(self.dims['s'])
+        for mnl in [None, self.mnl]:
+            dims = dict(self.dims)
+            if mnl is None: dims['l'] += self.mnl
+            l1, l2 = matrix(0.0, (m, 1)), matrix(0.0, (m, 1))
+            W1 = misc.compute_scaling(s, z, l1, dims, mnl)
+            W2 = self.py['compute_scaling'](s, z, l2, dims, mnl)
+            self.assertSame(W1, W2)
+            self.assertEqual(list(l1), list(l2))
+
+    def test_update_scaling(self):
+        s, z = self.point(), self.point()
+        m = self.mnl + self.dims['l'] + sum(self.dims['q']) + \
+            sum(self.dims['s'])
+        lmbda = matrix(0.0, (m, 1))
+        W1 = misc.compute_scaling(s, z, lmbda, self.dims, self.mnl)
+        W2 = copy.deepcopy(W1)
+        l1, l2 = matrix(lmbda), matrix(lmbda)
+        for k in range(3):
+            ds, dz = self.point(True), self.point(True)
+            s1, s2, z1, z2 = matrix(ds), matrix(ds), matrix(dz), matrix(dz)
+            misc.update_scaling(W1, l1, s1, z1)
+            self.py['update_scaling'](W2, l2, s2, z2)
+            self.assertSame(W1, W2)
+            self.assertEqual(list(l1), list(l2))
+            self.assertEqual(list(s1), list(s2))
+            self.assertEqual(list(z1), list(z2))
+
+    def test_preallocated(self):
+        s, z = self.point(), self.point()
+        m = self.mnl + self.dims['l'] + sum(self.dims['q']) + \
+            sum(self.dims['s'])
+        lmbda = matrix(0.0, (m, 1))
+        W = misc.compute_scaling(s, z, lmbda, self.dims, self.mnl)
+        r, v = W['r'][2], W['v'][0]
+        s, z = self.point(), self.point()
+        ref = misc.compute_scaling(s, z, matrix(0.0, (m, 1)), self.dims,
+            self.mnl)
+        self.assertTrue(misc.compute_scaling(s, z, lmbda, self.dims,
+            self.mnl, W = W) is W)
+        self.assertTrue(W['r'][2] is r and W['v'][0] is v)
+        self.assertSame(W, ref)
+
+        # W is rebuilt if the dimensions change.
+        dims = {'l': 2, 'q': [3], 's': [2]}
+        s, z = self.point(dims = dims, mnl = 0), self.point(dims = dims,
+            mnl = 0)
+        W2 = misc.compute_scaling(s, z, lmbda, dims, W = W)
+        self.assertFalse('dnl' in W2)
+        self.assertEqual(W2['r'][0].size, (2, 2))
+        self.assertSame(W2, self.py['compute_scaling'](s, z, matrix(0.0,
+            (m, 1)), dims))
+
+    def test_errors(self):
+        s, z = self.point(), self.point()
+        self.assertRaises(TypeError, misc.compute_scaling, s[:10], z,
+            matrix(0.0, (30, 1)), self.dims, self.mnl)
+        z[-1] = -1.0
+        self.assertRaises(ArithmeticError, misc.compute_scaling, s, z,
+            matrix(0.0, (30, 1)), self.dims, self.mnl)
+        self.assertRaises(KeyError, misc.update_scaling, {'d': matrix(1.0,
+            (1, 1))}, s, s, z)
+
+class TestKernels(unittest.TestCase):
+    # The C kernels against the Python versions, for blocks handled by the
+    # inline loops (order at most 4) and by BLAS calls.
+
+    def setUp(self):
+        setseed(2)
+        self.mnl = 1
+        self.dims = {'l': 2, 'q': [1, 2, 4, 5, 7], 's': [1, 2, 4, 5, 6]}
+        self.py = python_misc()
+        t = TestScaling('test_compute_scaling')
+        t.setUp()
+        t.mnl, t.dims = self.mnl, self.dims
+        self.point = t.point
+        m = self.mnl + self.dims['l'] + sum(self.dims['q'])
+        self.lmbda = matrix(0.0, (m + sum(self.dims['s']), 1))
+        self.W = misc.compute_scaling(self.point(), self.point(),
+            self.lmbda, self.dims, self.mnl)
+        self.lmbda[m:] = uniform(sum(self.dims['s']), 1, 0.5, 2.0)
+
+    def assertClose(self, x, y):
+        self.assertEqual(x.size, y.size)
+        self.assertTrue(max(abs(x - y)) <= 1e-12 * (1.0 + max(abs(y))))
+
+    def compare(self, name, x, *args, **kwargs):
+        x1, x2 = matrix(x), matrix(x)
+        getattr(misc, name)(x1, *args, **kwargs)
+        self.py[name](x2, *args, **kwargs)
+        self.assertClose(x1, x2)
+
+    def test_scale(self):
+        x = normal(len(self.point()), 3)
+        for trans in 'NT':
+            for inverse in 'NI':
+                self.compare('scale', x, self.W, trans = trans, inverse =
+                    inverse)
+
+    def test_scale2(self):
+        x = self.point()
+        for inverse in 'NI':
+            x1, x2 = matrix(x), matrix(x)
+            misc.scale2(self.lmbda, x1, self.dims, self.mnl, inverse)
+            self.py['scale2'](self.lmbda, x2, self.dims, self.mnl, inverse)
+            self.assertClose(x1, x2)
+
+    def test_sprod(self):
+        x, y = self.point(), self.point()
+        y1, y2 = matrix(y), matrix(y)
+        x1, x2 = matrix(x), matrix(x)
+        misc.sprod(x1, y1, self.dims, self.mnl)
+        self.py['sprod'](x2, y2, self.dims, self.mnl)
+        self.assertClose(x1, x2)
+        self.compare('sprod', x, self.lmbda, self.dims, self.mnl, 'D')
+        self.compare('sinv', x, self.lmbda, self.dims, self.mnl)
+
+    def test_trisc(self):
+        x = self.point()
+        self.compare('trisc', x, self.dims, self.mnl)
+
+    def test_workspace(self):
+        work = misc.workspace(self.dims)
+        self.assertTrue(self.py['workspace'](self.dims) is None)
+        x = normal(len(self.point()), 3)
+        for k in range(2):
+            x1, x2 = matrix(x), matrix(x)
+            misc.scale(x1, self.W, trans = 'T', work = work)
+            misc.scale(x2, self.W, trans = 'T')
+            self.assertEqual(list(x1), list(x2))
+            x = self.point() - 2.0
+            self.assertEqual(misc.max_step(x, self.dims, self.mnl, work =
+                work), misc.max_step(x, self.dims, self.mnl))
+
+        # The workspace is enlarged for larger blocks.
+        x = normal(100, 1)
+        dims = {'l': 0, 'q': [], 's': [10]}
+        self.assertEqual(misc.max_step(x, dims, work = work),
+            misc.max_step(x, dims))
+        self.assertRaises(TypeError, misc.max_step, x, dims, work = {})
+        self.assertRaises(TypeError, misc.scale, x, self.W, work = x)
+
+    def test_schur(self):
+        # Sparse columns with one or two nonzeros (summed over pairs of
+        # nonzeros) and a column with a dense 's' block (computed from
+        # V * F * V), against the dense product.
+        N, n = len(self.point()) - self.mnl, 5
+        G = matrix(0.0, (N, n))
+        ind = self.dims['l'] + sum(self.dims['q'])
+        for j in range(4):
+            G[ind + 25 + j % 5, j] = 1.0 + j
+            G[ind + 30 + 4*j, j] = -1.0
+        G[ind + 30 : ind + 55, 4] = normal(25, 1)
+        G[:ind, :] = normal(ind, n)
+        W = dict(self.W)
+        del W['dnl'], W['dnli']
+        H1, H2, H3 = [ matrix(0.0, (n, n)) for k in range(3) ]
+        misc.schur(sparse(G), W, H1, self.dims)
+        self.py['schur'](sparse(G), W, H2, self.dims)
+        Gs = matrix(G)
+        Gs[:ind, :] = 0.0
+        misc.scale(Gs, W, trans = 'T', inverse = 'I')
+        misc.pack2(Gs, self.dims)
+        blas.syrk(Gs, H3, trans = 'T', k = ind + sum([ m*(m+1)//2 for m in
+            self.dims['s'] ]))
+        for H in [H1, H2]:
+            for j in range(n):
+                self.assertClose(H[j:, j], H3[j:, j])
+        self.assertRaises(TypeError, misc.schur, Gs, W, H1, self.dims)
+
+        # conelp with a sparse G and the default KKT solver.
+        # The problem is strictly primal and dual feasible.
+        h, c = G * normal(n, 1) + self.point()[self.mnl:], matrix(0.0, (n,
+            1))
+        misc.sgemv(G, self.point()[self.mnl:], c, self.dims, trans = 'T',
+            alpha = -1.0)
+        opts = {'show_progress': False}
+        sol1 = solvers.conelp(c, sparse(G), h, self.dims, options = opts)
+        sol2 = solvers.conelp(c, G, h, self.dims, options = opts)
+        self.assertEqual(sol1['status'], sol2['status'])
+        self.assertTrue(abs(sol1['primal objective'] -
+            sol2['primal objective']) < 1e-6 * (1.0 +
+            abs(sol2['primal objective'])))
+
+if __name__ == '__main__':
+    unittest.main()
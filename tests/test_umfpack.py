@@ -0,0 +1,47 @@
+import unittest
+from cvxopt import matrix, spmatrix, normal, setseed
+
+class TestUmfpack(unittest.TestCase):
+
+    def setUp(self):
+        setseed(2)
+        n = 40
+        I = [ i % n for i in range(4*n) ]
+        J = [ (7*i + 3) % n for i in range(4*n) ]
+        self.A = spmatrix(normal(4*n,1), I, J, (n,n)) + \
+            spmatrix(10.0, range(n), range(n))
+        self.n = n
+
+    def test_solve_block(self):
+        from cvxopt import umfpack
+        A, n = self.A, self.n
+        F = umfpack.numeric(A, umfpack.symbolic(A))
+        B = normal(n+2, 5)
+        for trans, At in [('N', A), ('T', A.T)]:
+            for nthreads in [1, 2, 8]:
+                X = +B
+                umfpack.solve(A, F, X, trans = trans, nrhs = 5, ldB =
+                    n+2, offsetB = 1, nthreads = nthreads)
+                self.assertTrue(max(abs(At * X[1:n+1, :] - B[1:n+1, :]))
+                    < 1e-10 * max(abs(B)))
+                self.assertEqual(list(X[0, :]), list(B[0, :]))
+                self.assertEqual(list(X[n+1, :]), list(B[n+1, :]))
+        X = +B
+        umfpack.linsolve(A, X, nrhs = 5, ldB = n+2, offsetB = 1,
+            nthreads = 3)
+        self.assertTrue(max(abs(A * X[1:n+1, :] - B[1:n+1, :])) < 1e-10 *
+            max(abs(B)))
+        with self.assertRaises(ValueError):
+            umfpack.solve(A, F, X, nthreads = 0)
+
+    def test_solve_complex(self):
+        from cvxopt import umfpack
+        A, n = self.A + 1j * self.A.T, self.n
+        F = umfpack.numeric(A, umfpack.symbolic(A))
+        B = normal(n, 3) + 1j * normal(n, 3)
+        X = +B
+        umfpack.solve(A, F, X, trans = 'C', nthreads = 2)
+        self.assertTrue(max(abs(A.H * X - B)) < 1e-10 * max(abs(B)))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,68 @@
+import unittest
+from cvxopt import matrix, normal, uniform, setseed, solvers
+
+class TestWarmStart(unittest.TestCase):
+
+    def setUp(self):
+        self.options = {'show_progress': False}
+
+    def test_lp(self):
+        setseed(1)
+        m, n = 100, 40
+        A = normal(m,n)
+        b = A*uniform(n,1) + uniform(m,1)
+        c = -A.T*uniform(m,1)
+        sol = solvers.lp(c, A, b, options = self.options)
+        b2, c2 = b + 1e-3*normal(m,1), c + 1e-3*normal(n,1)
+        cold = solvers.lp(c2, A, b2, options = self.options)
+        warm = solvers.lp(c2, A, b2, warmstart = sol, options =
+            self.options)
+        self.assertEqual(warm['status'], 'optimal')
+        self.assertTrue(warm['iterations'] < cold['iterations'])
+        self.assertAlmostEqual(warm['primal objective'],
+            cold['primal objective'], places = 4)
+
+    def test_conelp(self):
+        c = matrix([-6., -4., -5.])
+        G = matrix([[ 16., 7.,  24.,  -8.,   8.,  -1.,  0., -1.,  0.,  0.,
+            7., -5.,   1.,  -5.,   1.,  -7.,   1.,   -7.,  -4.],
+            [-14., 2.,   7., -13., -18.,   3.,  0.,  0., -1.,  0.,   3.,
+            13.,  -6.,  13.,  12., -10.,  -6.,  -10., -28.],
+            [  5., 0., -15.,  12.,  -6.,  17.,  0.,  0.,  0., -1.,   9.,
+            6.,  -6.,   6.,  -7.,  -7.,  -6.,   -7., -11.]])
+        h = matrix( [ -3., 5.,  12.,  -2., -14., -13., 10.,  0.,  0.,  0.,
+            68., -30., -19., -30.,  99.,  23., -19.,   23.,  10.] )
+        dims = {'l': 2, 'q': [4, 4], 's': [3]}
+        sol = solvers.conelp(c, G, h, dims, options = self.options)
+        c2 = c + matrix([1e-3, -2e-3, 1e-3])
+        cold = solvers.conelp(c2, G, h, dims, options = self.options)
+        warm = solvers.conelp(c2, G, h, dims, warmstart = sol, options =
+            self.options)
+        self.assertEqual(warm['status'], 'optimal')
+        self.assertTrue(warm['iterations'] < cold['iterations'])
+        self.assertAlmostEqual(warm['primal objective'],
+            cold['primal objective'], places = 4)
+        with self.assertRaises(ValueError):
+            solvers.conelp(c, G[:18, :], h[:18], {'l': 1, 'q': [4, 4],
+                's': [3]}, warmstart = sol, options = self.options)
+
+    def test_qp(self):
+        setseed(2)
+        m, n = 60, 20
+        P = normal(n,n)
+        P = P*P.T
+        q = normal(n,1)
+        G = normal(m,n)
+        h = G*uniform(n,1) + uniform(m,1)
+        sol = solvers.qp(P, q, G, h, options = self.options)
+        q2 = q + 1e-3*normal(n,1)
+        cold = solvers.qp(P, q2, G, h, options = self.options)
+        warm = solvers.qp(P, q2, G, h, warmstart = sol, options =
+            self.options)
+        self.assertEqual(warm['status'], 'optimal')
+        self.assertTrue(warm['iterations'] < cold['iterations'])
+        self.assertAlmostEqual(warm['primal objective'],
+            cold['primal objective'], places = 4)
+
+if __name__ == '__main__':
+    unittest.main()